@@ -59,28 +59,43 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
+#include <esp_attr.h>
+#include <esp_system.h>
 // Preferences worden nu beheerd door SettingsStore module
 #include <MAX6675.h>
 #include "src/SystemClock/SystemClock.h"
 #include "src/SettingsStore/SettingsStore.h"
 #include "src/TempSensor/TempSensor.h"
+#include "src/TempSensorArray/TempSensorArray.h"
+#include "src/SampleHistory/SampleHistory.h"
 #include "src/Logger/Logger.h"
 #include "src/CycleController/CycleController.h"
+#include "src/CycleController/CycleCheckpoint.h"
 #include "src/UIController/UIController.h"
 #include "src/NtfyNotifier/NtfyNotifier.h"
+#include "src/SafetySupervisor/SafetySupervisor.h"
 // Include WebServer.h moet NA andere includes om naamconflict te voorkomen
 #include "src/WebServer/WebServer.h"
-/* --- Rob Tillaart MAX6675 (software SPI) ---
+#if THERMAL_SIM_MODE
+#include "src/ThermalSim/ThermalSim.h"
+#endif
+/* --- Rob Tillaart MAX6675 (software SPI, standaard transport van TempSensor) ---
    Constructor order (since v0.2.0): MAX6675(select, miso, clock)
    Our pins: CS=21, SO(MISO)=35, SCK=22
 */
 #define MAX6675_CS   22  // 2e stekker GND-[22]-27-3.3V
 #define MAX6675_SO   35  // 1e stekker GND-[35]-22-21
 #define MAX6675_SCK  27  // 2e stekker GND-22-[27]-3.3V - 21 bij 2.4 inch, 27 bij 2.8 inch
+// Extra thermokoppels (alleen bij TEMP_SENSOR_ARRAY_MODE): delen SO en SCK, eigen CS.
+// CYD: 18/19 zijn SCK/MISO van het SD slot (SD niet in gebruik, de relais zitten al op SD CS 5 en MOSI 23).
+// Niet 1/3 (UART0 TX/RX: Serial), 0/2/12/15 (strapping), 4/16/17 (RGB LED) of de TFT/touch pinnen.
+#define MAX6675_CS_2 18  // CS tweede thermokoppel
+#define MAX6675_CS_3 19  // CS derde thermokoppel (alleen bij TEMP_SENSOR_ARRAY_MODE 3)
 
 // Relais pins (Solid State Relais - alleen NO contact)
 #define RELAIS_KOELEN 5      // SSR voor koeling (HIGH = koelen aan, LOW = uit)
 #define RELAIS_VERWARMING 23 // SSR voor verwarming (HIGH = verwarming aan, LOW = uit)
+#define RELAIS_DEAD_TIME_MS 20 // Wachttijd tussen verwarmen en koelen (SSR schakelt uit bij de nuldoorgang)
 
 // Versienummer - VERHOOG BIJ ELKE WIJZIGING
 #define FIRMWARE_VERSION_MAJOR 4
@@ -94,16 +109,39 @@
 #define TEMP_SAMPLE_INTERVAL_MS 285     // Temperatuur sampling interval (285ms)
 #define TEMP_DISPLAY_UPDATE_MS 285      // Temperatuur display update interval (285ms - synchroon met sampling)
 #define TEMP_GRAPH_LOG_INTERVAL_MS 5000 // Grafiek data logging interval (5 seconden)
+#define TEMP_SENSOR_TASK_MODE 0         // 1 = TempSensor in eigen FreeRTOS task (vaste periode, los van loop())
+#define TEMP_SENSOR_ARRAY_MODE 0        // Aantal thermokoppels via TempSensorArray: 0 = uit, 2 = regelen op MAX, 3 = 2-of-3 stemming
+#define TEMP_ADAPTIVE_SAMPLING 0        // 1 = sample rate volgt afstand tot T_top/T_bottom (250ms dichtbij, 1s ver weg)
+#define TEMP_PREDICTIVE_CUTOFF 0        // 1 = verwarming eerder uit zodat de piek op T_top uitkomt (geleerde naloop)
+#define SAFETY_SUPERVISOR 1             // 1 = onafhankelijke bewaking in eigen task: max temperatuur, aan-tijd verwarming, sensor weg
+#define CYCLE_WARM_RESTART 1            // 1 = na brownout/watchdog/panic reset de cyclus hervatten uit RTC geheugen (CycleCheckpoint)
+
+#if TEMP_SENSOR_ARRAY_MODE
+// Chip selects van de extra thermokoppels: UART0 (Serial) en de pinnen van sensor 1/relais zijn bezet
+#if MAX6675_CS_2 == 1 || MAX6675_CS_2 == 3 || (TEMP_SENSOR_ARRAY_MODE >= 3 && (MAX6675_CS_3 == 1 || MAX6675_CS_3 == 3))
+#error "MAX6675_CS_2/MAX6675_CS_3 op GPIO1/GPIO3 (UART0 TX/RX): kies een vrije pin"
+#endif
+#if MAX6675_CS_2 == MAX6675_CS || MAX6675_CS_2 == MAX6675_SO || MAX6675_CS_2 == MAX6675_SCK || \
+    MAX6675_CS_2 == RELAIS_KOELEN || MAX6675_CS_2 == RELAIS_VERWARMING
+#error "MAX6675_CS_2 valt samen met een andere sensor- of relais pin"
+#endif
+#if TEMP_SENSOR_ARRAY_MODE >= 3 && (MAX6675_CS_3 == MAX6675_CS || MAX6675_CS_3 == MAX6675_SO || \
+    MAX6675_CS_3 == MAX6675_SCK || MAX6675_CS_3 == MAX6675_CS_2 || MAX6675_CS_3 == RELAIS_KOELEN || \
+    MAX6675_CS_3 == RELAIS_VERWARMING)
+#error "MAX6675_CS_3 valt samen met een andere sensor- of relais pin"
+#endif
+#endif
 
 // Timing constanten
 #define MAX6675_POWERUP_DELAY_MS 500      // MAX6675 opstart vertraging
 #define MAX6675_CONVERSION_TIME_MS 250    // MAX6675 conversietijd (220ms typisch + marge)
 #define MAX6675_WARMUP_TIME_MS 1000       // MAX6675 warm-up tijd na power-up
-#define MAX6675_SW_SPI_DELAY_US 1         // Software SPI delay voor stabiliteit (microseconden)
-#define MAX6675_READ_RETRIES 3            // Aantal retries bij communicatiefouten
-#define MAX6675_RETRY_DELAY_MS 10         // Delay tussen retries (milliseconden)
-#define MAX6675_CRITICAL_SAMPLES 3        // Aantal samples voor majority voting bij kritieke metingen (verlaagd voor snelheid)
-#define MAX6675_CRITICAL_SAMPLE_DELAY_MS 30 // Delay tussen samples bij majority voting (milliseconden, verlaagd voor snelheid)
+#define MAX6675_SW_SPI_DELAY_US 1         // Software SPI delay voor stabiliteit (microseconden, zie Max6675Transport.h)
+#define MAX6675_HW_SPI 0                  // 1 = hardware SPI transport (alleen als SCK/SO op een vrije SPI bus passen)
+#define THERMAL_SIM_MODE 0                // 1 = thermokoppel en relais vervangen door ThermalSim model (SSR pinnen blijven laag)
+#define THERMAL_SIM_REPORT_MS (10UL * 60 * 1000) // Interval simulatie rapport op Serial
+#define MAX6675_READ_RETRIES 3            // Aantal snelle retries (na conversietijd) bij communicatiefouten
+#define MAX6675_CRITICAL_SAMPLES 3        // Aantal laatste samples voor mediaan bij kritieke metingen
 
 // GUI update intervals
 #define GUI_UPDATE_INTERVAL_MS 300       // GUI update interval (0.3 seconde)
@@ -113,14 +151,38 @@
 #define LOG_QUEUE_WARN_THRESHOLD 2       // Waarschuwing bij queue bijna vol (LOG_QUEUE_SIZE - 2)
 #define LOG_QUEUE_CLEANUP_COUNT 5        // Aantal entries om te verwijderen bij overflow
 
-MAX6675 thermocouple(MAX6675_CS, MAX6675_SO, MAX6675_SCK);
+#if MAX6675_HW_SPI
+// Let op: op de CYD gebruikt de TFT HSPI en de touchscreen VSPI - alleen inschakelen op een board met vrije bus
+SPIClass max6675SPI(HSPI);
+Max6675HardwareSpiTransport max6675HwTransport(&max6675SPI, MAX6675_CS);
+#endif
+#if THERMAL_SIM_MODE
+// Model i.p.v. oven: de relais sturen alleen het model (geheugen bank), de sensor leest het model.
+// Versneld testen gebeurt op de host: test/host/ThermalSimRunner.
+ThermalSim thermalSim;
+Max6675SimTransport thermalSimTransport(&thermalSim);
+MockGpioBank thermalSimGpio;
+#endif
 
 // Module instanties
 SystemClock systemClock;
 SettingsStore settingsStore;
 TempSensor tempSensor(MAX6675_CS, MAX6675_SO, MAX6675_SCK);
+#if TEMP_SENSOR_ARRAY_MODE
+TempSensor tempSensor2(MAX6675_CS_2, MAX6675_SO, MAX6675_SCK);
+#if TEMP_SENSOR_ARRAY_MODE >= 3
+TempSensor tempSensor3(MAX6675_CS_3, MAX6675_SO, MAX6675_SCK);
+#endif
+TempSensorArray tempSensorArray;
+#endif
 Logger logger;
 CycleController cycleController;
+// Fase toestand van de cyclus, overleeft een reset (niet het wegvallen van de voeding)
+RTC_NOINIT_ATTR CycleCheckpoint rtcCheckpoint;
+#if SAFETY_SUPERVISOR
+SafetySupervisor safetySupervisor;  // Eigen task: zet de SSR's laag, ook als loop() blokkeert
+#endif
+SampleHistory sampleHistory;  // Volledige ruwe sample stroom (PSRAM indien aanwezig, export via /history.csv)
 UIController uiController;
 NtfyNotifier ntfyNotifier;
 ConfigWebServer webServer(80);
@@ -134,49 +196,8 @@ static unsigned long g_lastMax6675ReadTime = 0;
 // VERPLAATST NAAR TempSensor module - functie verwijderd, gebruik tempSensor.getCurrent() of tempSensor.getMedian()
 // readTempC_single() wordt niet meer gebruikt - alle aanroepen zijn vervangen
 
-// Mediaan berekening constanten
-#define TEMP_MEDIAN_SAMPLES 7              // Aantal metingen voor mediaan (7 waarden)
-
-// Bereken mediaan uit array van temperatuurmetingen
-// Ondersteunt zowel 3 samples (readTempC_critical) als 7 samples (circulaire array)
-static float calculateMedianFromArray(float* samples, int count) {
-  if (count == 0 || samples == nullptr) return NAN;
-  
-  // Limiteer count om stack overflow te voorkomen (max 7 voor circulaire array)
-  if (count > TEMP_MEDIAN_SAMPLES) {
-    count = TEMP_MEDIAN_SAMPLES;
-  }
-  
-  // Maak kopie van array voor sorteren
-  float sorted[TEMP_MEDIAN_SAMPLES];
-  int valid_count = 0;
-  for (int i = 0; i < count; i++) {
-    if (!isnan(samples[i])) {
-      sorted[valid_count++] = samples[i];
-    }
-  }
-  
-  if (valid_count == 0) return NAN;
-  if (valid_count == 1) return sorted[0];
-  
-  // Insertion sort (efficiënt voor kleine arrays ≤7)
-  for (int i = 1; i < valid_count; i++) {
-    float key = sorted[i];
-    int j = i - 1;
-    while (j >= 0 && sorted[j] > key) {
-      sorted[j + 1] = sorted[j];
-      j--;
-    }
-    sorted[j + 1] = key;
-  }
-  
-  // Mediaan is middelste waarde (of gemiddelde van twee middelste bij even aantal)
-  if (valid_count % 2 == 1) {
-    return sorted[valid_count / 2];
-  } else {
-    return (sorted[valid_count / 2 - 1] + sorted[valid_count / 2]) / 2.0;
-  }
-}
+// VERPLAATST NAAR TempSensor module - calculateMedianFromArray() verwijderd
+// Filtering gebeurt nu in de compile-time filter keten (zie src/TempSensor/TempFilterChain.h)
 
 // VERPLAATST NAAR TempSensor module - functie verwijderd, gebruik tempSensor.getCurrent() of tempSensor.getMedian()
 // readTempC() wordt niet meer gebruikt - alle aanroepen zijn vervangen door tempSensor.sample()
@@ -191,16 +212,12 @@ static unsigned long g_lastDisplayMs = 0;  // Timer voor temperatuur weergave
 static float g_avgTempC = NAN;             // Mediaan temperatuur (voor display en logging)
 static float g_lastValidTempC = NAN;       // Laatste geldige temperatuurwaarde (voor display bij fouten)
 
-// Mediaan berekening: circulaire array voor laatste 7 metingen
-static float g_tempSamples[TEMP_MEDIAN_SAMPLES]; // Circulaire array voor temperatuurmetingen
-static int g_tempSampleIndex = 0;         // Huidige index in circulaire array
-static int g_tempSampleCount = 0;          // Aantal geldige metingen in buffer (0-7)
-
 // Cyclus en temperatuur instellingen
 float T_top = 80.0;        // Bovenste temperatuur voor verwarmen (default, wordt geladen uit Preferences)
 float T_bottom = 25.0;     // Onderste temperatuur voor koelen (default, wordt geladen uit Preferences)
 int cyclus_teller = 1;     // Huidige cyclus (start bij 1)
 int cyclus_max = 0;        // Maximaal aantal cycli (0 = oneindig) (default, wordt geladen uit Preferences)
+int active_profile_slot = -1; // Gekozen ramp/soak profiel (-1 = geen: T_top/T_bottom/cyclus_max)
 
 // Preferences worden nu beheerd door SettingsStore module
 bool cyclus_actief = false; // Of er een cyclus draait
@@ -279,10 +296,14 @@ void loadSettings() {
   T_bottom = settings.tBottom;
   cyclus_max = settings.cycleMax;
   temp_offset = settings.tempOffset;
-  // Pas offset toe op MAX6675 library (oude instantie)
-  thermocouple.setOffset(temp_offset);
   // Pas offset toe op TempSensor module
   tempSensor.setOffset(temp_offset);
+#if TEMP_SENSOR_ARRAY_MODE
+  tempSensor2.setOffset(temp_offset);
+#if TEMP_SENSOR_ARRAY_MODE >= 3
+  tempSensor3.setOffset(temp_offset);
+#endif
+#endif
   
   // Update CycleController settings (als al geïnitialiseerd)
   if (cycleController.isActive() || true) { // Altijd updaten (CycleController kan al geïnitialiseerd zijn)
@@ -292,6 +313,20 @@ void loadSettings() {
   }
 }
 
+// Ramp/soak profiel kiezen (-1 of leeg slot = geen profiel). false als er nog een profiel loopt.
+static bool selectProfile(int slot) {
+  CycleProfile profile;
+  if (slot >= 0 && settingsStore.loadProfile(slot, profile)) {
+    if (!cycleController.setProfile(profile)) return false;
+  } else {
+    if (!cycleController.clearProfile()) return false;
+    slot = -1;
+  }
+  active_profile_slot = slot;
+  settingsStore.saveActiveProfile(slot);
+  return true;
+}
+
 void saveSettings() {
   Settings settings;
   settings.tTop = T_top;
@@ -441,46 +476,37 @@ static void sampleMax6675()
 // UIT: 5 laag, 23 laag
 // KOELEN: 5 hoog, 23 laag
 // VERWARMEN: 5 laag, 23 hoog
+// Via de RelayActuator van CycleController: één register write per schakelmoment, dead-time tussen
+// verwarmen en koelen (de tegengestelde stand volgt bij cycleController.update())
 void systeemAan() {
   // Systeem aan - beide relais laag (systeem gereed, maar nog niet actief)
   // De keuze tussen verwarmen/koelen wordt direct daarna gemaakt
-  digitalWrite(RELAIS_KOELEN, LOW);
-  digitalWrite(RELAIS_VERWARMING, LOW);
+  cycleController.getRelays().set(RelayMode::OFF);
   systeem_uit = false;
 }
 
 void verwarmenAan() {
-  // Feed watchdog voor en na digitalWrite om crashes te voorkomen
-  yield();
   // VERWARMEN: 5 laag, 23 hoog
-  digitalWrite(RELAIS_KOELEN, LOW);
-  digitalWrite(RELAIS_VERWARMING, HIGH);
-  yield();
+  cycleController.getRelays().set(RelayMode::HEAT);
   verwarmen_actief = true;
 }
 
 void koelenAan() {
-  // Feed watchdog voor en na digitalWrite om crashes te voorkomen
-  yield();
   // KOELEN: 5 hoog, 23 laag
-  digitalWrite(RELAIS_KOELEN, HIGH);
-  digitalWrite(RELAIS_VERWARMING, LOW);
-  yield();
+  cycleController.getRelays().set(RelayMode::COOL);
   verwarmen_actief = false;
 }
 
 void alleRelaisUit() {
   // UIT: 5 laag, 23 laag
-  digitalWrite(RELAIS_KOELEN, LOW);
-  digitalWrite(RELAIS_VERWARMING, LOW);
+  cycleController.getRelays().set(RelayMode::OFF);
   systeem_uit = true;
   cyclus_actief = false;
 }
 
 void systeemGereed() {
   // Systeem gereed - beide relais laag (nog niet actief)
-  digitalWrite(RELAIS_KOELEN, LOW);
-  digitalWrite(RELAIS_VERWARMING, LOW);
+  cycleController.getRelays().set(RelayMode::OFF);
   systeem_uit = false;  // Systeem is gereed, niet uitgeschakeld
   cyclus_actief = false;
 }
@@ -494,6 +520,22 @@ void formatTijdChar(unsigned long milliseconden, char* buffer, size_t buffer_siz
 }
 
 // Helper functie om fase tijd te resetten naar "0:00"
+#if TEMP_SENSOR_ARRAY_MODE
+// Aangeroepen vanuit de regeling (loop()) bij nieuwe onenigheid of uitval van een thermokoppel
+static void onSensorDisagreement(int channel, float channelTemp, float consensusTemp) {
+  char status[50];
+  if (channel >= 0 && isnan(channelTemp)) {
+    snprintf(status, sizeof(status), "Sensor K%d uitgevallen, regelt op %.1f", channel + 1, consensusTemp);
+  } else if (channel >= 0) {
+    snprintf(status, sizeof(status), "Sensor onenigheid K%d: %.1f vs %.1f", channel + 1, channelTemp, consensusTemp);
+  } else {
+    snprintf(status, sizeof(status), "Sensor geen meerderheid, max %.1f", consensusTemp);
+  }
+  Serial.println(status);
+  logToGoogleSheet(status);
+}
+#endif
+
 static void resetFaseTijd(char* buffer, size_t buffer_size) {
   strncpy(buffer, "0:00", buffer_size - 1);
   buffer[buffer_size - 1] = '\0';
@@ -501,14 +543,14 @@ static void resetFaseTijd(char* buffer, size_t buffer_size) {
 
 // Helper functie voor Google Sheets timestamp (char array versie)
 // VERPLAATST NAAR SystemClock module
-// Functies worden vervangen door systemClock.getTimestamp() en systemClock.getTimestampFromMillis()
+// Functies worden vervangen door systemClock.getTimestamp() en systemClock.getTimestampFromMono()
 // Oude functies blijven tijdelijk voor backward compatibility tijdens refactoring
 void getTimestampChar(char* buffer, size_t buffer_size) {
   systemClock.getTimestamp(buffer, buffer_size);
 }
 
 void getTimestampFromMillisChar(unsigned long timestamp_ms, char* buffer, size_t buffer_size) {
-  systemClock.getTimestampFromMillis(timestamp_ms, buffer, buffer_size);
+  systemClock.getTimestampFromMono(monoNowUs() - (MonoUs)(millis() - timestamp_ms) * MONO_US_PER_MS, buffer, buffer_size);
 }
 
 // VERPLAATST NAAR Logger module - functie verwijderd, Logger::task() wordt nu gebruikt
@@ -642,7 +684,8 @@ void logToGoogleSheet(const char* status) {
   req.fase_tijd[LOG_FASE_TIJD_MAX_LEN - 1] = '\0'; // Null-terminate
   strncpy(req.cyclus_tijd, cyclus_tijd_str, LOG_CYCLUS_TIJD_MAX_LEN - 1);
   req.cyclus_tijd[LOG_CYCLUS_TIJD_MAX_LEN - 1] = '\0'; // Null-terminate
-  req.timestamp_ms = log_timestamp_ms; // Sla timestamp op voor gebruik in logToGoogleSheet_internal
+  // Legacy tijden zijn millis(): omrekenen naar de monotone tijdsbasis (verschil is wrap-veilig)
+  req.timestamp_us = monoNowUs() - (MonoUs)(millis() - log_timestamp_ms) * MONO_US_PER_MS;
   
   // VERPLAATST NAAR Logger module - gebruik logger.log() in plaats van direct naar queue
   logger.log(req);
@@ -1991,21 +2034,46 @@ void temp_minus_event(lv_event_t * e) {
   }
 }
 
+// ---- Profiel keuze: volgend opgeslagen profiel, na het laatste weer geen profiel ----
+void profile_select_event(lv_event_t * e) {
+  lv_event_code_t code = lv_event_get_code(e);
+  if(code == LV_EVENT_PRESSED) {
+    uiController.onProfileButton();
+  }
+}
+
 void setup() {
   SPI.begin();
-  thermocouple.begin(); // Oude instantie - wordt vervangen door tempSensor
+#if MAX6675_HW_SPI
+  max6675SPI.begin(MAX6675_SCK, MAX6675_SO, -1, -1);
+  tempSensor.setTransport(&max6675HwTransport);
+#endif
+#if THERMAL_SIM_MODE
+  tempSensor.setTransport(&thermalSimTransport);
+#endif
+  // Software SPI delay (stabiliteit bij hoge CPU belasting) wordt door het bit-bang transport ingesteld
   tempSensor.begin();
   
-  // BELANGRIJK: Stel software SPI delay in voor betere communicatie stabiliteit
-  // Dit voorkomt timing problemen bij hoge CPU belasting
-  thermocouple.setSWSPIdelay(MAX6675_SW_SPI_DELAY_US);
-  
   // BELANGRIJK: Gebruik char array i.p.v. String om heap fragmentatie te voorkomen
   char lvgl_version[64];
   snprintf(lvgl_version, sizeof(lvgl_version), "LVGL Library Version: %d.%d.%d", 
            lv_version_major(), lv_version_minor(), lv_version_patch());
   Serial.begin(115200);
   
+  // Warme herstart: alleen na een onverwachte reset met een geldig checkpoint in RTC geheugen.
+  // Bij power-on, upload of handmatige reset start het systeem gewoon in UIT.
+  bool warm_restart = false;
+#if CYCLE_WARM_RESTART
+  esp_reset_reason_t reset_reason = esp_reset_reason();
+  bool unexpected_reset = (reset_reason == ESP_RST_BROWNOUT || reset_reason == ESP_RST_PANIC ||
+                           reset_reason == ESP_RST_INT_WDT || reset_reason == ESP_RST_TASK_WDT ||
+                           reset_reason == ESP_RST_WDT);
+  warm_restart = unexpected_reset && isValidCycleCheckpoint(rtcCheckpoint);
+#endif
+  if (!warm_restart) {
+    invalidateCycleCheckpoint(rtcCheckpoint);
+  }
+  
   // Laad opgeslagen instellingen uit non-volatile memory
   // Initialiseer SettingsStore
   settingsStore.begin();
@@ -2015,16 +2083,43 @@ void setup() {
   int saved_cyclus_teller = settingsStore.loadCycleCount();
   
   // Initialiseer CycleController (na loadSettings zodat settings beschikbaar zijn)
+  // begin() zet de relais pinnen als uitgang (laag) via de RelayActuator
+  cycleController.getRelays().setDeadTimeMs(RELAIS_DEAD_TIME_MS);
+#if THERMAL_SIM_MODE
+  // Echte SSR pinnen laag houden, het model leest de geheugen bank
+  pinMode(RELAIS_KOELEN, OUTPUT);
+  pinMode(RELAIS_VERWARMING, OUTPUT);
+  digitalWrite(RELAIS_KOELEN, LOW);
+  digitalWrite(RELAIS_VERWARMING, LOW);
+  cycleController.getRelays().setGpioBank(&thermalSimGpio);
+#endif
   cycleController.begin(&tempSensor, &logger, RELAIS_KOELEN, RELAIS_VERWARMING);
   cycleController.setTargetTop(T_top);
   cycleController.setTargetBottom(T_bottom);
   cycleController.setMaxCycles(cyclus_max);
   cycleController.setCycleCount(saved_cyclus_teller); // Herstel cyclus_teller na reboot
+#if TEMP_PREDICTIVE_CUTOFF
+  // Gebruikt tempSensor.getRate(): de alpha-beta schatter staat hieronder aan
+  cycleController.setPredictiveCutoff(true);
+#endif
+  // PID modus + tuning per opstelling (aan/uit en waarden via /pid)
+  cycleController.setPidTuning(settingsStore.loadPidTuning());
+  // Gekozen ramp/soak profiel (profielen via /profiles en /profile, kiezen ook met de [>] knop)
+  selectProfile(settingsStore.loadActiveProfile());
+  // Autotune model (naloop voorspellende uitschakeling); na een nieuwe autotune model + PID opslaan
+  cycleController.setPlantModel(settingsStore.loadPlantModel());
+  cycleController.setAutoTuneCallback([](const PlantModel& model, const PidTuning& tuning) {
+    settingsStore.savePlantModel(model);
+    settingsStore.savePidTuning(tuning);
+  });
   
   // Stel callback in voor logging (CycleController gebruikt logTransition() intern)
-  cycleController.setTransitionCallback([](const char* status, float temp, unsigned long timestamp) {
+  cycleController.setTransitionCallback([](const char* status, float temp, MonoUs timestamp) {
     // CycleController handelt logging zelf af via logTransition()
     // Deze callback kan gebruikt worden voor extra acties indien nodig
+#if THERMAL_SIM_MODE
+    thermalSim.onTransition(status);
+#endif
   });
   
   // Stel callback in voor cyclus_teller opslag (voor persistentie bij reboot)
@@ -2032,27 +2127,87 @@ void setup() {
     settingsStore.saveCycleCount(cycleCount);
   });
 
-  // Initialize GPIO pins for relais
-  pinMode(RELAIS_KOELEN, OUTPUT);
-  pinMode(RELAIS_VERWARMING, OUTPUT);
-  
   // Start with all relais off but system ready
   systeemGereed();
 
   // BELANGRIJK: MAX6675 warm-up tijd - wacht tot sensor gestabiliseerd is
-  delay(MAX6675_POWERUP_DELAY_MS);
-  delay(MAX6675_WARMUP_TIME_MS);
-  
-  // BELANGRIJK: Discard eerste paar metingen voor stabiliteit
-  // Eerste metingen na power-up kunnen onnauwkeurig zijn
-  for (int i = 0; i < 3; i++) {
-    (void)tempSensor.read(); // Warm-up reads - gebruik private read() via friend of direct via public API
-    delay(MAX6675_CONVERSION_TIME_MS); // Wacht conversietijd tussen reads
+  // Warme herstart: de MAX6675 is niet uitgeschakeld geweest, warm-up en discard reads overslaan
+  if (!warm_restart) {
+    delay(MAX6675_POWERUP_DELAY_MS);
+    delay(MAX6675_WARMUP_TIME_MS);
+    
+    // BELANGRIJK: Discard eerste paar metingen voor stabiliteit
+    // Eerste metingen na power-up kunnen onnauwkeurig zijn
+    for (int i = 0; i < 3; i++) {
+      (void)tempSensor.read(); // Warm-up reads - gebruik private read() via friend of direct via public API
+      delay(MAX6675_CONVERSION_TIME_MS); // Wacht conversietijd tussen reads
+    }
   }
   
   // Reset conversietijd timer na warm-up
   g_lastMax6675ReadTime = 0;
   
+  // Ruwe sample history (na warm-up, zodat de opstart reads er niet in staan)
+  if (sampleHistory.begin()) {
+    tempSensor.setSampleHistory(&sampleHistory);
+  } else {
+    Serial.println("WAARSCHUWING: Geen geheugen voor sample history");
+  }
+  
+  // Alpha-beta schatter voor temperatuur + stijgsnelheid (tempSensor.getRate())
+  tempSensor.setEstimatorEnabled(true);
+#if TEMP_ADAPTIVE_SAMPLING && !TEMP_SENSOR_ARRAY_MODE
+  // Drempels worden door CycleController doorgegeven (begin() / setTargetTop() / setTargetBottom())
+  tempSensor.setAdaptiveSampling(true);
+#endif
+  
+#if TEMP_SENSOR_ARRAY_MODE
+  // Tweede thermokoppel: kanalen worden om de beurt gelezen (één CS laag per slot)
+  tempSensor2.begin();
+  tempSensor2.setOffset(temp_offset);
+  tempSensor2.setEstimatorEnabled(true);
+  tempSensorArray.addChannel(&tempSensor);
+  tempSensorArray.addChannel(&tempSensor2);
+#if TEMP_SENSOR_ARRAY_MODE >= 3
+  // Derde thermokoppel: regelen op de meerderheid, een afwijkend kanaal wordt overstemd en gelogd
+  tempSensor3.begin();
+  tempSensor3.setOffset(temp_offset);
+  tempSensor3.setEstimatorEnabled(true);
+  tempSensorArray.addChannel(&tempSensor3);
+  tempSensorArray.setDisagreementCallback(onSensorDisagreement);
+  tempSensorArray.begin();
+  cycleController.setSensorArray(&tempSensorArray, TempControlSource::VOTE);
+#else
+  tempSensorArray.setDisagreementCallback(onSensorDisagreement);  // Alleen uitval: MAX stemt niet
+  tempSensorArray.begin();
+  cycleController.setSensorArray(&tempSensorArray, TempControlSource::MAX);
+#endif
+#elif TEMP_SENSOR_TASK_MODE
+  // Sensor sampling in eigen task op Core 0 - tempSensor.sample() in loop() wordt dan een no-op
+  if (!tempSensor.startTask(TEMP_SAMPLE_INTERVAL_MS)) {
+    Serial.println("WAARSCHUWING: TempSensor task niet gestart, sampling via loop()");
+  }
+#endif
+  
+#if SAFETY_SUPERVISOR
+  // Harde grenzen los van loop(): alle thermokoppels, hoogste temperatuur telt
+  safetySupervisor.addSensor(&tempSensor);
+#if TEMP_SENSOR_ARRAY_MODE
+  safetySupervisor.addSensor(&tempSensor2);
+#if TEMP_SENSOR_ARRAY_MODE >= 3
+  safetySupervisor.addSensor(&tempSensor3);
+#endif
+#endif
+  {
+    SafetyLimits limits;
+    limits.maxTempC = TEMP_MAX + 25.0;
+    if (!safetySupervisor.begin(&cycleController.getRelays(), limits)) {
+      Serial.println("WAARSCHUWING: SafetySupervisor task niet gestart");
+    }
+  }
+  cycleController.setSafetySupervisor(&safetySupervisor);
+#endif
+  
   // Initialiseer UIController (alloceert buffers en initialiseert grafiek data)
   if (!uiController.begin(FIRMWARE_VERSION_MAJOR, FIRMWARE_VERSION_MINOR)) {
     Serial.println("KRITIEKE FOUT: Kan UIController niet initialiseren!");
@@ -2104,17 +2259,17 @@ void setup() {
   
   uiController.setGraphResetCallback([]() {
     // Reset grafiek data bij START
-    float* graph_temps = uiController.getGraphTemps();
-    unsigned long* graph_times = uiController.getGraphTimes();
+    TempQ* graph_temps = uiController.getGraphTemps();
+    MonoUs* graph_times = uiController.getGraphTimes();
     if (graph_temps != nullptr && graph_times != nullptr) {
       for (int i = 0; i < 120; i++) {
-        graph_temps[i] = NAN;
-        graph_times[i] = 0;
+        graph_temps[i] = TEMP_Q_INVALID;
+        graph_times[i] = MONO_US_UNSET;
       }
       uiController.setGraphWriteIndex(0);
       uiController.setGraphCount(0);
       uiController.setGraphDataReady(false);
-      uiController.setGraphLastLogTime(0);
+      uiController.setGraphLastLogTime(MONO_US_UNSET);
       uiController.setGraphForceRebuild(false);
     }
   });
@@ -2141,9 +2296,15 @@ void setup() {
       if (temp_offset < -10.0) temp_offset = -10.0;
       if (temp_offset > 10.0) temp_offset = 10.0;
       char log_msg[32];
-      snprintf(log_msg, sizeof(log_msg), value > 0 ? "Offset+%.1f" : "Offset-%.1f", temp_offset);
+      snprintf(log_msg, sizeof(log_msg), value > 0 ? "Offset+%.2f" : "Offset-%.2f", temp_offset);
       saveAndLogSetting(log_msg);
       tempSensor.setOffset(temp_offset);
+#if TEMP_SENSOR_ARRAY_MODE
+      tempSensor2.setOffset(temp_offset);
+#if TEMP_SENSOR_ARRAY_MODE >= 3
+      tempSensor3.setOffset(temp_offset);
+#endif
+#endif
     }
   });
   
@@ -2160,6 +2321,20 @@ void setup() {
   uiController.setTtopCallback([]() { return T_top; });
   uiController.setTbottomCallback([]() { return T_bottom; });
   uiController.setCyclusMaxCallback([]() { return cyclus_max; });
+  uiController.setProfileSelectCallback([]() {
+    CycleProfile profile;
+    int slot = active_profile_slot + 1;
+    while (slot < PROFILE_SLOTS && !settingsStore.loadProfile(slot, profile)) slot++;
+    if (selectProfile(slot < PROFILE_SLOTS ? slot : -1)) {
+      char log_msg[40];
+      snprintf(log_msg, sizeof(log_msg), "Profiel: %s",
+               cycleController.hasProfile() ? cycleController.getProfile().name : "geen");
+      logToGoogleSheet(log_msg);
+    }
+  });
+  uiController.setProfileNameCallback([]() -> const char* {
+    return cycleController.hasProfile() ? cycleController.getProfile().name : nullptr;
+  });
   
   // Zet alle knoppen grijs tijdens initialisatie
   uiController.setButtonsGray();
@@ -2174,6 +2349,10 @@ void setup() {
   // WiFiManager voor WiFi Station configuratie
   WiFiManager wm;
   wm.setConfigPortalTimeout(180); // Timeout na 3 minuten
+  if (warm_restart) {
+    // Geen config portal van 3 minuten terwijl de oven in een cyclus zit: zonder WiFi verder
+    wm.setEnableConfigPortal(false);
+  }
   
   // Callback voor wanneer config portal (AP) wordt gestart
   wm.setAPCallback([](WiFiManager *myWiFiManager) {
@@ -2293,6 +2472,10 @@ void setup() {
     webServer.setSettingsStore(&settingsStore);
     webServer.setCycleController(&cycleController);
     webServer.setTempSensor(&tempSensor);
+#if SAFETY_SUPERVISOR
+    webServer.setSafetySupervisor(&safetySupervisor);
+#endif
+    webServer.setSampleHistory(&sampleHistory);
     webServer.setUIController(&uiController);
     
     // Stel callbacks in voor acties
@@ -2306,6 +2489,10 @@ void setup() {
       cycleController.stop();
     });
     
+    webServer.setStartAutoTuneCallback([](float setpointC) {
+      return cycleController.startAutoTune(setpointC);
+    });
+    
     // Settings change callback
     webServer.setSettingsChangeCallback([](float tTop, float tBottom, float tempOffset, int cycleMax,
                                             const char* clientEmail, const char* projectId,
@@ -2361,6 +2548,12 @@ void setup() {
 
       // Pas instellingen toe
       tempSensor.setOffset(temp_offset);
+#if TEMP_SENSOR_ARRAY_MODE
+      tempSensor2.setOffset(temp_offset);
+#if TEMP_SENSOR_ARRAY_MODE >= 3
+      tempSensor3.setOffset(temp_offset);
+#endif
+#endif
       cycleController.setTargetTop(T_top);
       cycleController.setTargetBottom(T_bottom);
       cycleController.setMaxCycles(cyclus_max);
@@ -2376,6 +2569,26 @@ void setup() {
     webServer.setGetCurrentTempCallback([]() { return g_currentTempC; });
     webServer.setGetMedianTempCallback([]() { return getMedianTemp(); });
     webServer.setIsActiveCallback([]() { return cycleController.isActive(); });
+    webServer.setGetPidTuningCallback([]() { return cycleController.getPidTuning(); });
+    webServer.setSavePidTuningCallback([](const PidTuning& tuning) {
+      settingsStore.savePidTuning(tuning);
+      cycleController.setPidTuning(tuning);
+    });
+    webServer.setGetProfileCallback([](int slot, CycleProfile& profile) {
+      return settingsStore.loadProfile(slot, profile);
+    });
+    webServer.setSaveProfileCallback([](int slot, const CycleProfile* profile) {
+      if (profile == nullptr) {
+        settingsStore.deleteProfile(slot);
+      } else if (!settingsStore.saveProfile(slot, *profile)) {
+        return false;
+      }
+      // Gewijzigd slot is het gekozen profiel: opnieuw laden (lukt niet terwijl het loopt)
+      if (slot == active_profile_slot) selectProfile(slot);
+      return true;
+    });
+    webServer.setGetActiveProfileCallback([]() { return active_profile_slot; });
+    webServer.setSelectProfileCallback([](int slot) { return selectProfile(slot); });
     webServer.setIsHeatingCallback([]() { return cycleController.isHeating(); });
     webServer.setGetCycleCountCallback([]() { return cycleController.getCycleCount(); });
     webServer.setGetTtopCallback([]() { return T_top; });
@@ -2440,6 +2653,16 @@ void setup() {
   
   // Logger module is al geïnitialiseerd in WiFi sectie hierboven
   // (Geen globale variabelen meer nodig - Logger module handelt alles intern af)
+  
+  // Checkpoint bij elke overgang (en elke CYCLE_CHECKPOINT_INTERVAL_MS) in RTC geheugen.
+  // Hervatten pas hier: setup() blokkeert seconden lang (WiFi, NTP) zonder regellus,
+  // de relais mogen pas schakelen als loop() de cyclus bewaakt.
+  cycleController.setCheckpointStore(&rtcCheckpoint);
+  if (warm_restart && cycleController.resume(rtcCheckpoint)) {
+    Serial.println("Warme herstart: cyclus hervat uit RTC checkpoint");
+  } else if (warm_restart && cycleController.isSafetyCooling()) {
+    Serial.println("Warme herstart geweigerd: te veel resets achter elkaar, veiligheidskoeling");
+  }
 }
 
 void loop() {
@@ -2471,9 +2694,31 @@ void loop() {
   // Reset LOGGING status na 1 seconde (via UIController)
   uiController.updateGSStatusReset();
   
+#if THERMAL_SIM_MODE
+  // Model bijwerken met de huidige relais standen (geheugen bank via de RelayActuator)
+  thermalSim.setTargets(T_top, T_bottom);
+  thermalSim.advanceTo(millis(), cycleController.getRelays().isOutputHigh(RelayChannel::HEATER),
+                       cycleController.getRelays().isOutputHigh(RelayChannel::COOLER));
+  static unsigned long last_sim_report = 0;
+  if (millis() - last_sim_report >= THERMAL_SIM_REPORT_MS) {
+    last_sim_report = millis();
+    ThermalSimReport report;
+    thermalSim.getReport(report);
+    Serial.printf("[SIM] %.2f uur, %lu cycli (%.2f/uur), overshoot max %.2f gem %.2f, undershoot max %.2f gem %.2f, "
+                  "latency top %ld ms bodem %ld ms, beveiligingen %lu\n",
+                  report.simHours, (unsigned long)report.cycles, report.cyclesPerHour,
+                  report.maxOvershootC, report.avgOvershootC, report.maxUndershootC, report.avgUndershootC,
+                  (long)report.avgTopLatencyMs, (long)report.avgBottomLatencyMs, (unsigned long)report.safetyTrips);
+  }
+#endif
+  
   // Temperatuur meting (elke 0.3 seconde)
   // VERPLAATST NAAR TempSensor module
+#if TEMP_SENSOR_ARRAY_MODE
+  tempSensorArray.sample();  // Eén kanaal per slot (round-robin)
+#else
   tempSensor.sample();
+#endif
   // Update globale variabelen voor backward compatibility
   g_currentTempC = tempSensor.getCurrent();
   g_avgTempC = tempSensor.getMedian();
@@ -0,0 +1,171 @@
+#include "AutoTune.h"
+
+RelayAutoTune::RelayAutoTune()
+    : status(AutoTuneStatus::IDLE), setpoint(NAN), hysteresis(AUTOTUNE_HYSTERESIS_C), startMs(0),
+      heaterOn(false), measuring(false), switchMs(0), extremeC(NAN), extremeMs(0),
+      cycles(0), offSeen(false), lastOffMs(0), lastPeakC(NAN), deadTimeSum(0.0f), deadTimeCount(0),
+      tauSum(0.0f), tauCount(0), riseSlopeSum(0.0f), riseMidSum(0.0f), riseCount(0),
+      amplitudeSum(0.0f), amplitudeCount(0), periodSum(0.0f), periodCount(0) {
+}
+
+void RelayAutoTune::start(float setpointC, float ambientC, uint32_t nowMs, float hysteresisC) {
+    *this = RelayAutoTune();
+    setpoint = setpointC;
+    hysteresis = hysteresisC;
+    startMs = nowMs;
+    model.ambientC = ambientC;
+    model.setpointC = setpointC;
+
+    status = AutoTuneStatus::HEATUP;
+    if (!isnan(ambientC)) {
+        checkAmbient();
+    }
+    // Anders: omgeving = eerste geldige meting in update(), verwarming blijft tot dan uit
+}
+
+void RelayAutoTune::checkAmbient() {
+    // Zonder duidelijke afstand tot de omgeving is de dalende helling (en dus tau) niet te meten
+    if (model.setpointC - model.ambientC < AUTOTUNE_MIN_RISE_C) {
+        status = AutoTuneStatus::FAILED;
+        heaterOn = false;
+        return;
+    }
+    heaterOn = true;
+}
+
+void RelayAutoTune::abort() {
+    heaterOn = false;
+    if (status == AutoTuneStatus::HEATUP || status == AutoTuneStatus::RELAY) {
+        status = AutoTuneStatus::FAILED;
+    }
+}
+
+AutoTuneStatus RelayAutoTune::update(uint32_t nowMs, float tempC) {
+    if (status != AutoTuneStatus::HEATUP && status != AutoTuneStatus::RELAY) {
+        return status;
+    }
+    if (nowMs - startMs > AUTOTUNE_TIMEOUT_MS) {
+        abort();
+        return status;
+    }
+    if (isnan(tempC)) {
+        return status;  // Relais blijft staan; CycleController schakelt zonder meting de verwarming uit
+    }
+
+    if (status == AutoTuneStatus::HEATUP) {
+        if (isnan(model.ambientC)) {
+            model.ambientC = tempC;
+            checkAmbient();
+            return status;
+        }
+        if (tempC >= setpoint + hysteresis) {
+            status = AutoTuneStatus::RELAY;
+            switchHeater(false, nowMs, tempC);
+        }
+        return status;
+    }
+
+    // Extreem na het schakelen: eerste keer hoogste (uit) of laagste (aan) waarde
+    if (heaterOn ? (tempC < extremeC) : (tempC > extremeC)) {
+        extremeC = tempC;
+        extremeMs = nowMs;
+    }
+    if (!heaterOn && tempC <= setpoint - hysteresis) {
+        switchHeater(true, nowMs, tempC);
+    } else if (heaterOn && tempC >= setpoint + hysteresis) {
+        switchHeater(false, nowMs, tempC);
+    }
+    return status;
+}
+
+void RelayAutoTune::switchHeater(bool on, uint32_t nowMs, float tempC) {
+    bool halfDone = !isnan(extremeC) && extremeMs != switchMs;  // Wrap-veilig: extremeMs >= switchMs
+    if (measuring && halfDone) {
+        float deadTime = (extremeMs - switchMs) / 1000.0f;
+        float slopeTime = (nowMs - extremeMs) / 1000.0f;
+        if (slopeTime > 0.0f) {
+            float slope = (tempC - extremeC) / slopeTime;
+            float mid = (tempC + extremeC) / 2.0f;
+            if (on) {
+                // Einde uit-fase: dalende helling geeft tau
+                if (slope < 0.0f && mid > model.ambientC) {
+                    tauSum += (mid - model.ambientC) / -slope;
+                    tauCount++;
+                }
+                lastPeakC = extremeC;
+            } else {
+                // Einde aan-fase: stijgende helling, K volgt met de gemiddelde tau
+                if (slope > 0.0f) {
+                    riseSlopeSum += slope;
+                    riseMidSum += mid;
+                    riseCount++;
+                }
+                if (!isnan(lastPeakC)) {
+                    amplitudeSum += (lastPeakC - extremeC) / 2.0f;
+                    amplitudeCount++;
+                }
+            }
+        }
+        deadTimeSum += deadTime;
+        deadTimeCount++;
+    }
+
+    if (!on) {
+        // Uit-schakelmoment: einde van een volledige oscillatie
+        if (offSeen) {
+            cycles++;
+            if (measuring) {
+                periodSum += (nowMs - lastOffMs) / 1000.0f;
+                periodCount++;
+            }
+            measuring = true;  // Eerste oscillatie (na de opwarm transient) overgeslagen
+        }
+        offSeen = true;
+        lastOffMs = nowMs;
+        if (cycles >= AUTOTUNE_RELAY_CYCLES) {
+            finishModel();
+            heaterOn = false;
+            return;
+        }
+    }
+
+    heaterOn = on;
+    switchMs = nowMs;
+    extremeC = tempC;
+    extremeMs = nowMs;
+}
+
+void RelayAutoTune::finishModel() {
+    if (tauCount == 0 || riseCount == 0 || deadTimeCount == 0 || periodCount == 0) {
+        status = AutoTuneStatus::FAILED;
+        return;
+    }
+    float tau = tauSum / tauCount;
+    float slopeOn = riseSlopeSum / riseCount;
+    float midOn = riseMidSum / riseCount;
+    float amplitude = amplitudeCount ? amplitudeSum / amplitudeCount : 0.0f;
+
+    model.tauS = tau;
+    model.gainC = slopeOn * tau + midOn - model.ambientC;
+    model.deadTimeS = deadTimeSum / deadTimeCount;
+    model.ultimatePeriodS = periodSum / periodCount;
+    model.ultimateGain = (amplitude > 0.0f) ? (4.0f * 0.5f) / ((float)M_PI * amplitude) : NAN;
+    model.valid = model.tauS > 0.0f && model.gainC > 0.0f && model.deadTimeS > 0.0f;
+    status = model.valid ? AutoTuneStatus::DONE : AutoTuneStatus::FAILED;
+}
+
+PidTuning pidTuningFromModel(const PlantModel& model, const PidTuning& base) {
+    PidTuning tuning = base;
+    if (!model.valid) {
+        return tuning;
+    }
+    // SIMC (Skogestad): kp = tau / (K * (tau_c + L)), Ti = min(tau, 4 * (tau_c + L)), tau_c = L.
+    // Uitgang is duty 0..1, dus K in °C per volle duty.
+    float lag = (model.deadTimeS > 1.0f) ? model.deadTimeS : 1.0f;
+    float kp = model.tauS / (model.gainC * 2.0f * lag);
+    float ti = model.tauS < 8.0f * lag ? model.tauS : 8.0f * lag;
+    tuning.kp = kp;
+    tuning.ki = kp / ti;
+    tuning.kd = kp * lag / 3.0f;
+    return tuning;
+}
@@ -0,0 +1,107 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include <stdint.h>
+#include <math.h>
+#include "../PidController/PidController.h"
+
+#ifndef AUTOTUNE_HYSTERESIS_C
+#define AUTOTUNE_HYSTERESIS_C 1.0f           // Relais schakelt op setpoint +/- deze marge (boven de ruis)
+#endif
+#ifndef AUTOTUNE_RELAY_CYCLES
+#define AUTOTUNE_RELAY_CYCLES 4              // Oscillaties; de eerste telt niet mee (opwarm transient)
+#endif
+#ifndef AUTOTUNE_TIMEOUT_MS
+#define AUTOTUNE_TIMEOUT_MS (3UL * 60 * 60 * 1000)  // Geen model binnen 3 uur = mislukt
+#endif
+#ifndef AUTOTUNE_MIN_RISE_C
+#define AUTOTUNE_MIN_RISE_C 10.0f            // Setpoint minimaal zoveel boven de starttemperatuur
+#endif
+
+// First-order-plus-dead-time model van de opstelling (zelfde vorm als ThermalSimConfig):
+//   dT/dt = (T_ambient + K * u(t - L) - T) / tau,  u = verwarming aan (0/1)
+// plus de relais (Åström-Hägglund) grootheden Ku/Pu waaruit klassieke tuning regels rekenen.
+struct PlantModel {
+    bool valid;
+    float gainC;            // K: eindtemperatuur boven omgeving met verwarming continu aan
+    float tauS;             // Tijdconstante zonder koeling (seconden)
+    float deadTimeS;        // L: verwarming schakelt -> temperatuur keert (incl. sensor/filter vertraging)
+    float ultimateGain;     // Ku = 4d / (pi * a), duty per °C (d = 0.5 voor een 0/1 relais)
+    float ultimatePeriodS;  // Pu: oscillatie periode
+    float ambientC;         // Starttemperatuur (aangenomen omgeving: start vanuit een koude opstelling)
+    float setpointC;
+
+    PlantModel()
+        : valid(false), gainC(NAN), tauS(NAN), deadTimeS(NAN), ultimateGain(NAN),
+          ultimatePeriodS(NAN), ambientC(NAN), setpointC(NAN) {}
+};
+
+enum class AutoTuneStatus : uint8_t {
+    IDLE,
+    HEATUP,   // Verwarming vol aan tot setpoint + hysterese
+    RELAY,    // Relais oscillatie rond het setpoint
+    DONE,     // Model beschikbaar via getModel()
+    FAILED    // Timeout, te warm bij start of geen bruikbare oscillatie
+};
+
+// Relay-feedback experiment: de verwarming wordt een aan/uit relais met hysterese rond het setpoint.
+// Per halve periode worden gemeten: dode tijd (schakelen -> extreem), helling (extreem -> volgende
+// schakelmoment) en amplitude. Uit de stijgende en dalende helling volgen K en tau:
+//   dalend:  slope_off = (T_amb - T) / tau          -> tau = (T - T_amb) / -slope_off
+//   stijgend: slope_on = (T_amb + K - T) / tau      -> K = slope_on * tau + T - T_amb
+// met T het midden van het hellingstuk. Puur (geen Arduino), de aanroeper levert tijd (uint32 ms, mag
+// wrappen) en meting.
+class RelayAutoTune {
+public:
+    RelayAutoTune();
+    // ambientC = NAN: de eerste geldige meting in update() geldt als omgeving
+    void start(float setpointC, float ambientC, uint32_t nowMs, float hysteresisC = AUTOTUNE_HYSTERESIS_C);
+    void abort();
+    AutoTuneStatus update(uint32_t nowMs, float tempC);  // NAN = geen meting (verwarming uit)
+
+    bool isHeaterOn() const { return heaterOn; }
+    AutoTuneStatus getStatus() const { return status; }
+    int getCyclesDone() const { return cycles; }
+    const PlantModel& getModel() const { return model; }
+
+private:
+    void switchHeater(bool on, uint32_t nowMs, float tempC);
+    void checkAmbient();
+    void finishModel();
+
+    AutoTuneStatus status;
+    PlantModel model;
+    float setpoint;
+    float hysteresis;
+    uint32_t startMs;
+    bool heaterOn;
+    bool measuring;           // false tot de eerste volledige oscillatie voorbij is
+
+    // Huidige halve periode
+    uint32_t switchMs;
+    float extremeC;
+    uint32_t extremeMs;
+
+    // Sommen over de gemeten halve periodes
+    int cycles;               // Volledige oscillaties (uit -> aan -> uit)
+    bool offSeen;
+    uint32_t lastOffMs;
+    float lastPeakC;
+    float deadTimeSum;
+    int deadTimeCount;
+    float tauSum;
+    int tauCount;
+    float riseSlopeSum;       // slope_on * tau wordt pas bij het einde berekend (tau gemiddeld)
+    float riseMidSum;
+    int riseCount;
+    float amplitudeSum;
+    int amplitudeCount;
+    float periodSum;
+    int periodCount;
+};
+
+// PID tuning uit het model (SIMC regel met tau_c = L, D-term kp * L / 3 op de gemeten stijgsnelheid).
+// enabled, venster, helling en houdtijd blijven van base.
+PidTuning pidTuningFromModel(const PlantModel& model, const PidTuning& base);
+
+#endif // AUTOTUNE_H
@@ -0,0 +1,42 @@
+#include "CycleCheckpoint.h"
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<CycleStats>::value, "CycleStats wordt met memcpy in het checkpoint gezet");
+static_assert(sizeof(CycleCheckpoint) < 0xFFFF, "size veld is 16 bits");
+
+// CRC-32 (IEEE, gereflecteerd) met een tabel van 16 woorden: klein genoeg voor een checkpoint per overgang
+static const uint32_t CRC_NIBBLE[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+uint32_t cycleCheckpointCrc(const CycleCheckpoint& checkpoint) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(&checkpoint);
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < offsetof(CycleCheckpoint, crc); i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ CRC_NIBBLE[crc & 0x0F];
+        crc = (crc >> 4) ^ CRC_NIBBLE[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+void sealCycleCheckpoint(CycleCheckpoint& checkpoint) {
+    checkpoint.magic = CYCLE_CHECKPOINT_MAGIC;
+    checkpoint.version = CYCLE_CHECKPOINT_VERSION;
+    checkpoint.size = sizeof(CycleCheckpoint);
+    checkpoint.crc = cycleCheckpointCrc(checkpoint);
+}
+
+bool isValidCycleCheckpoint(const CycleCheckpoint& checkpoint) {
+    // Na het inschakelen staat er willekeurige inhoud in RTC geheugen: kop en CRC moeten kloppen
+    return checkpoint.magic == CYCLE_CHECKPOINT_MAGIC &&
+           checkpoint.version == CYCLE_CHECKPOINT_VERSION &&
+           checkpoint.size == sizeof(CycleCheckpoint) &&
+           checkpoint.crc == cycleCheckpointCrc(checkpoint) &&
+           checkpoint.state < (uint8_t)CycleState::COUNT;
+}
+
+void invalidateCycleCheckpoint(CycleCheckpoint& checkpoint) {
+    checkpoint.magic = 0;
+}
@@ -0,0 +1,88 @@
+#ifndef CYCLECHECKPOINT_H
+#define CYCLECHECKPOINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "CycleController.h"
+
+#ifndef CYCLE_CHECKPOINT_INTERVAL_MS
+#define CYCLE_CHECKPOINT_INTERVAL_MS 2000  // Tussen overgangen: verstreken fasetijden actueel houden
+#endif
+
+#ifndef CYCLE_RESUME_MAX
+#define CYCLE_RESUME_MAX 3  // Warme herstarts achter elkaar; de volgende reset wordt veiligheidskoeling
+#endif
+#ifndef CYCLE_RESUME_WINDOW_MS
+#define CYCLE_RESUME_WINDOW_MS (10UL * 60 * 1000)  // Zo lang zonder reset na een herstart: teller terug naar 0
+#endif
+
+#define CYCLE_CHECKPOINT_MAGIC 0x50434B43UL  // "CKCP"
+#define CYCLE_CHECKPOINT_VERSION 1
+
+// Volledige fase toestand van CycleController voor een warme herstart na een brownout, watchdog of
+// panic reset. Bedoeld voor RTC geheugen (RTC_NOINIT_ATTR): blijft staan over een reset, niet over
+// het wegvallen van de voeding. Daarom een POD zonder constructor (een constructor zou de inhoud bij
+// het opstarten overschrijven) en een CRC over alles vóór het crc veld.
+// Tijdstippen staan als leeftijd (nu - tijdstip, MONO_US_UNSET = niet gestart): esp_timer begint
+// na een reset weer bij 0. De tijd dat de ESP32 herstartte telt niet mee.
+// Een crash loop (bijv. een panic die telkens in dezelfde fase optreedt) zou bij elke herstart de
+// verwarming weer inschakelen: na CYCLE_RESUME_MAX herstarts zonder CYCLE_RESUME_WINDOW_MS stabiel
+// te draaien weigert resume() en start de veiligheidskoeling.
+struct CycleCheckpoint {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;              // sizeof(CycleCheckpoint): andere firmware layout = ongeldig
+    uint32_t sequence;          // Geschreven checkpoints sinds START (diagnose)
+
+    uint8_t state;              // CycleState
+    bool profileLoaded;
+    bool profileRunning;
+    uint8_t profileIndex;
+    uint16_t profileLoops;
+    bool cyclePending;
+    uint8_t resumeCount;        // Warme herstarts sinds de laatste stabiele periode (crash loop bewaking)
+    int32_t cycleCount;
+
+    // Timers (leeftijd in µs) en duren van de vorige fasen
+    MonoUs heatAge;
+    MonoUs coolAge;
+    MonoUs lastHeatStartAge;
+    MonoUs lastCoolStartAge;
+    MonoUs safetyAge;
+    MonoUs afterrunAge;
+    MonoUs stagnationAge;
+    MonoUs holdAge;
+    MonoUs heaterOnAge;
+    uint32_t lastHeatMs;
+    uint32_t lastCoolMs;
+    uint32_t heaterOnMs;
+
+    // Temperatuur tracking
+    TempQ lastTransitionTemp;
+    TempQ stagnationTemp;
+    TempQ cutoffTemp;
+    TempQ peakTemp;
+    TempQ troughTemp;
+    TempQ cycleTopQ;
+    float cutoffRate;
+    float predictLagS;
+    PeakPrediction lastPeak;
+
+    // PID: helling en I-term (geen sprong in de duty na de herstart)
+    float rampStartTemp;
+    float pidSetpoint;
+    float pidIntegral;
+
+    CycleProfile profile;
+    CycleRecord cycleRecord;
+    alignas(4) uint8_t cycleStats[sizeof(CycleStats)];  // Ring + percentiel schatters (memcpy)
+
+    uint32_t crc;               // CRC-32 over alle voorgaande bytes
+};
+
+uint32_t cycleCheckpointCrc(const CycleCheckpoint& checkpoint);
+void sealCycleCheckpoint(CycleCheckpoint& checkpoint);         // Kop + CRC invullen na het schrijven
+bool isValidCycleCheckpoint(const CycleCheckpoint& checkpoint);
+void invalidateCycleCheckpoint(CycleCheckpoint& checkpoint);
+
+#endif // CYCLECHECKPOINT_H
@@ -1,21 +1,33 @@
 #include "CycleController.h"
+#include "CycleCheckpoint.h"
 #include "../TempSensor/TempSensor.h"
 #include "../Logger/Logger.h"
+#include "../SafetySupervisor/SafetySupervisor.h"
 #include <Arduino.h>
 #include <math.h>
+#include <string.h>
 
 // Constanten
-#define TEMP_SAFETY_COOLING 35.0
+// Drempels in kwart graden (TempQ), vergelijkingen zijn integer
+#define TEMP_SAFETY_COOLING TEMP_Q(35.0)
 #define VEILIGHEIDSKOELING_NALOOP_MS (2 * 60 * 1000) // 2 minuten
-#define TEMP_STAGNATIE_BANDWIDTH 3.0
+#define TEMP_STAGNATIE_BANDWIDTH TEMP_Q(3.0)
 #define TEMP_STAGNATIE_TIJD_MS (2 * 60 * 1000) // 2 minuten
+#define TEMP_PREDICT_PEAK_DROP TEMP_Q(1.0)     // Piek vastgesteld als de temperatuur zoveel gezakt is
+#define TEMP_PREDICT_MIN_RATE 0.01f            // °C/s, daaronder geen voorspelling/leren (ruis)
+#define PID_REACH_BAND TEMP_Q(0.5)             // PID modus: T_top "bereikt" binnen deze marge (setpoint wordt asymptotisch benaderd)
+#define PID_STAGNATIE_MIN_DUTY 0.9f            // PID modus: stagnatie alleen bewaken bij (bijna) vol vermogen
+#define AUTOTUNE_MAX_OVERSHOOT TEMP_Q(20.0)    // Autotune: afbreken zoveel boven het setpoint (model klopt niet)
+#define FASE_TIJD_MIN_CYCLI 5                  // Fasetijd afwijking pas melden na zoveel vastgelegde cycli
+#define FASE_TIJD_MAX_AFWIJKING 10.0f          // Melding bij meer dan zoveel % afwijking van de mediaan
 
 // Helper functie voor tijd formatting
-static void formatTijdChar(unsigned long milliseconden, char* buffer, size_t buffer_size) {
-    unsigned long seconden = milliseconden / 1000;
-    unsigned long minuten = seconden / 60;
-    unsigned long sec = seconden % 60;
-    snprintf(buffer, buffer_size, "%lu:%02lu", minuten, sec);
+// uint32_t ms: hoogstens 71582 minuten, "71582:47" past in een char[10]
+static void formatTijdChar(uint32_t milliseconden, char* buffer, size_t buffer_size) {
+    unsigned int seconden = milliseconden / 1000;
+    unsigned int minuten = seconden / 60;
+    unsigned int sec = seconden % 60;
+    snprintf(buffer, buffer_size, "%u:%02u", minuten, sec);
 }
 
 // Helper functie om fase tijd te resetten naar "0:00"
@@ -24,169 +36,382 @@ static void resetFaseTijd(char* buffer, size_t buffer_size) {
     buffer[buffer_size - 1] = '\0';
 }
 
+// Checkpoint tijden als leeftijd t.o.v. nu: overleeft een reset (esp_timer begint weer bij 0)
+static MonoUs monoAge(MonoUs since, MonoUs now) {
+    return isSetMono(since) ? now - since : MONO_US_UNSET;
+}
+
+static MonoUs monoFromAge(MonoUs age, MonoUs now) {
+    return isSetMono(age) ? now - age : MONO_US_UNSET;
+}
+
 CycleController::CycleController() 
-    : tempSensor(nullptr), logger(nullptr), transitionCallback(nullptr), cycleCountSaveCallback(nullptr),
-      cyclus_actief(false), verwarmen_actief(true), systeem_uit(false), koelingsfase_actief(false),
-      verwarmen_start_tijd(0), koelen_start_tijd(0),
+    : tempSensor(nullptr), sensorArray(nullptr), controlSource(TempControlSource::CHANNEL), controlChannel(0),
+      logger(nullptr), transitionCallback(nullptr), cycleCountSaveCallback(nullptr), autoTuneCallback(nullptr),
+      state(CycleState::OFF), event_temp(TEMP_Q_INVALID),
+      verwarmen_start_tijd(MONO_US_UNSET), koelen_start_tijd(MONO_US_UNSET),
       last_opwarmen_duur(0), last_koelen_duur(0),
-      last_opwarmen_start_tijd(0), last_koelen_start_tijd(0),
-      veiligheidskoeling_start_tijd(0), veiligheidskoeling_naloop_start_tijd(0),
-      last_transition_temp(NAN), laatste_temp_voor_stagnatie(NAN), stagnatie_start_tijd(0),
-      gemiddelde_opwarmen_duur(0), opwarmen_telling(0),
-      fase_tijd_history_count(0), fase_tijd_history_index(0),
-      T_top(80.0), T_bottom(25.0), cyclus_max(0), cyclus_teller(1),
+      last_opwarmen_start_tijd(MONO_US_UNSET), last_koelen_start_tijd(MONO_US_UNSET),
+      veiligheidskoeling_start_tijd(MONO_US_UNSET), veiligheidskoeling_naloop_start_tijd(MONO_US_UNSET),
+      last_transition_temp(TEMP_Q_INVALID), laatste_temp_voor_stagnatie(TEMP_Q_INVALID),
+      stagnatie_start_tijd(MONO_US_UNSET),
+      predictive_cutoff(false), predict_lag_s(TEMP_PREDICT_LAG_S),
+      cutoff_temp(TEMP_Q_INVALID), cutoff_rate(0.0f), peak_temp(TEMP_Q_INVALID),
+      pid_setpoint(NAN), ramp_start_temp(NAN), pid_last_us(MONO_US_UNSET), hold_start_tijd(MONO_US_UNSET), heater_on(false),
+      profile_loaded(false), profile_running(false), profile_index(0), profile_loops(0),
+      autotune_setpoint(NAN),
+      cycle_top_q(TEMP_Q_INVALID), cycle_pending(false), trough_temp(TEMP_Q_INVALID),
+      heater_on_ms(0), heater_on_since(MONO_US_UNSET),
+      checkpoint_store(nullptr), checkpoint_last_us(MONO_US_UNSET), checkpoint_sequence(0),
+      resume_count(0), resumed_at(MONO_US_UNSET),
+      safety_supervisor(nullptr), safety_trips_seen(0),
+      T_top(80.0), T_bottom(25.0), T_top_q(TEMP_Q(80.0)), T_bottom_q(TEMP_Q(25.0)),
+      cyclus_max(0), cyclus_teller(1),
       relais_koelen_pin(5), relais_verwarming_pin(23) {
-    // Initialiseer fasetijd history array
-    for (int i = 0; i < FASE_TIJD_HISTORY_SIZE; i++) {
-        fase_tijd_history[i] = 0;
-    }
+    memset(&cycle_record, 0, sizeof(cycle_record));
+    last_peak.cutoffTemp = NAN;
+    last_peak.cutoffRate = NAN;
+    last_peak.predictedPeak = NAN;
+    last_peak.actualPeak = NAN;
+    last_peak.lagSeconds = predict_lag_s;
+    last_peak.cycles = 0;
+    memset(&profile, 0, sizeof(profile));
 }
 
+// Transitietabel, kolommen in de volgorde van CycleEvent:
+// NONE, START, STOP, RESET, TOP_REACHED, BOTTOM_REACHED, CYCLES_DONE, HEAT_TIMEOUT, STAGNATION,
+// BELOW_SAFE, ABOVE_SAFE, AFTERRUN_DONE, HOLD_START, HOLD_DONE, SEGMENT_HEAT, SEGMENT_COOL, PROFILE_DONE,
+// AUTOTUNE_START, AUTOTUNE_DONE, AUTOTUNE_FAILED, SAFETY_TRIP
+#define T_(action, next) { action, (uint8_t)(next) }
+#define IGN { nullptr, CycleController::STAY }
+#define S_OFF CycleState::OFF
+#define S_HEAT CycleState::HEATING
+#define S_COOL CycleState::COOLING
+#define S_SAFE CycleState::SAFETY_COOLING
+#define S_HOLD CycleState::HOLD
+#define S_TUNE CycleState::AUTOTUNE
+static_assert((int)CycleEvent::COUNT == 21, "Transitietabel kolommen aanpassen aan CycleEvent");
+static_assert((int)CycleState::COUNT == 6, "Transitietabel rijen aanpassen aan CycleState");
+const CycleController::Transition CycleController::TRANSITIONS[STATE_COUNT][EVENT_COUNT] = {
+    // OFF
+    { IGN, T_(&CycleController::actStart, S_HEAT), T_(nullptr, S_SAFE), T_(&CycleController::actReset, S_OFF),
+      IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+      T_(&CycleController::actAutoTuneStart, S_TUNE), IGN, IGN,
+      T_(&CycleController::actSafetyTrip, S_SAFE) },
+    // HEATING
+    { IGN, T_(&CycleController::actStart, S_HEAT), T_(nullptr, S_SAFE), T_(&CycleController::actReset, S_OFF),
+      T_(&CycleController::actTopReached, S_COOL), IGN, IGN,
+      T_(&CycleController::actHeatTimeout, S_SAFE), T_(&CycleController::actStagnation, S_SAFE),
+      IGN, IGN, IGN, T_(nullptr, S_HOLD), IGN,
+      T_(&CycleController::actSegmentHeat, S_HEAT), IGN, T_(&CycleController::actProfileDone, S_SAFE),
+      IGN, IGN, IGN,
+      T_(&CycleController::actSafetyTrip, S_SAFE) },
+    // COOLING
+    { IGN, T_(&CycleController::actStart, S_HEAT), T_(nullptr, S_SAFE), T_(&CycleController::actReset, S_OFF),
+      IGN, T_(&CycleController::actBottomReached, S_HEAT), T_(&CycleController::actCyclesDone, S_OFF),
+      IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+      IGN, T_(&CycleController::actSegmentCool, S_COOL), T_(&CycleController::actProfileDone, S_SAFE),
+      IGN, IGN, IGN,
+      T_(&CycleController::actSafetyTrip, S_SAFE) },
+    // SAFETY_COOLING (STOP herstart de veiligheidskoeling, BELOW/ABOVE_SAFE blijven in de toestand)
+    { IGN, T_(&CycleController::actStart, S_HEAT), T_(nullptr, S_SAFE), T_(&CycleController::actReset, S_OFF),
+      IGN, IGN, IGN, IGN, IGN,
+      T_(&CycleController::actBelowSafe, CycleController::STAY), T_(&CycleController::actAboveSafe, CycleController::STAY),
+      T_(&CycleController::actAfterrunDone, S_OFF), IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+      T_(&CycleController::actSafetyTrip, S_SAFE) },
+    // HOLD (na de houdtijd dezelfde overgang als TOP_REACHED; fasetijd = opwarmen + vasthouden)
+    { IGN, T_(&CycleController::actStart, S_HEAT), T_(nullptr, S_SAFE), T_(&CycleController::actReset, S_OFF),
+      IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+      T_(&CycleController::actTopReached, S_COOL),
+      T_(&CycleController::actSegmentHeat, S_HEAT), IGN, T_(&CycleController::actProfileDone, S_SAFE),
+      IGN, IGN, IGN,
+      T_(&CycleController::actSafetyTrip, S_SAFE) },
+    // AUTOTUNE (START genegeerd: eerst STOP; het experiment eindigt altijd met veiligheidskoeling)
+    { IGN, IGN, T_(nullptr, S_SAFE), T_(&CycleController::actReset, S_OFF),
+      IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+      IGN, T_(&CycleController::actAutoTuneDone, S_SAFE), T_(&CycleController::actAutoTuneFailed, S_SAFE),
+      T_(&CycleController::actSafetyTrip, S_SAFE) },
+};
+#undef T_
+#undef IGN
+#undef S_OFF
+#undef S_HEAT
+#undef S_COOL
+#undef S_SAFE
+#undef S_HOLD
+#undef S_TUNE
+
+const CycleController::Action CycleController::ENTRY[STATE_COUNT] = {
+    &CycleController::enterOff, &CycleController::enterHeating,
+    &CycleController::enterCooling, &CycleController::enterSafetyCooling, &CycleController::enterHold,
+    &CycleController::enterAutoTune
+};
+const CycleController::Action CycleController::EXIT[STATE_COUNT] = {
+    nullptr, &CycleController::exitHeating,
+    &CycleController::exitCooling, &CycleController::exitSafetyCooling, &CycleController::exitHold,
+    &CycleController::exitAutoTune
+};
+const CycleController::Poll CycleController::POLL[STATE_COUNT] = {
+    nullptr, &CycleController::pollHeating,
+    &CycleController::pollCooling, &CycleController::pollSafetyCooling, &CycleController::pollHold,
+    &CycleController::pollAutoTune
+};
+
 void CycleController::begin(TempSensor* tempSensor, Logger* logger, uint8_t relaisKoelenPin, uint8_t relaisVerwarmingPin) {
     this->tempSensor = tempSensor;
     this->logger = logger;
     this->relais_koelen_pin = relaisKoelenPin;
     this->relais_verwarming_pin = relaisVerwarmingPin;
+    pushAdaptiveTargets();
     
-    pinMode(relais_koelen_pin, OUTPUT);
-    pinMode(relais_verwarming_pin, OUTPUT);
-    stopAll();
+    relays.begin(relais_koelen_pin, relais_verwarming_pin);
+    state = CycleState::OFF;
+    enterOff();
 }
 
 void CycleController::update() {
     yield();
-    
-    // Reset koelingsfase_actief als cyclus actief is
-    if (cyclus_actief) {
-        if (koelingsfase_actief) {
-            koelingsfase_actief = false;
-            veiligheidskoeling_start_tijd = 0;
-            veiligheidskoeling_naloop_start_tijd = 0;
+    relays.update();  // Omschakeling die op de dead-time wacht
+    // SafetySupervisor (eigen task) heeft de SSR's al laag gezet: hier melden en veiligheidskoeling
+    if (safety_supervisor != nullptr && safety_supervisor->getTripCount() != safety_trips_seen) {
+        safety_trips_seen = safety_supervisor->getTripCount();
+        dispatch(CycleEvent::SAFETY_TRIP);
+    }
+    Poll poll = POLL[(uint8_t)state];
+    if (poll == nullptr) {
+        return;  // OFF: wacht op START
+    }
+    CycleEvent event = (this->*poll)();
+    if (event != CycleEvent::NONE) {
+        dispatch(event);
+    }
+    // Tussen overgangen: verstreken fasetijden in het checkpoint bijwerken (overgangen schrijven zelf)
+    if (checkpoint_store != nullptr &&
+        (!isSetMono(checkpoint_last_us) || monoElapsedMs(checkpoint_last_us) >= CYCLE_CHECKPOINT_INTERVAL_MS)) {
+        writeCheckpoint();
+    }
+    yield();
+}
+
+bool CycleController::dispatch(CycleEvent event) {
+    const Transition& t = TRANSITIONS[(uint8_t)state][(uint8_t)event];
+    if (t.action == nullptr && t.next == STAY) {
+        return false;
+    }
+    if (t.action != nullptr) {
+        (this->*t.action)();
+    }
+    if (t.next != STAY) {
+        Action exit_hook = EXIT[(uint8_t)state];
+        if (exit_hook != nullptr) {
+            (this->*exit_hook)();
+        }
+        state = (CycleState)t.next;
+        Action entry_hook = ENTRY[(uint8_t)state];
+        if (entry_hook != nullptr) {
+            (this->*entry_hook)();
         }
     }
-    
-    // Veiligheidskoeling fase - alleen als cyclus NIET actief is EN systeem uit is
-    if (!cyclus_actief && koelingsfase_actief && systeem_uit) {
-        handleSafetyCooling();
-        yield();
+    writeCheckpoint();
+    return true;
+}
+
+void CycleController::writeCheckpoint() {
+    if (checkpoint_store == nullptr) {
         return;
     }
-    
-    // Normale cyclus logica - alleen als cyclus actief is en systeem niet uit
-    if (!cyclus_actief || systeem_uit) {
-        float currentTemp = tempSensor->getCurrent();
-        if (isnan(currentTemp)) {
-            return;
-        }
-        // Systeem is uit of cyclus niet actief - stop hier, start geen nieuwe cyclus
+    CycleCheckpoint& cp = *checkpoint_store;
+    if (state == CycleState::OFF) {
+        invalidateCycleCheckpoint(cp);  // Niets te hervatten (na STOP eerst de veiligheidskoeling)
         return;
     }
-    
-    // Extra veiligheidscheck
-    if (koelingsfase_actief) {
-        koelingsfase_actief = false;
-        veiligheidskoeling_start_tijd = 0;
-        veiligheidskoeling_naloop_start_tijd = 0;
+    MonoUs now = monoNowUs();
+    checkpoint_last_us = now;
+    // Lang genoeg stabiel na de laatste warme herstart: een volgende reset telt weer als eerste
+    if (resume_count > 0 && monoElapsedMs(resumed_at, now) >= CYCLE_RESUME_WINDOW_MS) {
+        resume_count = 0;
     }
     
-    yield();
+    // Schrijven in place: een reset halverwege geeft een CRC fout en dus een gewone koude start
+    cp.sequence = ++checkpoint_sequence;
+    cp.state = (uint8_t)state;
+    cp.profileLoaded = profile_loaded;
+    cp.profileRunning = profile_running;
+    cp.profileIndex = profile_index;
+    cp.profileLoops = profile_loops;
+    cp.cyclePending = cycle_pending;
+    cp.resumeCount = resume_count;
+    cp.cycleCount = cyclus_teller;
     
-    if (verwarmen_actief) {
-        handleHeating();
-    } else {
-        handleCooling();
-    }
+    cp.heatAge = monoAge(verwarmen_start_tijd, now);
+    cp.coolAge = monoAge(koelen_start_tijd, now);
+    cp.lastHeatStartAge = monoAge(last_opwarmen_start_tijd, now);
+    cp.lastCoolStartAge = monoAge(last_koelen_start_tijd, now);
+    cp.safetyAge = monoAge(veiligheidskoeling_start_tijd, now);
+    cp.afterrunAge = monoAge(veiligheidskoeling_naloop_start_tijd, now);
+    cp.stagnationAge = monoAge(stagnatie_start_tijd, now);
+    cp.holdAge = monoAge(hold_start_tijd, now);
+    cp.heaterOnAge = heater_on ? monoAge(heater_on_since, now) : MONO_US_UNSET;
+    cp.lastHeatMs = last_opwarmen_duur;
+    cp.lastCoolMs = last_koelen_duur;
+    cp.heaterOnMs = heater_on_ms;
     
-    yield();
+    cp.lastTransitionTemp = last_transition_temp;
+    cp.stagnationTemp = laatste_temp_voor_stagnatie;
+    cp.cutoffTemp = cutoff_temp;
+    cp.peakTemp = peak_temp;
+    cp.troughTemp = trough_temp;
+    cp.cycleTopQ = cycle_top_q;
+    cp.cutoffRate = cutoff_rate;
+    cp.predictLagS = predict_lag_s;
+    cp.lastPeak = last_peak;
+    
+    cp.rampStartTemp = ramp_start_temp;
+    cp.pidSetpoint = pid_setpoint;
+    cp.pidIntegral = pid.getIntegral();
+    
+    cp.profile = profile;
+    cp.cycleRecord = cycle_record;
+    memcpy(cp.cycleStats, &cycle_stats, sizeof(cycle_stats));
+    sealCycleCheckpoint(cp);
 }
 
-void CycleController::start() {
-    reset();
-    cyclus_actief = true;
-    systeem_uit = false;
-    verwarmen_actief = true;
-    startHeating();
-    verwarmen_start_tijd = millis();
-    koelen_start_tijd = 0;
-    cyclus_teller = 1;
-    // Opslaan reset cyclus_teller (via callback)
-    if (cycleCountSaveCallback) {
-        cycleCountSaveCallback(cyclus_teller);
+bool CycleController::resume(const CycleCheckpoint& cp) {
+    if (state != CycleState::OFF || !isValidCycleCheckpoint(cp) || cp.state == (uint8_t)CycleState::OFF) {
+        return false;
+    }
+    MonoUs now = monoNowUs();
+    resumed_at = now;
+    
+    // Crash loop: niet opnieuw verwarmen maar koelen. De teller blijft in het checkpoint staan, zodat
+    // ook een reset tijdens de veiligheidskoeling niet hervat wordt
+    if (cp.resumeCount >= CYCLE_RESUME_MAX) {
+        resume_count = cp.resumeCount;
+        cyclus_teller = cp.cycleCount;
+        char status[50];
+        snprintf(status, sizeof(status), "Herstart geweigerd: %d resets", (int)cp.resumeCount + 1);
+        logTransition(status, getCriticalTemp());
+        dispatch(CycleEvent::STOP);
+        return false;
+    }
+    resume_count = cp.resumeCount + 1;
+    
+    cyclus_teller = cp.cycleCount;
+    last_opwarmen_duur = cp.lastHeatMs;
+    last_koelen_duur = cp.lastCoolMs;
+    last_opwarmen_start_tijd = monoFromAge(cp.lastHeatStartAge, now);
+    last_koelen_start_tijd = monoFromAge(cp.lastCoolStartAge, now);
+    last_transition_temp = cp.lastTransitionTemp;
+    cutoff_temp = cp.cutoffTemp;
+    cutoff_rate = cp.cutoffRate;
+    peak_temp = cp.peakTemp;
+    predict_lag_s = cp.predictLagS;
+    last_peak = cp.lastPeak;
+    
+    // Profiel uit het checkpoint: het lopende profiel, ook als het gekozen profiel bij boot anders is
+    profile_loaded = cp.profileLoaded && validateCycleProfile(cp.profile);
+    if (profile_loaded) {
+        profile = cp.profile;
+    }
+    profile_running = cp.profileRunning && profile_loaded && cp.profileIndex < profile.count;
+    profile_index = profile_running ? cp.profileIndex : 0;
+    profile_loops = profile_running ? cp.profileLoops : 0;
+    pushAdaptiveTargets();
+    
+    memcpy(&cycle_stats, cp.cycleStats, sizeof(cycle_stats));
+    cycle_record = cp.cycleRecord;
+    cycle_top_q = cp.cycleTopQ;
+    cycle_pending = cp.cyclePending;
+    trough_temp = cp.troughTemp;
+    heater_on_ms = cp.heaterOnMs;
+    checkpoint_sequence = cp.sequence;
+    
+    // Toestand zonder transitie: de entry hook zet relais en timers, daarna de bewaarde timers terug.
+    // HOLD: relais via driveHeaterPid() in pollHold(), de opwarm timer loopt door (zoals na HOLD_START).
+    CycleState saved = (CycleState)cp.state;
+    bool autotune_lost = (saved == CycleState::AUTOTUNE);
+    state = autotune_lost ? CycleState::SAFETY_COOLING : saved;
+    Action entry_hook = ENTRY[(uint8_t)state];
+    if (entry_hook != nullptr) {
+        (this->*entry_hook)();
+    }
+    if (!autotune_lost) {
+        verwarmen_start_tijd = monoFromAge(cp.heatAge, now);
+        koelen_start_tijd = monoFromAge(cp.coolAge, now);
+        veiligheidskoeling_start_tijd = monoFromAge(cp.safetyAge, now);
+        veiligheidskoeling_naloop_start_tijd = monoFromAge(cp.afterrunAge, now);
+        hold_start_tijd = monoFromAge(cp.holdAge, now);
+        laatste_temp_voor_stagnatie = cp.stagnationTemp;
+        stagnatie_start_tijd = monoFromAge(cp.stagnationAge, now);
+        if (isSetMono(cp.heaterOnAge) && heater_on) {
+            heater_on_since = monoFromAge(cp.heaterOnAge, now);
+        }
+        // PID: helling vanaf het oorspronkelijke startpunt, I-term terug (geen duty sprong)
+        ramp_start_temp = cp.rampStartTemp;
+        pid_setpoint = cp.pidSetpoint;
+        pid.reset(cp.pidIntegral);
+        pid_last_us = now;
     }
     
-    // Reset fasetijd history bij nieuwe start
-    fase_tijd_history_count = 0;
-    fase_tijd_history_index = 0;
-    for (int i = 0; i < FASE_TIJD_HISTORY_SIZE; i++) {
-        fase_tijd_history[i] = 0;
+    char status[50];
+    if (autotune_lost) {
+        strncpy(status, "Herstart: autotune afgebroken", sizeof(status) - 1);
+        status[sizeof(status) - 1] = '\0';
+    } else {
+        snprintf(status, sizeof(status), "Herstart: cyclus %d hervat", cyclus_teller);
     }
+    logTransition(status, getCriticalTemp());
+    writeCheckpoint();
+    return true;
+}
+
+void CycleController::start() {
+    dispatch(CycleEvent::START);
 }
 
 void CycleController::stop() {
-    cyclus_actief = false;
-    systeem_uit = true;
-    stopAll();
-    
-    // Start veiligheidskoeling
-    koelingsfase_actief = true;
-    startCooling();
-    veiligheidskoeling_start_tijd = millis();
-    veiligheidskoeling_naloop_start_tijd = 0;
-    
-    verwarmen_start_tijd = 0;
-    koelen_start_tijd = 0;
+    // Ook vanuit OFF: start altijd (opnieuw) de veiligheidskoeling
+    dispatch(CycleEvent::STOP);
 }
 
 void CycleController::reset() {
-    cyclus_actief = false;
-    verwarmen_actief = true;
-    systeem_uit = false;
-    koelingsfase_actief = false;
-    verwarmen_start_tijd = 0;
-    koelen_start_tijd = 0;
-    last_opwarmen_duur = 0;
-    last_koelen_duur = 0;
-    last_opwarmen_start_tijd = 0;
-    last_koelen_start_tijd = 0;
-    veiligheidskoeling_start_tijd = 0;
-    veiligheidskoeling_naloop_start_tijd = 0;
-    last_transition_temp = NAN;
-    laatste_temp_voor_stagnatie = NAN;
-    stagnatie_start_tijd = 0;
-    gemiddelde_opwarmen_duur = 0;
-    opwarmen_telling = 0;
-    cyclus_teller = 1;
-    // Opslaan reset cyclus_teller (via callback)
-    if (cycleCountSaveCallback) {
-        cycleCountSaveCallback(cyclus_teller);
+    dispatch(CycleEvent::RESET);
+}
+
+bool CycleController::startAutoTune(float setpointC) {
+    if (state != CycleState::OFF || isnan(setpointC)) {
+        return false;
     }
-    startSystem();
+    autotune_setpoint = setpointC;
+    dispatch(CycleEvent::AUTOTUNE_START);
+    // Te warm bij start: de eerstvolgende update() gaat via AUTOTUNE_FAILED naar veiligheidskoeling
+    return autotune.getStatus() != AutoTuneStatus::FAILED;
 }
 
 bool CycleController::isActive() const {
-    return cyclus_actief;
+    return state == CycleState::HEATING || state == CycleState::COOLING || state == CycleState::HOLD ||
+           state == CycleState::AUTOTUNE;
 }
 
 bool CycleController::isHeating() const {
-    return verwarmen_actief;
+    if (state == CycleState::AUTOTUNE) return heater_on;
+    return state == CycleState::HEATING || state == CycleState::HOLD;
 }
 
 bool CycleController::isSystemOff() const {
-    return systeem_uit;
+    return state == CycleState::OFF || state == CycleState::SAFETY_COOLING;
 }
 
 bool CycleController::isSafetyCooling() const {
-    return koelingsfase_actief;
+    return state == CycleState::SAFETY_COOLING;
 }
 
 unsigned long CycleController::getHeatingElapsed() const {
-    if (verwarmen_start_tijd == 0) return 0;
-    return millis() - verwarmen_start_tijd;
+    return monoElapsedMs(verwarmen_start_tijd);
 }
 
 unsigned long CycleController::getCoolingElapsed() const {
-    if (koelen_start_tijd == 0) return 0;
-    return millis() - koelen_start_tijd;
+    return monoElapsedMs(koelen_start_tijd);
 }
 
 int CycleController::getCycleCount() const {
@@ -194,7 +419,7 @@ int CycleController::getCycleCount() const {
 }
 
 float CycleController::getLastTransitionTemp() const {
-    return last_transition_temp;
+    return tempFromQ(last_transition_temp);
 }
 
 unsigned long CycleController::getLastHeatingDuration() const {
@@ -207,10 +432,21 @@ unsigned long CycleController::getLastCoolingDuration() const {
 
 void CycleController::setTargetTop(float tTop) {
     T_top = tTop;
+    T_top_q = tempToQ(tTop);
+    pushAdaptiveTargets();
 }
 
 void CycleController::setTargetBottom(float tBottom) {
     T_bottom = tBottom;
+    T_bottom_q = tempToQ(tBottom);
+    pushAdaptiveTargets();
+}
+
+void CycleController::pushAdaptiveTargets() {
+    // TempSensor versnelt de sample rate rond de schakelpunten (alleen actief met setAdaptiveSampling())
+    if (tempSensor != nullptr) {
+        tempSensor->setAdaptiveTargets(tempFromQ(heatTargetQ()), tempFromQ(coolTargetQ()));
+    }
 }
 
 void CycleController::setMaxCycles(int maxCycles) {
@@ -221,6 +457,16 @@ void CycleController::setCycleCount(int cycleCount) {
     cyclus_teller = cycleCount;
 }
 
+void CycleController::setSensorArray(TempSensorArray* array, TempControlSource source, int channel) {
+    sensorArray = array;
+    setControlSource(source, channel);
+}
+
+void CycleController::setControlSource(TempControlSource source, int channel) {
+    controlSource = source;
+    controlChannel = channel;
+}
+
 void CycleController::setTransitionCallback(TransitionCallback cb) {
     transitionCallback = cb;
 }
@@ -229,23 +475,51 @@ void CycleController::setCycleCountSaveCallback(CycleCountSaveCallback cb) {
     cycleCountSaveCallback = cb;
 }
 
-float CycleController::getCriticalTemp() const {
-    if (tempSensor == nullptr) return NAN;
-    float temp = tempSensor->getCritical();
-    if (isnan(temp)) {
-        temp = tempSensor->getMedian();
+void CycleController::setSafetySupervisor(SafetySupervisor* supervisor) {
+    safety_supervisor = supervisor;
+    safety_trips_seen = 0;  // Een trip van vóór het koppelen (tijdens setup()) wordt ook gemeld
+}
+
+void CycleController::setAutoTuneCallback(AutoTuneCallback cb) {
+    autoTuneCallback = cb;
+}
+
+void CycleController::setPlantModel(const PlantModel& model) {
+    plant_model = model;
+    if (!model.valid) return;
+    // De dode tijd is de naloop na uitschakelen: startwaarde voor de voorspellende uitschakeling
+    float lag = model.deadTimeS;
+    if (lag < 0.0f) lag = 0.0f;
+    if (lag > TEMP_PREDICT_LAG_MAX_S) lag = TEMP_PREDICT_LAG_MAX_S;
+    predict_lag_s = lag;
+    last_peak.lagSeconds = lag;
+}
+
+TempQ CycleController::getCriticalTemp() const {
+    if (sensorArray != nullptr) {
+        TempQ temp = sensorArray->getCriticalQ(controlSource, controlChannel);
+        if (!isValidQ(temp)) {
+            temp = sensorArray->getMedianQ(controlSource, controlChannel);
+        }
+        return temp;
+    }
+    if (tempSensor == nullptr) return TEMP_Q_INVALID;
+    // getCriticalQ() is een goedkope query op al verzamelde samples (geen extra reads)
+    TempQ temp = tempSensor->getCriticalQ();
+    if (!isValidQ(temp)) {
+        temp = tempSensor->getMedianQ();
     }
     return temp;
 }
 
-void CycleController::logTransition(const char* status, float temp) {
+void CycleController::logTransition(const char* status, TempQ temp) {
     if (logger == nullptr) return;
     
     LogRequest req;
     strncpy(req.status, status, 49);
     req.status[49] = '\0';
     
-    req.temp = temp;
+    req.temp = tempFromQ(temp);
     
     // Bij "Afkoelen tot Opwarmen" is cyclus_teller al verhoogd
     if (strcmp(status, "Afkoelen tot Opwarmen") == 0) {
@@ -259,17 +533,19 @@ void CycleController::logTransition(const char* status, float temp) {
     req.T_bottom = T_bottom;
     
     char fase_tijd_str[10];
-    unsigned long log_timestamp_ms = millis();
+    MonoUs log_timestamp = monoNowUs();
     char cyclus_tijd_str[10];
     
     if (strcmp(status, "Afkoelen tot Opwarmen") == 0) {
-        if (last_koelen_duur > 0 && last_koelen_start_tijd > 0) {
+        if (last_koelen_duur > 0 && isSetMono(last_koelen_start_tijd)) {
             formatTijdChar(last_koelen_duur, fase_tijd_str, sizeof(fase_tijd_str));
-            log_timestamp_ms = last_koelen_start_tijd;
+            log_timestamp = last_koelen_start_tijd;
             
-            // Voeg afkoelen fasetijd toe aan history en controleer afwijking
-            addFaseTijdToHistory(last_koelen_duur);
-            checkFaseTijdDeviation(last_koelen_duur);
+            // Controleer afwijking t.o.v. de mediane koelfase
+            // (niet in een profiel: segmenten hebben bewust verschillende fasetijden)
+            if (!profile_running) {
+                checkFaseTijdDeviation(last_koelen_duur, CycleMetric::COOL_MS);
+            }
             
             if (last_opwarmen_duur > 0) {
                 unsigned long totaal_cyclus_duur = last_opwarmen_duur + last_koelen_duur;
@@ -279,39 +555,40 @@ void CycleController::logTransition(const char* status, float temp) {
             }
             
             last_koelen_duur = 0;
-            last_koelen_start_tijd = 0;
+            last_koelen_start_tijd = MONO_US_UNSET;
             last_opwarmen_duur = 0;
-            last_opwarmen_start_tijd = 0;
+            last_opwarmen_start_tijd = MONO_US_UNSET;
         } else {
             resetFaseTijd(fase_tijd_str, sizeof(fase_tijd_str));
             resetFaseTijd(cyclus_tijd_str, sizeof(cyclus_tijd_str));
         }
     } else if (strcmp(status, "Opwarmen tot Afkoelen") == 0) {
-        if (last_opwarmen_duur > 0 && last_opwarmen_start_tijd > 0) {
+        if (last_opwarmen_duur > 0 && isSetMono(last_opwarmen_start_tijd)) {
             formatTijdChar(last_opwarmen_duur, fase_tijd_str, sizeof(fase_tijd_str));
-            log_timestamp_ms = last_opwarmen_start_tijd;
+            log_timestamp = last_opwarmen_start_tijd;
             
-            // Voeg opwarmen fasetijd toe aan history en controleer afwijking
-            addFaseTijdToHistory(last_opwarmen_duur);
-            checkFaseTijdDeviation(last_opwarmen_duur);
+            // Controleer afwijking t.o.v. de mediane opwarmfase
+            if (!profile_running) {
+                checkFaseTijdDeviation(last_opwarmen_duur, CycleMetric::HEAT_MS);
+            }
         } else {
             resetFaseTijd(fase_tijd_str, sizeof(fase_tijd_str));
         }
         cyclus_tijd_str[0] = '\0';
     } else if (strcmp(status, "Veiligheidskoeling") == 0) {
-        if (veiligheidskoeling_start_tijd > 0) {
-            formatTijdChar(millis() - veiligheidskoeling_start_tijd, fase_tijd_str, sizeof(fase_tijd_str));
-            log_timestamp_ms = veiligheidskoeling_start_tijd;
+        if (isSetMono(veiligheidskoeling_start_tijd)) {
+            formatTijdChar(monoElapsedMs(veiligheidskoeling_start_tijd), fase_tijd_str, sizeof(fase_tijd_str));
+            log_timestamp = veiligheidskoeling_start_tijd;
         } else {
             strncpy(fase_tijd_str, "0:00", sizeof(fase_tijd_str) - 1);
             fase_tijd_str[sizeof(fase_tijd_str) - 1] = '\0';
         }
         resetFaseTijd(cyclus_tijd_str, sizeof(cyclus_tijd_str));
     } else if (strcmp(status, "Uit") == 0) {
-        if (veiligheidskoeling_start_tijd > 0) {
-            formatTijdChar(millis() - veiligheidskoeling_start_tijd, fase_tijd_str, sizeof(fase_tijd_str));
-            log_timestamp_ms = veiligheidskoeling_start_tijd;
-            veiligheidskoeling_start_tijd = 0;
+        if (isSetMono(veiligheidskoeling_start_tijd)) {
+            formatTijdChar(monoElapsedMs(veiligheidskoeling_start_tijd), fase_tijd_str, sizeof(fase_tijd_str));
+            log_timestamp = veiligheidskoeling_start_tijd;
+            veiligheidskoeling_start_tijd = MONO_US_UNSET;
         } else {
             resetFaseTijd(fase_tijd_str, sizeof(fase_tijd_str));
         }
@@ -325,288 +602,633 @@ void CycleController::logTransition(const char* status, float temp) {
     req.fase_tijd[9] = '\0';
     strncpy(req.cyclus_tijd, cyclus_tijd_str, 9);
     req.cyclus_tijd[9] = '\0';
-    req.timestamp_ms = log_timestamp_ms;
+    req.timestamp_us = log_timestamp;
     
     logger->log(req);
     
     if (transitionCallback) {
-        transitionCallback(status, temp, log_timestamp_ms);
+        transitionCallback(status, tempFromQ(temp), log_timestamp);
     }
 }
 
-void CycleController::handleHeating() {
-    if (verwarmen_start_tijd == 0) {
-        verwarmen_start_tijd = millis();
-    }
-    
-    // BEVEILIGING: Check of opwarmtijd > 2x gemiddelde
-    if (gemiddelde_opwarmen_duur > 0 && verwarmen_start_tijd > 0) {
-        unsigned long huidige_opwarmen_duur = millis() - verwarmen_start_tijd;
-        unsigned long max_opwarmen_duur = gemiddelde_opwarmen_duur * 2;
-        
-        if (huidige_opwarmen_duur > max_opwarmen_duur) {
-            yield();
-            logTransition("Beveiliging: Opwarmen te lang", getCriticalTemp());
-            cyclus_actief = false;
-            systeem_uit = true;
-            verwarmen_actief = false;
-            stopAll();
-            koelingsfase_actief = true;
-            startCooling();
-            veiligheidskoeling_start_tijd = millis();
-            veiligheidskoeling_naloop_start_tijd = 0;
-            verwarmen_start_tijd = 0;
-            laatste_temp_voor_stagnatie = NAN;
-            stagnatie_start_tijd = 0;
-            yield();
-            return;
+CycleEvent CycleController::pollHeating() {
+    // BEVEILIGING: Check of opwarmtijd > 2x mediane opwarmtijd
+    // (niet in een profiel: de mediaan mengt segmenten met verschillende doelen en hellingen)
+    float mediaan_opwarmen = cycle_stats.getMedian(CycleMetric::HEAT_MS);
+    if (!profile_running && !isnan(mediaan_opwarmen) && isSetMono(verwarmen_start_tijd)) {
+        unsigned long huidige_opwarmen_duur = monoElapsedMs(verwarmen_start_tijd);
+        if (huidige_opwarmen_duur > mediaan_opwarmen * 2.0f) {
+            event_temp = getCriticalTemp();
+            return CycleEvent::HEAT_TIMEOUT;
         }
     }
     
-    float temp_for_check = getCriticalTemp();
-    if (isnan(temp_for_check)) {
-        laatste_temp_voor_stagnatie = NAN;
-        stagnatie_start_tijd = 0;
-        return;
+    TempQ temp_for_check = getCriticalTemp();
+    event_temp = temp_for_check;
+    bool pid_actief = usePid();
+    if (pid_actief) {
+        driveHeaterPid(temp_for_check, rampSetpoint());
+    }
+    if (!isValidQ(temp_for_check)) {
+        laatste_temp_voor_stagnatie = TEMP_Q_INVALID;
+        stagnatie_start_tijd = MONO_US_UNSET;
+        return CycleEvent::NONE;
     }
+    trackTrough(temp_for_check);
     
     // BEVEILIGING: Detecteer temperatuur stagnatie (alleen als temp >35°C)
     // BELANGRIJK: Alleen activeren als temperatuur >35°C (niet aanraak-veilig)
     // Als temperatuur <35°C, hoeft beveiliging niet aan te spreken
-    if (temp_for_check > TEMP_SAFETY_COOLING) {
-        if (isnan(laatste_temp_voor_stagnatie)) {
+    // PID modus: alleen bij (bijna) vol vermogen, een bewust vlakke helling is geen stagnatie
+    bool stagnatie_bewaken = !pid_actief || pid.getOutput() >= PID_STAGNATIE_MIN_DUTY;
+    if (temp_for_check > TEMP_SAFETY_COOLING && stagnatie_bewaken) {
+        if (!isValidQ(laatste_temp_voor_stagnatie)) {
             laatste_temp_voor_stagnatie = temp_for_check;
-            stagnatie_start_tijd = millis();
+            stagnatie_start_tijd = monoNowUs();
         } else {
-            float temp_verschil = fabsf(temp_for_check - laatste_temp_voor_stagnatie);
+            int temp_verschil = abs((int)temp_for_check - (int)laatste_temp_voor_stagnatie);
             if (temp_verschil <= TEMP_STAGNATIE_BANDWIDTH) {
-                unsigned long stagnatie_duur = millis() - stagnatie_start_tijd;
-                if (stagnatie_duur >= TEMP_STAGNATIE_TIJD_MS) {
-                    yield();
-                    logTransition("Beveiliging: Temperatuur stagnatie", temp_for_check);
-                    cyclus_actief = false;
-                    systeem_uit = true;
-                    verwarmen_actief = false;
-                    stopAll();
-                    koelingsfase_actief = true;
-                    startCooling();
-                    veiligheidskoeling_start_tijd = millis();
-                    veiligheidskoeling_naloop_start_tijd = 0;
-                    verwarmen_start_tijd = 0;
-                    laatste_temp_voor_stagnatie = NAN;
-                    stagnatie_start_tijd = 0;
-                    yield();
-                    return;
+                if (monoElapsedMs(stagnatie_start_tijd) >= TEMP_STAGNATIE_TIJD_MS) {
+                    return CycleEvent::STAGNATION;
                 }
             } else {
                 laatste_temp_voor_stagnatie = temp_for_check;
-                stagnatie_start_tijd = millis();
+                stagnatie_start_tijd = monoNowUs();
             }
         }
     } else {
         // Temperatuur <= 35°C: reset stagnatie tracking (beveiliging hoeft niet aan te spreken)
-        laatste_temp_voor_stagnatie = NAN;
-        stagnatie_start_tijd = 0;
+        laatste_temp_voor_stagnatie = TEMP_Q_INVALID;
+        stagnatie_start_tijd = MONO_US_UNSET;
     }
     
-    if (temp_for_check >= T_top) {
-        yield();
-        last_opwarmen_duur = (verwarmen_start_tijd > 0) ? (millis() - verwarmen_start_tijd) : 0;
-        last_opwarmen_start_tijd = verwarmen_start_tijd;
-        
-        laatste_temp_voor_stagnatie = NAN;
-        stagnatie_start_tijd = 0;
-        
-        if (opwarmen_telling == 0) {
-            gemiddelde_opwarmen_duur = last_opwarmen_duur;
-            opwarmen_telling = 1;
-        } else {
-            gemiddelde_opwarmen_duur = (gemiddelde_opwarmen_duur * 7 + last_opwarmen_duur * 3) / 10;
-            opwarmen_telling++;
+    TempQ top_q = heatTargetQ();
+    // Doel bereikt: vasthouden, of door naar het volgende (profiel)segment
+    CycleEvent reached = (holdSeconds() > 0) ? CycleEvent::HOLD_START
+                       : profile_running ? segmentDoneEvent() : CycleEvent::TOP_REACHED;
+    if (pid_actief) {
+        return (temp_for_check < top_q - PID_REACH_BAND) ? CycleEvent::NONE : reached;
+    }
+    
+    if (temp_for_check >= top_q) {
+        return reached;
+    }
+    
+    // Voorspellend: uitschakelen zodat de piek (door naloop) op het doel uitkomt
+    if (predictive_cutoff && temp_for_check >= top_q - TEMP_PREDICT_MAX_LEAD_C * TEMP_Q_PER_DEGREE) {
+        float rate = getControlRate();
+        if (rate > TEMP_PREDICT_MIN_RATE && tempFromQ(temp_for_check) + rate * predict_lag_s >= tempFromQ(top_q)) {
+            return reached;
         }
-        
-        last_transition_temp = temp_for_check;
-        yield();
-        logTransition("Opwarmen tot Afkoelen", temp_for_check);
-        yield();
-        verwarmen_actief = false;
-        startCooling();
-        yield();
-        koelen_start_tijd = millis();
-        verwarmen_start_tijd = 0;
-        yield();
     }
+    return CycleEvent::NONE;
 }
 
-void CycleController::handleCooling() {
-    if (koelen_start_tijd == 0) {
-        koelen_start_tijd = millis();
+CycleEvent CycleController::pollCooling() {
+    TempQ temp_for_check = getCriticalTemp();
+    if (isValidQ(temp_for_check)) {
+        trackPeak(temp_for_check);
     }
-    
-    float temp_for_check = getCriticalTemp();
-    if (isnan(temp_for_check)) {
-        return;
+    if (!isValidQ(temp_for_check) || temp_for_check > coolTargetQ()) {
+        return CycleEvent::NONE;
     }
-    
-    if (temp_for_check <= T_bottom) {
-        yield();
-        cyclus_teller++;
-        // Opslaan cyclus_teller in Preferences (via callback)
-        if (transitionCallback) {
-            // Callback wordt aangeroepen in logTransition, maar we moeten eerst de teller opslaan
-            // We gebruiken een speciale callback voor cyclus_teller opslag
-        }
-        last_koelen_duur = (koelen_start_tijd > 0) ? (millis() - koelen_start_tijd) : 0;
-        last_koelen_start_tijd = koelen_start_tijd;
-        last_transition_temp = temp_for_check;
-        logTransition("Afkoelen tot Opwarmen", temp_for_check);
-        
-        if (cyclus_max > 0 && cyclus_teller > cyclus_max) {
-            logTransition("Uit", temp_for_check);
-            cyclus_actief = false;
-            systeem_uit = true;
-            stopAll();
-            verwarmen_start_tijd = 0;
-            koelen_start_tijd = 0;
-            return;
-        }
-        
-        verwarmen_actief = true;
-        startHeating();
-        verwarmen_start_tijd = millis();
-        koelen_start_tijd = 0;
+    event_temp = temp_for_check;
+    if (profile_running) {
+        return segmentDoneEvent();  // Aantal cycli volgt uit de herhaalblokken, cyclus_max geldt niet
     }
+    // cyclus_teller wordt in de actie verhoogd, daarna geldt cyclus_teller > cyclus_max
+    if (cyclus_max > 0 && cyclus_teller + 1 > cyclus_max) {
+        return CycleEvent::CYCLES_DONE;
+    }
+    return CycleEvent::BOTTOM_REACHED;
 }
 
-void CycleController::handleSafetyCooling() {
-    float temp_for_check = getCriticalTemp();
-    if (isnan(temp_for_check)) {
-        return;
+CycleEvent CycleController::pollSafetyCooling() {
+    TempQ temp_for_check = getCriticalTemp();
+    if (!isValidQ(temp_for_check)) {
+        return CycleEvent::NONE;
     }
+    event_temp = temp_for_check;
     
-    if (temp_for_check < TEMP_SAFETY_COOLING) {
-        if (veiligheidskoeling_naloop_start_tijd == 0) {
-            veiligheidskoeling_naloop_start_tijd = millis();
-            logTransition("Veiligheidskoeling", temp_for_check);
-        }
-        
-        unsigned long naloop_verstreken = millis() - veiligheidskoeling_naloop_start_tijd;
-        if (naloop_verstreken >= VEILIGHEIDSKOELING_NALOOP_MS) {
-            koelingsfase_actief = false;
-            stopAll();
-            verwarmen_start_tijd = 0;
-            koelen_start_tijd = 0;
-            veiligheidskoeling_start_tijd = 0;
-            veiligheidskoeling_naloop_start_tijd = 0;
-            logTransition("Uit", temp_for_check);
-        } else {
-            startCooling();
-        }
-    } else {
-        startCooling();
-        if (veiligheidskoeling_naloop_start_tijd > 0) {
-            veiligheidskoeling_naloop_start_tijd = 0;
+    if (temp_for_check >= TEMP_SAFETY_COOLING) {
+        return isSetMono(veiligheidskoeling_naloop_start_tijd) ? CycleEvent::ABOVE_SAFE : CycleEvent::NONE;
+    }
+    if (!isSetMono(veiligheidskoeling_naloop_start_tijd)) {
+        return CycleEvent::BELOW_SAFE;
+    }
+    if (monoElapsedMs(veiligheidskoeling_naloop_start_tijd) >= VEILIGHEIDSKOELING_NALOOP_MS) {
+        return CycleEvent::AFTERRUN_DONE;
+    }
+    return CycleEvent::NONE;
+}
+
+CycleEvent CycleController::pollHold() {
+    TempQ temp_for_check = getCriticalTemp();
+    driveHeaterPid(temp_for_check, tempFromQ(heatTargetQ()));
+    if (isValidQ(temp_for_check)) {
+        event_temp = temp_for_check;
+    }
+    if (!usePid() || monoElapsedMs(hold_start_tijd) >= holdSeconds() * 1000UL) {
+        CycleEvent done = profile_running ? segmentDoneEvent() : CycleEvent::HOLD_DONE;
+        // Volgend segment koelt: dezelfde overgang als na de PID houdtijd
+        return (done == CycleEvent::TOP_REACHED) ? CycleEvent::HOLD_DONE : done;
+    }
+    return CycleEvent::NONE;
+}
+
+CycleEvent CycleController::pollAutoTune() {
+    TempQ temp_for_check = getCriticalTemp();
+    float temp_c = NAN;
+    if (isValidQ(temp_for_check)) {
+        event_temp = temp_for_check;
+        temp_c = tempFromQ(temp_for_check);
+        if (temp_for_check > tempToQ(autotune_setpoint) + AUTOTUNE_MAX_OVERSHOOT) {
+            autotune.abort();
+            return CycleEvent::AUTOTUNE_FAILED;
         }
     }
+    AutoTuneStatus status = autotune.update(monoMillis32(), temp_c);
+    // Geen geldige meting: verwarming uit (veilige kant), het experiment loopt door
+    bool aan = isValidQ(temp_for_check) && autotune.isHeaterOn();
+    if (aan != heater_on) {
+        setRelays(false, aan);
+    }
+    if (status == AutoTuneStatus::DONE) return CycleEvent::AUTOTUNE_DONE;
+    if (status == AutoTuneStatus::FAILED) return CycleEvent::AUTOTUNE_FAILED;
+    return CycleEvent::NONE;
 }
 
-void CycleController::startSystem() {
-    digitalWrite(relais_koelen_pin, LOW);
-    digitalWrite(relais_verwarming_pin, LOW);
-    systeem_uit = false;
+void CycleController::actStart() {
+    resetCycleData();
+    resume_count = 0;  // Bewuste START: geen crash loop meer
+    
+    // Profiel start bij het eerste (verwarm)segment
+    profile_running = profile_loaded;
+    profile_index = 0;
+    profile_loops = 0;
+    pushAdaptiveTargets();
+    
+    // START na een trip: de supervisor controleert direct opnieuw (oorzaak weg of nieuwe trip)
+    if (safety_supervisor != nullptr) {
+        safety_supervisor->clearTrip();
+    }
+    
+    // Statistiek geldt per run
+    cycle_stats.reset();
+    cycle_pending = false;
+    trough_temp = TEMP_Q_INVALID;
+    heater_on_ms = 0;
 }
 
-void CycleController::startHeating() {
-    yield();
-    digitalWrite(relais_koelen_pin, LOW);
-    digitalWrite(relais_verwarming_pin, HIGH);
-    yield();
-    verwarmen_actief = true;
+void CycleController::actSafetyTrip() {
+    // Trip temperatuur van de supervisor (eigen snapshot), anders de huidige meting
+    float trip_temp = safety_supervisor->getTripTemp();
+    event_temp = isnan(trip_temp) ? getCriticalTemp() : tempToQ(trip_temp);
+    last_transition_temp = event_temp;
+    char status[50];
+    snprintf(status, sizeof(status), "Beveiliging: %s", SafetySupervisor::tripName(safety_supervisor->getTrip()));
+    logTransition(status, event_temp);
+}
+
+void CycleController::actReset() {
+    resetCycleData();
+    profile_running = false;
+    pushAdaptiveTargets();
 }
 
-void CycleController::startCooling() {
+void CycleController::actTopReached() {
+    last_opwarmen_duur = monoElapsedMs(verwarmen_start_tijd);
+    last_opwarmen_start_tijd = verwarmen_start_tijd;
+    
+    // Nieuwe cyclus in opbouw (het doel vóór advanceSegment(): de overshoot hoort bij dit segment)
+    finishTrough();
+    memset(&cycle_record, 0, sizeof(cycle_record));
+    cycle_record.cycle = cyclus_teller;
+    cycle_record.heatMs = last_opwarmen_duur;
+    cycle_record.peak = TEMP_Q_INVALID;
+    cycle_record.trough = TEMP_Q_INVALID;
+    cycle_top_q = heatTargetQ();
+    
+    last_transition_temp = event_temp;
+    
+    // Startpunt voor de piek meting in de koelfase
+    cutoff_temp = event_temp;
+    cutoff_rate = getControlRate();
+    peak_temp = event_temp;
+    
     yield();
-    digitalWrite(relais_koelen_pin, HIGH);
-    digitalWrite(relais_verwarming_pin, LOW);
+    logTransition("Opwarmen tot Afkoelen", event_temp);
+    advanceSegment();
+}
+
+void CycleController::actBottomReached() {
+    cyclus_teller++;
+    last_koelen_duur = monoElapsedMs(koelen_start_tijd);
+    last_koelen_start_tijd = koelen_start_tijd;
+    last_transition_temp = event_temp;
+    
+    // Cyclus compleet op het dal na: dat wordt in de volgende opwarmfase gemeten
+    cycle_record.coolMs = last_koelen_duur;
+    cycle_record.heaterOnMs = heater_on_ms;
+    heater_on_ms = 0;
+    cycle_pending = (cycle_record.heatMs > 0);
+    trough_temp = event_temp;
+    
     yield();
-    verwarmen_actief = false;
+    logTransition("Afkoelen tot Opwarmen", event_temp);
+    advanceSegment();
+}
+
+void CycleController::actCyclesDone() {
+    actBottomReached();
+    // Geen volgende opwarmfase: piek en dal zoals tot nu toe gemeten
+    finishPeak();
+    finishTrough();
+    logTransition("Uit", event_temp);
+}
+
+void CycleController::actHeatTimeout() {
+    logTransition("Beveiliging: Opwarmen te lang", event_temp);
+}
+
+void CycleController::actStagnation() {
+    logTransition("Beveiliging: Temperatuur stagnatie", event_temp);
 }
 
-void CycleController::stopAll() {
-    digitalWrite(relais_koelen_pin, LOW);
-    digitalWrite(relais_verwarming_pin, LOW);
-    systeem_uit = true;
-    cyclus_actief = false;
-    verwarmen_actief = false; // Reset verwarmen_actief om te voorkomen dat cyclus weer start
+void CycleController::actBelowSafe() {
+    veiligheidskoeling_naloop_start_tijd = monoNowUs();
+    logTransition("Veiligheidskoeling", event_temp);
 }
 
-void CycleController::addFaseTijdToHistory(unsigned long fase_tijd_ms) {
-    if (fase_tijd_ms == 0) {
-        return; // Skip 0 waarden
+void CycleController::actAboveSafe() {
+    veiligheidskoeling_naloop_start_tijd = MONO_US_UNSET;
+}
+
+void CycleController::actAfterrunDone() {
+    logTransition("Uit", event_temp);
+}
+
+void CycleController::actSegmentHeat() {
+    last_transition_temp = event_temp;
+    advanceSegment();
+    char status[50];
+    snprintf(status, sizeof(status), "Profiel segment %d: Opwarmen", profile_index + 1);
+    logTransition(status, event_temp);
+}
+
+void CycleController::actSegmentCool() {
+    last_transition_temp = event_temp;
+    advanceSegment();
+    char status[50];
+    snprintf(status, sizeof(status), "Profiel segment %d: Afkoelen", profile_index + 1);
+    logTransition(status, event_temp);
+}
+
+void CycleController::actProfileDone() {
+    last_transition_temp = event_temp;
+    profile_running = false;
+    pushAdaptiveTargets();
+    logTransition("Profiel voltooid", event_temp);
+}
+
+void CycleController::actAutoTuneStart() {
+    if (safety_supervisor != nullptr) {
+        safety_supervisor->clearTrip();
     }
+    char status[50];
+    snprintf(status, sizeof(status), "Autotune gestart (%.0f°C)", autotune_setpoint);
+    logTransition(status, getCriticalTemp());
+}
+
+void CycleController::actAutoTuneDone() {
+    setPlantModel(autotune.getModel());
+    setPidTuning(pidTuningFromModel(plant_model, pid_tuning));
+    last_transition_temp = event_temp;
     
-    // Voeg toe aan history (circular buffer)
-    fase_tijd_history[fase_tijd_history_index] = fase_tijd_ms;
-    fase_tijd_history_index = (fase_tijd_history_index + 1) % FASE_TIJD_HISTORY_SIZE;
-    
-    if (fase_tijd_history_count < FASE_TIJD_HISTORY_SIZE) {
-        fase_tijd_history_count++;
+    char status[50];
+    snprintf(status, sizeof(status), "Autotune: K %.0f tau %.0fs L %.0fs",
+             plant_model.gainC, plant_model.tauS, plant_model.deadTimeS);
+    logTransition(status, event_temp);
+    if (autoTuneCallback) {
+        autoTuneCallback(plant_model, pid_tuning);
     }
 }
 
-unsigned long CycleController::calculateMedianFaseTijd() const {
-    if (fase_tijd_history_count == 0) {
-        return 0;
+void CycleController::actAutoTuneFailed() {
+    last_transition_temp = event_temp;
+    logTransition("Autotune mislukt", event_temp);
+}
+
+void CycleController::enterOff() {
+    setRelays(false, false);
+    verwarmen_start_tijd = MONO_US_UNSET;
+    koelen_start_tijd = MONO_US_UNSET;
+}
+
+void CycleController::enterHeating() {
+    verwarmen_start_tijd = monoNowUs();
+    koelen_start_tijd = MONO_US_UNSET;
+    if (usePid()) {
+        // Relais via driveHeaterPid(); helling start bij de huidige temperatuur
+        setRelays(false, false);
+        pid.reset();
+        pid_output.reset(monoMillis32());
+        pid_last_us = verwarmen_start_tijd;
+        TempQ temp = getCriticalTemp();
+        ramp_start_temp = isValidQ(temp) ? tempFromQ(temp) : tempFromQ(coolTargetQ());
+    } else {
+        setRelays(false, true);
     }
+}
+
+void CycleController::exitHeating() {
+    // verwarmen_start_tijd blijft staan tot enterCooling(): HOLD telt mee in de opwarm fasetijd
+    finishTrough();  // Opwarmfase voorbij zonder duidelijke stijging: laagste waarde tot nu toe
+    laatste_temp_voor_stagnatie = TEMP_Q_INVALID;
+    stagnatie_start_tijd = MONO_US_UNSET;
+}
+
+void CycleController::enterHold() {
+    hold_start_tijd = monoNowUs();
+}
+
+void CycleController::exitHold() {
+    hold_start_tijd = MONO_US_UNSET;
+}
+
+void CycleController::enterAutoTune() {
+    // Omgeving = huidige temperatuur: start vanuit een afgekoelde opstelling
+    TempQ temp = getCriticalTemp();
+    verwarmen_start_tijd = monoNowUs();
+    koelen_start_tijd = MONO_US_UNSET;
+    autotune.start(autotune_setpoint, isValidQ(temp) ? tempFromQ(temp) : NAN, monoMillis32());
+    setRelays(false, autotune.isHeaterOn() && isValidQ(temp));
+}
+
+void CycleController::exitAutoTune() {
+    autotune.abort();  // STOP/RESET tijdens het experiment: geen model
+    setRelays(false, false);
+    verwarmen_start_tijd = MONO_US_UNSET;
+}
+
+void CycleController::enterCooling() {
+    setRelays(true, false);
+    verwarmen_start_tijd = MONO_US_UNSET;
+    koelen_start_tijd = monoNowUs();
+}
+
+void CycleController::exitCooling() {
+    koelen_start_tijd = MONO_US_UNSET;
+    finishPeak();  // Koelfase voorbij zonder duidelijke daling: hoogste waarde tot nu toe
+}
+
+void CycleController::enterSafetyCooling() {
+    // Gedeeld door STOP en beide beveiligingen
+    setRelays(true, false);
+    veiligheidskoeling_start_tijd = monoNowUs();
+    veiligheidskoeling_naloop_start_tijd = MONO_US_UNSET;
+    verwarmen_start_tijd = MONO_US_UNSET;
+    koelen_start_tijd = MONO_US_UNSET;
+}
+
+void CycleController::exitSafetyCooling() {
+    veiligheidskoeling_start_tijd = MONO_US_UNSET;
+    veiligheidskoeling_naloop_start_tijd = MONO_US_UNSET;
+}
+
+void CycleController::setPidTuning(const PidTuning& tuning) {
+    bool was_enabled = pid_tuning.enabled;
+    pid_tuning = tuning;
+    pid.setTunings(tuning.kp, tuning.ki, tuning.kd);
+    pid_output.setWindow(tuning.windowMs);
     
-    // Maak een kopie van de history array voor sortering
-    unsigned long sorted[FASE_TIJD_HISTORY_SIZE];
-    int count = 0;
-    for (int i = 0; i < fase_tijd_history_count; i++) {
-        if (fase_tijd_history[i] > 0) {
-            sorted[count++] = fase_tijd_history[i];
+    if (tuning.enabled != was_enabled) {
+        // Omschakelen tijdens opwarmen: geen integrator sprong over de verstreken tijd, geen helling
+        pid.reset();
+        pid_last_us = monoNowUs();
+        ramp_start_temp = NAN;
+        if (!usePid() && state == CycleState::HEATING) {
+            setRelays(false, true);  // Terug naar aan/uit: verwarming vol aan tot T_top
         }
     }
-    
-    if (count == 0) {
-        return 0;
+}
+
+float CycleController::rampSetpoint() const {
+    float top = tempFromQ(heatTargetQ());
+    float ramp = rampCPerMin();
+    if (ramp <= 0.0f || isnan(ramp_start_temp) || !isSetMono(verwarmen_start_tijd)) {
+        return top;
     }
-    
-    // Bubble sort (eenvoudig voor kleine arrays)
-    for (int i = 0; i < count - 1; i++) {
-        for (int j = 0; j < count - i - 1; j++) {
-            if (sorted[j] > sorted[j + 1]) {
-                unsigned long temp = sorted[j];
-                sorted[j] = sorted[j + 1];
-                sorted[j + 1] = temp;
-            }
+    float minuten = monoElapsedMs(verwarmen_start_tijd) / 60000.0f;
+    float setpoint = ramp_start_temp + ramp * minuten;
+    return (setpoint < top) ? setpoint : top;
+}
+
+bool CycleController::setProfile(const CycleProfile& newProfile) {
+    if (profile_running || !validateCycleProfile(newProfile)) {
+        return false;  // Segment index en lusteller horen bij het lopende profiel
+    }
+    profile = newProfile;
+    profile.name[PROFILE_NAME_LEN - 1] = '\0';
+    profile_loaded = true;
+    return true;
+}
+
+bool CycleController::clearProfile() {
+    if (profile_running) {
+        return false;
+    }
+    profile_loaded = false;
+    return true;
+}
+
+TempQ CycleController::heatTargetQ() const {
+    if (profile_running && segment().mode == (uint8_t)SegmentMode::HEAT) {
+        return segment().target;
+    }
+    return T_top_q;
+}
+
+TempQ CycleController::coolTargetQ() const {
+    if (profile_running && segment().mode == (uint8_t)SegmentMode::COOL) {
+        return segment().target;
+    }
+    return T_bottom_q;
+}
+
+bool CycleController::usePid() const {
+    if (pid_tuning.enabled) return true;
+    // Helling en vasthouden van een profielsegment kunnen alleen met de PID
+    return profile_running && (segment().rampQPerMin > 0 || segment().holdSeconds > 0);
+}
+
+float CycleController::rampCPerMin() const {
+    return profile_running ? segment().rampQPerMin / (float)TEMP_Q_PER_DEGREE : pid_tuning.rampCPerMin;
+}
+
+uint32_t CycleController::holdSeconds() const {
+    if (profile_running) return segment().holdSeconds;
+    return pid_tuning.enabled ? pid_tuning.holdSeconds : 0;
+}
+
+bool CycleController::nextSegment(uint8_t& index, uint16_t& loops) const {
+    // O(1): terug naar het begin van het herhaalblok, of door naar het volgende segment
+    // (blokken zijn niet genest, dus de lusteller hoort bij het eerstvolgende blok einde)
+    const ProfileSegment& seg = profile.segments[index];
+    if (seg.repeat > 1) {
+        if (loops + 1 < seg.repeat) {
+            loops++;
+            index = seg.loopTo;
+            return true;
         }
+        loops = 0;
     }
-    
-    // Bereken mediaan
-    if (count % 2 == 0) {
-        // Even aantal: gemiddelde van twee middelste waarden
-        return (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
-    } else {
-        // Oneven aantal: middelste waarde
-        return sorted[count / 2];
+    index++;
+    return index < profile.count;
+}
+
+CycleEvent CycleController::segmentDoneEvent() const {
+    uint8_t index = profile_index;
+    uint16_t loops = profile_loops;
+    if (!nextSegment(index, loops)) {
+        return CycleEvent::PROFILE_DONE;
+    }
+    bool next_heat = profile.segments[index].mode == (uint8_t)SegmentMode::HEAT;
+    if (state == CycleState::COOLING) {
+        return next_heat ? CycleEvent::BOTTOM_REACHED : CycleEvent::SEGMENT_COOL;
     }
+    return next_heat ? CycleEvent::SEGMENT_HEAT : CycleEvent::TOP_REACHED;
 }
 
-void CycleController::checkFaseTijdDeviation(unsigned long current_fase_tijd_ms) {
-    if (current_fase_tijd_ms == 0 || logger == nullptr) {
+void CycleController::advanceSegment() {
+    // Aangeroepen vanuit de actie van de overgang, vóór de entry hook van de nieuwe toestand
+    if (!profile_running) return;
+    if (!nextSegment(profile_index, profile_loops)) {
+        profile_running = false;  // Niet bereikbaar: segmentDoneEvent() geeft dan PROFILE_DONE
+        profile_index = 0;
+    }
+    pushAdaptiveTargets();
+}
+
+void CycleController::driveHeaterPid(TempQ temp, float setpoint) {
+    MonoUs now_us = monoNowUs();
+    uint32_t now = (uint32_t)(now_us / MONO_US_PER_MS);  // Venster rekent wrap-veilig in uint32 ms
+    bool aan = false;
+    if (isValidQ(temp)) {
+        // PID één keer per venster: de duty wordt toch alleen aan het begin van een venster gebruikt
+        if (pid_output.isWindowDue(now)) {
+            float dt = isSetMono(pid_last_us) ? (now_us - pid_last_us) / 1000000.0f : 0.0f;
+            pid_last_us = now_us;
+            pid_setpoint = setpoint;
+            pid.update(setpoint, tempFromQ(temp), dt, getControlRate());
+        }
+        aan = pid_output.update(now, pid.getOutput());
+    }
+    // Geen geldige meting: verwarming uit (veilige kant), PID state blijft staan
+    if (aan != heater_on) {
+        setRelays(false, aan);
+    }
+}
+
+void CycleController::setRelays(bool koelen, bool verwarmen) {
+    // Nooit beide SSR's tegelijk aan: de actuator schakelt eerst uit en houdt de dead-time aan
+    if (verwarmen && (relays.isHeaterLocked() || (safety_supervisor != nullptr && safety_supervisor->isTripped()))) {
+        verwarmen = false;  // Trip nog niet gemeld of niet gewist: niet tegen de supervisor in schakelen
+    }
+    MonoUs now = monoNowUs();
+    if (heater_on && !verwarmen) heater_on_ms += monoElapsedMs(heater_on_since, now);
+    if (!heater_on && verwarmen) heater_on_since = now;
+    relays.set(verwarmen ? RelayMode::HEAT : koelen ? RelayMode::COOL : RelayMode::OFF);
+    heater_on = verwarmen;
+}
+
+float CycleController::getControlRate() const {
+    // Stijgsnelheid uit de alpha-beta schatter van de (primaire) sensor, NAN als die uit staat
+    return (tempSensor != nullptr) ? tempSensor->getRate() : NAN;
+}
+
+void CycleController::trackPeak(TempQ temp) {
+    if (!isValidQ(peak_temp)) return;
+    if (temp > peak_temp) {
+        peak_temp = temp;
+    } else if (peak_temp - temp >= TEMP_PREDICT_PEAK_DROP) {
+        finishPeak();
+    }
+}
+
+void CycleController::finishPeak() {
+    if (!isValidQ(peak_temp) || !isValidQ(cutoff_temp)) {
+        peak_temp = TEMP_Q_INVALID;
         return;
     }
+    cycle_record.peak = peak_temp;
+    float cutoff = tempFromQ(cutoff_temp);
+    float peak = tempFromQ(peak_temp);
     
-    // We hebben minimaal 5 fasetijden nodig voor betrouwbare mediaan
-    if (fase_tijd_history_count < FASE_TIJD_HISTORY_SIZE) {
+    last_peak.cutoffTemp = cutoff;
+    last_peak.cutoffRate = cutoff_rate;
+    last_peak.actualPeak = peak;
+    if (!isnan(cutoff_rate) && cutoff_rate > TEMP_PREDICT_MIN_RATE) {
+        last_peak.predictedPeak = cutoff + cutoff_rate * predict_lag_s;
+        // Gemeten naloop = stijging na uitschakelen / stijgsnelheid op dat moment
+        float observed = (peak - cutoff) / cutoff_rate;
+        if (observed < 0.0f) observed = 0.0f;
+        if (observed > TEMP_PREDICT_LAG_MAX_S) observed = TEMP_PREDICT_LAG_MAX_S;
+        predict_lag_s += (observed - predict_lag_s) * (TEMP_PREDICT_LEARN_PCT / 100.0f);
+        last_peak.cycles++;
+    } else {
+        last_peak.predictedPeak = NAN;
+    }
+    last_peak.lagSeconds = predict_lag_s;
+    peak_temp = TEMP_Q_INVALID;
+}
+
+void CycleController::trackTrough(TempQ temp) {
+    if (!isValidQ(trough_temp)) return;
+    if (temp < trough_temp) {
+        trough_temp = temp;
+    } else if (temp - trough_temp >= TEMP_PREDICT_PEAK_DROP) {
+        finishTrough();
+    }
+}
+
+void CycleController::finishTrough() {
+    if (cycle_pending) {
+        cycle_record.trough = trough_temp;
+        cycle_record.overshoot = (isValidQ(cycle_record.peak) && isValidQ(cycle_top_q))
+                               ? (TempQ)(cycle_record.peak - cycle_top_q) : TEMP_Q_INVALID;
+        cycle_stats.addCycle(cycle_record);
+        cycle_pending = false;
+    }
+    trough_temp = TEMP_Q_INVALID;
+}
+
+void CycleController::resetCycleData() {
+    last_opwarmen_duur = 0;
+    last_koelen_duur = 0;
+    last_opwarmen_start_tijd = MONO_US_UNSET;
+    last_koelen_start_tijd = MONO_US_UNSET;
+    last_transition_temp = TEMP_Q_INVALID;
+    laatste_temp_voor_stagnatie = TEMP_Q_INVALID;
+    stagnatie_start_tijd = MONO_US_UNSET;
+    cyclus_teller = 1;
+    // Opslaan reset cyclus_teller (via callback)
+    if (cycleCountSaveCallback) {
+        cycleCountSaveCallback(cyclus_teller);
+    }
+}
+
+void CycleController::checkFaseTijdDeviation(unsigned long current_fase_tijd_ms, CycleMetric metric) {
+    if (current_fase_tijd_ms == 0 || logger == nullptr) {
         return;
     }
     
-    unsigned long median = calculateMedianFaseTijd();
-    if (median == 0) {
+    // We hebben minimaal 5 cycli nodig voor een betrouwbare mediaan (P² schatting over de hele run)
+    CycleMetricSummary summary = cycle_stats.getSummary(metric);
+    if (summary.count < FASE_TIJD_MIN_CYCLI || !(summary.p50 >= 1.0f)) {
         return;
     }
+    unsigned long median = (unsigned long)(summary.p50 + 0.5f);
     
     // Bereken afwijking percentage
     float deviation = 0.0;
@@ -617,7 +1239,7 @@ void CycleController::checkFaseTijdDeviation(unsigned long current_fase_tijd_ms)
     }
     
     // Als afwijking > 10%, verstuur notificatie
-    if (deviation > 10.0) {
+    if (deviation > FASE_TIJD_MAX_AFWIJKING) {
         char fase_tijd_str[10];
         char median_str[10];
         formatTijdChar(current_fase_tijd_ms, fase_tijd_str, sizeof(fase_tijd_str));
@@ -632,15 +1254,14 @@ void CycleController::checkFaseTijdDeviation(unsigned long current_fase_tijd_ms)
         LogRequest req;
         strncpy(req.status, status, sizeof(req.status) - 1);
         req.status[sizeof(req.status) - 1] = '\0';
-        req.temp = getCriticalTemp();
+        req.temp = tempFromQ(getCriticalTemp());
         req.cyclus_teller = cyclus_teller;
         req.cyclus_max = cyclus_max;
         req.T_top = T_top;
         req.T_bottom = T_bottom;
-        strncpy(req.fase_tijd, fase_tijd_str, sizeof(req.fase_tijd) - 1);
-        req.fase_tijd[sizeof(req.fase_tijd) - 1] = '\0';
+        snprintf(req.fase_tijd, sizeof(req.fase_tijd), "%s", fase_tijd_str);
         req.cyclus_tijd[0] = '\0';
-        req.timestamp_ms = millis();
+        req.timestamp_us = monoNowUs();
         
         logger->log(req);
     }
@@ -2,9 +2,81 @@
 #define CYCLECONTROLLER_H
 
 #include <stdint.h>
+#include "../TempSensorArray/TempSensorArray.h"
+#include "../PidController/PidController.h"
+#include "CycleProfile.h"
+#include "../AutoTune/AutoTune.h"
+#include "../CycleStats/CycleStats.h"
+#include "../SystemClock/MonoClock.h"
+#include "../RelayActuator/RelayActuator.h"
 
 class TempSensor;
 class Logger;
+struct CycleCheckpoint;
+class SafetySupervisor;
+
+// Voorspellende uitschakeling: verwarming uit zodra T + stijgsnelheid * naloop >= T_top.
+// De naloop (dode tijd van element/wand + filter vertraging) wordt per cyclus geleerd uit de gemeten piek.
+#ifndef TEMP_PREDICT_LAG_S
+#define TEMP_PREDICT_LAG_S 10.0f       // Startwaarde naloop (seconden)
+#endif
+#ifndef TEMP_PREDICT_LAG_MAX_S
+#define TEMP_PREDICT_LAG_MAX_S 120.0f  // Bovengrens geleerde naloop
+#endif
+#ifndef TEMP_PREDICT_MAX_LEAD_C
+#define TEMP_PREDICT_MAX_LEAD_C 20     // Nooit eerder uitschakelen dan zoveel graden onder T_top
+#endif
+#ifndef TEMP_PREDICT_LEARN_PCT
+#define TEMP_PREDICT_LEARN_PCT 30      // Gewicht van de laatste cyclus in de geleerde naloop (%)
+#endif
+
+// Voorspelde vs gemeten piek van de laatste afgeronde opwarmfase
+struct PeakPrediction {
+    float cutoffTemp;     // Temperatuur bij uitschakelen verwarming
+    float cutoffRate;     // Stijgsnelheid bij uitschakelen (°C/s)
+    float predictedPeak;  // cutoffTemp + cutoffRate * naloop (met de naloop van dat moment)
+    float actualPeak;     // Hoogste temperatuur in de koelfase daarna
+    float lagSeconds;     // Geleerde naloop na deze cyclus
+    unsigned long cycles; // Aantal geleerde pieken
+};
+
+// Toestanden van de cyclus. Nieuwe toestanden (soak, hold, pauze) = enum waarde + rij in de
+// transitietabel + eventueel entry/exit hook en poll functie, zonder bestaande handlers te wijzigen.
+enum class CycleState : uint8_t {
+    OFF,             // Relais uit, wacht op START
+    HEATING,         // Verwarmen tot T_top
+    COOLING,         // Koelen tot T_bottom
+    SAFETY_COOLING,  // Na STOP of beveiliging: koelen tot < 35°C + naloop, daarna OFF
+    HOLD,            // PID modus of profiel: doeltemperatuur vasthouden gedurende de houdtijd
+    AUTOTUNE,        // Relay-feedback experiment rond een setpoint, alleen verwarming (zie AutoTune.h)
+    COUNT
+};
+
+// Gebeurtenissen: knoppen (START/STOP/RESET) of gedetecteerd door de poll functie van de huidige toestand
+enum class CycleEvent : uint8_t {
+    NONE,
+    START,
+    STOP,
+    RESET,
+    TOP_REACHED,     // Temperatuur >= T_top
+    BOTTOM_REACHED,  // Temperatuur <= T_bottom, volgende cyclus
+    CYCLES_DONE,     // Temperatuur <= T_bottom en cyclus_max bereikt
+    HEAT_TIMEOUT,    // Beveiliging: opwarmen > 2x gemiddelde
+    STAGNATION,      // Beveiliging: temperatuur stagnatie
+    BELOW_SAFE,      // Veiligheidskoeling: < 35°C, naloop start
+    ABOVE_SAFE,      // Veiligheidskoeling: weer >= 35°C tijdens naloop
+    AFTERRUN_DONE,   // Veiligheidskoeling: naloop verstreken
+    HOLD_START,      // PID modus: T_top bereikt, vasthouden
+    HOLD_DONE,       // PID modus: houdtijd verstreken
+    SEGMENT_HEAT,    // Profiel: verwarmsegment klaar, volgend segment verwarmt ook
+    SEGMENT_COOL,    // Profiel: koelsegment klaar, volgend segment koelt ook
+    PROFILE_DONE,    // Profiel: laatste segment klaar, veiligheidskoeling
+    AUTOTUNE_START,  // startAutoTune() vanuit OFF
+    AUTOTUNE_DONE,   // Autotune: model geschat
+    AUTOTUNE_FAILED, // Autotune: timeout, geen bruikbare oscillatie of te warm bij start
+    SAFETY_TRIP,     // SafetySupervisor (eigen task) heeft de SSR's al laag gezet
+    COUNT
+};
 
 class CycleController {
 public:
@@ -20,6 +92,7 @@ public:
     bool isHeating() const;
     bool isSystemOff() const;
     bool isSafetyCooling() const;
+    CycleState getState() const { return state; }
     unsigned long getHeatingElapsed() const;
     unsigned long getCoolingElapsed() const;
     int getCycleCount() const;
@@ -33,75 +106,253 @@ public:
     void setMaxCycles(int maxCycles);
     void setCycleCount(int cycleCount);  // Voor persistentie bij reboot
     
+    // Multi-channel: regel op een gekozen kanaal of op max/gemiddelde van een TempSensorArray
+    // (nullptr = enkel de TempSensor uit begin() gebruiken)
+    void setSensorArray(TempSensorArray* array, TempControlSource source = TempControlSource::CHANNEL, int channel = 0);
+    void setControlSource(TempControlSource source, int channel = 0);
+    
+    // Voorspellende uitschakeling (uit = schakelen op T_top; de naloop wordt in beide gevallen geleerd)
+    void setPredictiveCutoff(bool enabled) { predictive_cutoff = enabled; }
+    bool isPredictiveCutoff() const { return predictive_cutoff; }
+    PeakPrediction getLastPeak() const { return last_peak; }
+    
+    // PID modus: verwarming time-proportional (venster van 1-2 s) op een setpoint dat met
+    // rampCPerMin naar T_top loopt, daarna optioneel holdSeconds vasthouden (HOLD)
+    void setPidTuning(const PidTuning& tuning);
+    const PidTuning& getPidTuning() const { return pid_tuning; }
+    float getPidDuty() const { return pid.getOutput(); }
+    float getPidSetpoint() const { return pid_setpoint; }
+    
+    // Ramp/soak profiel: vervangt T_top/T_bottom/cyclus_max door de segmenten (zie CycleProfile.h).
+    // Wordt gekopieerd; false als het profiel ongeldig is of er nu een profiel loopt.
+    bool setProfile(const CycleProfile& profile);
+    bool clearProfile();
+    bool hasProfile() const { return profile_loaded; }
+    const CycleProfile& getProfile() const { return profile; }
+    bool isProfileRunning() const { return profile_running; }
+    int getProfileSegment() const { return profile_running ? profile_index : -1; }
+    int getProfileLoop() const { return profile_loops + 1; }  // Doorloop van het huidige herhaalblok (1-based)
+    
+    // Autotune: verwarming als aan/uit relais rond setpointC tot het FOPDT model geschat is.
+    // Alleen vanuit OFF (false anders). Bij succes worden de naloop van de voorspellende uitschakeling
+    // en de PID tuning uit het model gezet en gaat de AutoTuneCallback af; daarna veiligheidskoeling.
+    bool startAutoTune(float setpointC);
+    AutoTuneStatus getAutoTuneStatus() const { return autotune.getStatus(); }
+    int getAutoTuneCycles() const { return autotune.getCyclesDone(); }
+    void setPlantModel(const PlantModel& model);  // Opgeslagen model (SettingsStore) bij boot
+    const PlantModel& getPlantModel() const { return plant_model; }
+    
+    // Cyclus statistiek sinds de laatste START: laatste cycli + min/max/p50/p90/p99 per grootheid.
+    // De mediane fasetijden voeden de fasetijd afwijking melding en de opwarmtijd beveiliging.
+    const CycleStats& getCycleStats() const { return cycle_stats; }
+    
+    // Warme herstart: bij elke overgang (en elke CYCLE_CHECKPOINT_INTERVAL_MS tijdens een cyclus) de
+    // volledige fase toestand in store schrijven, bedoeld voor RTC geheugen (zie CycleCheckpoint.h).
+    // nullptr = uit. In OFF wordt het checkpoint ongeldig gemaakt: er is niets te hervatten.
+    void setCheckpointStore(CycleCheckpoint* store) { checkpoint_store = store; }
+    // Zet een geldig checkpoint terug en stuurt de relais direct aan (alleen vanuit OFF, na begin()
+    // en de instellingen). Autotune is niet te hervatten en wordt veiligheidskoeling. false = niets hervat.
+    // Na CYCLE_RESUME_MAX herstarts binnen CYCLE_RESUME_WINDOW_MS: geweigerd (gelogd), veiligheidskoeling.
+    bool resume(const CycleCheckpoint& checkpoint);
+    int getResumeCount() const { return resume_count; }  // Warme herstarts achter elkaar (0 = stabiel)
+    
+    // Onafhankelijke bewaking (zie SafetySupervisor.h): een trip wordt bij de volgende update() gelogd
+    // en gevolgd door veiligheidskoeling. Zolang de trip staat gaat de verwarming niet aan; START wist de trip.
+    void setSafetySupervisor(SafetySupervisor* supervisor);
+    
+    // SSR paar (dead-time, schakelcycli en aan-tijd per relais). GPIO bank vóór begin() instellen
+    // via getRelays().setGpioBank(); de SafetySupervisor schakelt via dezelfde actuator uit.
+    RelayActuator& getRelays() { return relays; }
+    const RelayActuator& getRelays() const { return relays; }
+    
     // Callbacks
-    typedef void (*TransitionCallback)(const char* status, float temp, unsigned long timestamp);
+    typedef void (*TransitionCallback)(const char* status, float temp, MonoUs timestamp);
     void setTransitionCallback(TransitionCallback cb);
     typedef void (*CycleCountSaveCallback)(int cycleCount);
     void setCycleCountSaveCallback(CycleCountSaveCallback cb);
+    typedef void (*AutoTuneCallback)(const PlantModel& model, const PidTuning& tuning);
+    void setAutoTuneCallback(AutoTuneCallback cb);
 
 private:
-    void handleHeating();
-    void handleCooling();
-    void handleSafetyCooling();
-    void startSystem();
-    void startHeating();
-    void startCooling();
-    void stopAll();
+    // Transitietabel: [toestand][gebeurtenis] -> actie + volgende toestand, O(1) opzoeken in dispatch().
+    // Volgorde bij een transitie: actie, exit hook oude toestand, entry hook nieuwe toestand
+    // (de actie logt dus nog met de fasetijden van de toestand die verlaten wordt).
+    typedef void (CycleController::*Action)();
+    typedef CycleEvent (CycleController::*Poll)();
+    struct Transition {
+        Action action;    // nullptr = geen actie
+        uint8_t next;     // CycleState, of STAY = blijven zonder exit/entry
+    };
+    static const uint8_t STAY = 0xFF;
+    static const uint8_t STATE_COUNT = (uint8_t)CycleState::COUNT;
+    static const uint8_t EVENT_COUNT = (uint8_t)CycleEvent::COUNT;
+    static const Transition TRANSITIONS[STATE_COUNT][EVENT_COUNT];
+    static const Action ENTRY[STATE_COUNT];
+    static const Action EXIT[STATE_COUNT];
+    static const Poll POLL[STATE_COUNT];
+    
+    bool dispatch(CycleEvent event);  // false = gebeurtenis niet afgehandeld in deze toestand
+    void writeCheckpoint();
+    
+    // Poll: bepaalt de gebeurtenis uit temperatuur en timers (geen toestandswijziging)
+    CycleEvent pollHeating();
+    CycleEvent pollCooling();
+    CycleEvent pollSafetyCooling();
+    CycleEvent pollHold();
+    CycleEvent pollAutoTune();
+    
+    // Acties
+    void actStart();
+    void actReset();
+    void actTopReached();
+    void actBottomReached();
+    void actCyclesDone();
+    void actHeatTimeout();
+    void actStagnation();
+    void actBelowSafe();
+    void actAboveSafe();
+    void actAfterrunDone();
+    void actSegmentHeat();
+    void actSegmentCool();
+    void actProfileDone();
+    void actAutoTuneStart();
+    void actAutoTuneDone();
+    void actAutoTuneFailed();
+    void actSafetyTrip();
+    
+    // Entry/exit hooks (relais en timers)
+    void enterOff();
+    void enterHeating();
+    void exitHeating();
+    void enterCooling();
+    void exitCooling();
+    void enterSafetyCooling();
+    void exitSafetyCooling();
+    void enterHold();
+    void exitHold();
+    void enterAutoTune();
+    void exitAutoTune();
+    
+    void setRelays(bool koelen, bool verwarmen);
+    void driveHeaterPid(TempQ temp, float setpoint);
+    float rampSetpoint() const;
+    float getControlRate() const;
+    void trackPeak(TempQ temp);
+    void finishPeak();
+    void trackTrough(TempQ temp);
+    void finishTrough();
+    void resetCycleData();
+    void pushAdaptiveTargets();
+    
+    // Profiel: doelen en regelwijze van het huidige segment (zonder profiel: T_top/T_bottom/PID tuning)
+    const ProfileSegment& segment() const { return profile.segments[profile_index]; }
+    TempQ heatTargetQ() const;
+    TempQ coolTargetQ() const;
+    bool usePid() const;
+    float rampCPerMin() const;
+    uint32_t holdSeconds() const;
+    bool nextSegment(uint8_t& index, uint16_t& loops) const;  // false = profiel klaar
+    CycleEvent segmentDoneEvent() const;
+    void advanceSegment();
     
     TempSensor* tempSensor;
+    TempSensorArray* sensorArray;
+    TempControlSource controlSource;
+    int controlChannel;
     Logger* logger;
     TransitionCallback transitionCallback;
     CycleCountSaveCallback cycleCountSaveCallback;
+    AutoTuneCallback autoTuneCallback;
     
-    // State variabelen
-    bool cyclus_actief;
-    bool verwarmen_actief;
-    bool systeem_uit;
-    bool koelingsfase_actief;
+    // State
+    CycleState state;
+    TempQ event_temp;  // Temperatuur waarop de poll functie de gebeurtenis vaststelde (voor de actie)
     
-    // Timers
-    unsigned long verwarmen_start_tijd;
-    unsigned long koelen_start_tijd;
+    // Timers: tijdstippen in de monotone 64-bit tijdsbasis (MONO_US_UNSET = niet gestart), duren in ms
+    MonoUs verwarmen_start_tijd;
+    MonoUs koelen_start_tijd;
     unsigned long last_opwarmen_duur;
     unsigned long last_koelen_duur;
-    unsigned long last_opwarmen_start_tijd;
-    unsigned long last_koelen_start_tijd;
-    unsigned long veiligheidskoeling_start_tijd;
-    unsigned long veiligheidskoeling_naloop_start_tijd;
-    
-    // Temperatuur tracking
-    float last_transition_temp;
-    float laatste_temp_voor_stagnatie;
-    unsigned long stagnatie_start_tijd;
-    
-    // Beveiliging tracking
-    unsigned long gemiddelde_opwarmen_duur;
-    int opwarmen_telling;
-    
-    // Fasetijd monitoring (laatste 5 fasetijden: opwarmen + afkoelen samen)
-    static const int FASE_TIJD_HISTORY_SIZE = 5;
-    unsigned long fase_tijd_history[FASE_TIJD_HISTORY_SIZE];
-    int fase_tijd_history_count;
-    int fase_tijd_history_index;
-    
-    // Helper functies voor fasetijd monitoring
-    void addFaseTijdToHistory(unsigned long fase_tijd_ms);
-    unsigned long calculateMedianFaseTijd() const;
-    void checkFaseTijdDeviation(unsigned long current_fase_tijd_ms);
-    
-    // Settings
+    MonoUs last_opwarmen_start_tijd;
+    MonoUs last_koelen_start_tijd;
+    MonoUs veiligheidskoeling_start_tijd;
+    MonoUs veiligheidskoeling_naloop_start_tijd;
+    
+    // Temperatuur tracking (kwart graden)
+    TempQ last_transition_temp;
+    TempQ laatste_temp_voor_stagnatie;
+    MonoUs stagnatie_start_tijd;
+    
+    // Voorspellende uitschakeling
+    bool predictive_cutoff;
+    float predict_lag_s;
+    TempQ cutoff_temp;
+    float cutoff_rate;
+    TempQ peak_temp;        // Hoogste temperatuur sinds uitschakelen (TEMP_Q_INVALID = niet actief)
+    PeakPrediction last_peak;
+    
+    // PID modus
+    PidTuning pid_tuning;
+    PidController pid;
+    TimeProportionalOutput pid_output;
+    float pid_setpoint;
+    float ramp_start_temp;
+    MonoUs pid_last_us;
+    MonoUs hold_start_tijd;
+    bool heater_on;  // Huidige stand verwarming relais (PID schakelt alleen bij verandering)
+    
+    // Profiel (vaste grootte, geen heap)
+    CycleProfile profile;
+    bool profile_loaded;
+    bool profile_running;
+    uint8_t profile_index;
+    uint16_t profile_loops;  // Voltooide doorlopen van het huidige herhaalblok
+    
+    // Autotune
+    RelayAutoTune autotune;
+    PlantModel plant_model;
+    float autotune_setpoint;
+    
+    // Cyclus statistiek. Een cyclus wordt vastgelegd zodra het dal na de koelfase bekend is
+    // (begin van de volgende opwarmfase), zodat piek en dal allebei de naloop bevatten.
+    CycleStats cycle_stats;
+    CycleRecord cycle_record;  // Cyclus in opbouw
+    TempQ cycle_top_q;         // Opwarmdoel van de cyclus in opbouw (voor de overshoot)
+    bool cycle_pending;        // Opwarmen + koelen klaar, wacht op het dal
+    TempQ trough_temp;         // Laagste temperatuur sinds uitschakelen koeling (TEMP_Q_INVALID = niet actief)
+    unsigned long heater_on_ms;     // Aan-tijd verwarming relais in de huidige cyclus
+    MonoUs heater_on_since;         // Tijdstip van het laatste inschakelen
+    
+    // Warme herstart
+    CycleCheckpoint* checkpoint_store;
+    MonoUs checkpoint_last_us;
+    uint32_t checkpoint_sequence;
+    uint8_t resume_count;           // Gaat mee in het checkpoint; 0 na CYCLE_RESUME_WINDOW_MS of START
+    MonoUs resumed_at;
+    
+    // Onafhankelijke bewaking
+    SafetySupervisor* safety_supervisor;
+    uint32_t safety_trips_seen;  // Trip teller van de supervisor bij de laatst gemelde trip
+    
+    // Fasetijd afwijking t.o.v. de mediaan van dezelfde fase (opwarmen of afkoelen) in cycle_stats
+    void checkFaseTijdDeviation(unsigned long current_fase_tijd_ms, CycleMetric metric);
+    
+    // Settings (float voor presentatie/logging, TempQ voor de drempel vergelijkingen)
     float T_top;
     float T_bottom;
+    TempQ T_top_q;
+    TempQ T_bottom_q;
     int cyclus_max;
     int cyclus_teller;
     
     // Relais pins (moeten worden doorgegeven in begin())
     uint8_t relais_koelen_pin;
     uint8_t relais_verwarming_pin;
+    RelayActuator relays;
     
     // Helper functies
-    float getCriticalTemp() const;
-    void logTransition(const char* status, float temp);
+    TempQ getCriticalTemp() const;
+    void logTransition(const char* status, TempQ temp);
 };
 
 #endif // CYCLECONTROLLER_H
@@ -0,0 +1,117 @@
+#include "CycleProfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Leest een getal >= 0 na een optie letter; false als er geen getal staat
+static bool parseNumber(const char*& p, float& value) {
+    char* end = nullptr;
+    value = strtof(p, &end);
+    if (end == p || value < 0.0f) return false;
+    p = end;
+    return true;
+}
+
+bool parseCycleProfile(const char* text, const char* name, CycleProfile& out) {
+    memset(&out, 0, sizeof(out));
+    out.version = PROFILE_VERSION;
+    if (name != nullptr) {
+        // Naam gaat ongeëscaped in JSON en op het display
+        for (size_t i = 0; i < PROFILE_NAME_LEN - 1 && name[i] != '\0'; i++) {
+            out.name[i] = (name[i] == '"' || name[i] == '\\' || name[i] < ' ') ? '_' : name[i];
+        }
+    }
+    if (text == nullptr) return false;
+
+    const char* p = text;
+    while (*p != '\0') {
+        while (*p == ' ' || *p == ';') p++;
+        if (*p == '\0') break;
+        if (out.count >= PROFILE_MAX_SEGMENTS) return false;
+
+        ProfileSegment& seg = out.segments[out.count];
+        if (*p == 'H' || *p == 'h') {
+            seg.mode = (uint8_t)SegmentMode::HEAT;
+        } else if (*p == 'C' || *p == 'c') {
+            seg.mode = (uint8_t)SegmentMode::COOL;
+        } else {
+            return false;
+        }
+        p++;
+
+        float value;
+        if (!parseNumber(p, value) || value > PROFILE_MAX_TEMP_C) return false;
+        seg.target = tempToQ(value);
+
+        // Opties in willekeurige volgorde tot het volgende segment
+        while (*p != '\0' && *p != ';') {
+            char option = *p++;
+            if (option == ' ') continue;
+            if (!parseNumber(p, value)) return false;
+            if (option == 'r') {
+                if (value * TEMP_Q_PER_DEGREE > 65535.0f) return false;
+                seg.rampQPerMin = (uint16_t)(value * TEMP_Q_PER_DEGREE + 0.5f);
+            } else if (option == 'h') {
+                if (value > 65535.0f) return false;
+                seg.holdSeconds = (uint16_t)value;
+            } else if (option == 'x') {
+                if (value > 65535.0f || *p != '@') return false;
+                seg.repeat = (uint16_t)value;
+                p++;
+                if (!parseNumber(p, value) || value >= PROFILE_MAX_SEGMENTS) return false;
+                seg.loopTo = (uint8_t)value;
+            } else {
+                return false;
+            }
+        }
+        out.count++;
+    }
+    return validateCycleProfile(out);
+}
+
+size_t formatCycleProfile(const CycleProfile& profile, char* buffer, size_t size) {
+    if (buffer == nullptr || size == 0) return 0;
+    buffer[0] = '\0';
+    size_t len = 0;
+    for (uint8_t i = 0; i < profile.count && i < PROFILE_MAX_SEGMENTS; i++) {
+        const ProfileSegment& seg = profile.segments[i];
+        char part[48];
+        int n = snprintf(part, sizeof(part), "%s%c%g", (i > 0) ? ";" : "",
+                         (seg.mode == (uint8_t)SegmentMode::COOL) ? 'C' : 'H', tempFromQ(seg.target));
+        if (seg.rampQPerMin > 0) {
+            n += snprintf(part + n, sizeof(part) - n, "r%g", seg.rampQPerMin / (float)TEMP_Q_PER_DEGREE);
+        }
+        if (seg.holdSeconds > 0) {
+            n += snprintf(part + n, sizeof(part) - n, "h%u", (unsigned)seg.holdSeconds);
+        }
+        if (seg.repeat > 1) {
+            n += snprintf(part + n, sizeof(part) - n, "x%u@%u", (unsigned)seg.repeat, (unsigned)seg.loopTo);
+        }
+        if (len + n >= size) break;  // Afkappen op een segmentgrens
+        memcpy(buffer + len, part, n + 1);
+        len += n;
+    }
+    return len;
+}
+
+bool validateCycleProfile(const CycleProfile& profile) {
+    if (profile.version != PROFILE_VERSION) return false;
+    if (profile.count == 0 || profile.count > PROFILE_MAX_SEGMENTS) return false;
+    if (profile.segments[0].mode != (uint8_t)SegmentMode::HEAT) return false;  // START begint met verwarmen
+
+    int previous_loop_end = -1;
+    for (uint8_t i = 0; i < profile.count; i++) {
+        const ProfileSegment& seg = profile.segments[i];
+        if (seg.mode > (uint8_t)SegmentMode::COOL) return false;
+        if (seg.target < 0 || seg.target > TEMP_Q(PROFILE_MAX_TEMP_C)) return false;
+        if (seg.mode == (uint8_t)SegmentMode::COOL && (seg.rampQPerMin > 0 || seg.holdSeconds > 0)) {
+            return false;  // Koelen is alleen aan/uit
+        }
+        if (seg.repeat > 1) {
+            // Eén lusteller: een blok mag niet terugspringen in (of voor) een eerder blok
+            if (seg.loopTo > i || (int)seg.loopTo <= previous_loop_end) return false;
+            previous_loop_end = i;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef CYCLEPROFILE_H
+#define CYCLEPROFILE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../TempSensor/TempQ.h"
+
+#ifndef PROFILE_MAX_SEGMENTS
+#define PROFILE_MAX_SEGMENTS 12   // Segmenten per profiel (10 bytes per segment)
+#endif
+#ifndef PROFILE_SLOTS
+#define PROFILE_SLOTS 4           // Opslagplaatsen in SettingsStore
+#endif
+#ifndef PROFILE_MAX_TEMP_C
+#define PROFILE_MAX_TEMP_C 350    // Hoogste segment doeltemperatuur
+#endif
+#define PROFILE_NAME_LEN 16
+#define PROFILE_VERSION 1         // Ophogen bij een layout wijziging: oude opgeslagen profielen worden genegeerd
+
+// Welk relais het segment naar zijn doel drijft
+enum class SegmentMode : uint8_t {
+    HEAT,  // Verwarmen tot target (aan/uit of PID), optioneel helling en vasthouden
+    COOL   // Koelen tot target
+};
+
+// Eén segment, 10 bytes. Helling en vasthouden gebruiken de PID (time-proportional verwarming),
+// ook als de PID modus zelf uit staat; zonder helling en houdtijd schakelt HEAT zoals T_top.
+struct ProfileSegment {
+    TempQ target;          // Doeltemperatuur (kwart graden)
+    uint16_t rampQPerMin;  // HEAT: setpoint helling in kwart graden per minuut (0 = direct naar target)
+    uint16_t holdSeconds;  // HEAT: target vasthouden na bereiken (max ~18 uur)
+    uint8_t mode;          // SegmentMode
+    uint8_t loopTo;        // Herhaal het blok [loopTo..dit segment] ...
+    uint16_t repeat;       // ... in totaal zoveel keer (0/1 = geen herhaling)
+};
+
+// Vaste grootte (geen heap): wordt als één blok bytes opgeslagen en door CycleController gekopieerd
+struct CycleProfile {
+    uint8_t version;
+    uint8_t count;
+    char name[PROFILE_NAME_LEN];
+    ProfileSegment segments[PROFILE_MAX_SEGMENTS];
+};
+
+// Tekstvorm voor web API en logging, segmenten gescheiden door ';':
+//   H<target>[r<°C/min>][h<seconden>][x<aantal>@<segment>]   verwarmen
+//   C<target>[x<aantal>@<segment>]                            koelen
+// Voorbeeld: "H120r5h600;C30x50@0;H200h1800" = helling 5°C/min naar 120°C, 10 min vasthouden,
+// koelen tot 30°C, die twee segmenten 50x, daarna naar 200°C en 30 min vasthouden.
+bool parseCycleProfile(const char* text, const char* name, CycleProfile& out);  // false = syntax of ongeldig
+size_t formatCycleProfile(const CycleProfile& profile, char* buffer, size_t size);
+
+// Regels: 1..PROFILE_MAX_SEGMENTS segmenten, eerste segment HEAT, helling/houdtijd alleen bij HEAT,
+// herhaalblokken niet genest of overlappend (één lusteller in CycleController).
+bool validateCycleProfile(const CycleProfile& profile);
+
+#endif // CYCLEPROFILE_H
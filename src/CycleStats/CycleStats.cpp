@@ -0,0 +1,140 @@
+#include "CycleStats.h"
+#include <math.h>
+#include <string.h>
+
+P2Quantile::P2Quantile(float p) : p(p) {
+    reset();
+}
+
+void P2Quantile::reset() {
+    for (int i = 0; i < 5; i++) {
+        q[i] = 0.0f;
+        n[i] = i;
+    }
+    np[0] = 0.0f;
+    np[1] = 2.0f * p;
+    np[2] = 4.0f * p;
+    np[3] = 2.0f + 2.0f * p;
+    np[4] = 4.0f;
+    count = 0;
+}
+
+void P2Quantile::add(float x) {
+    if (isnan(x)) return;
+    if (count < 5) {
+        // Opstart: eerste 5 waarden gesorteerd bewaren (insertion sort)
+        int i = (int)count++;
+        while (i > 0 && q[i - 1] > x) {
+            q[i] = q[i - 1];
+            i--;
+        }
+        q[i] = x;
+        return;
+    }
+    count++;
+
+    // Cel van x; de buitenste markers volgen min en max
+    int k;
+    if (x < q[0]) {
+        q[0] = x;
+        k = 0;
+    } else if (x >= q[4]) {
+        q[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (k < 3 && x >= q[k + 1]) k++;
+    }
+    for (int i = k + 1; i < 5; i++) n[i]++;
+    np[1] += p / 2.0f;
+    np[2] += p;
+    np[3] += (1.0f + p) / 2.0f;
+    np[4] += 1.0f;
+
+    // Middelste markers bijstellen als ze meer dan één positie van hun gewenste positie afliggen
+    for (int i = 1; i <= 3; i++) {
+        float d = np[i] - n[i];
+        if ((d >= 1.0f && n[i + 1] - n[i] > 1) || (d <= -1.0f && n[i - 1] - n[i] < -1)) {
+            int step = (d > 0.0f) ? 1 : -1;
+            float candidate = parabolic(i, step);
+            q[i] = (q[i - 1] < candidate && candidate < q[i + 1]) ? candidate : linear(i, step);
+            n[i] += step;
+        }
+    }
+}
+
+float P2Quantile::parabolic(int i, int d) const {
+    float span = (float)(n[i + 1] - n[i - 1]);
+    float up = (n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (float)(n[i + 1] - n[i]);
+    float down = (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (float)(n[i] - n[i - 1]);
+    return q[i] + d / span * (up + down);
+}
+
+float P2Quantile::linear(int i, int d) const {
+    return q[i] + d * (q[i + d] - q[i]) / (float)(n[i + d] - n[i]);
+}
+
+float P2Quantile::get() const {
+    if (count == 0) return NAN;
+    if (count <= 5) {
+        // Nearest rank in de gesorteerde opstart waarden; bij precies 5 staan de markers nog op hun
+        // beginpositie en is q[2] alleen de mediaan (p90/p99 zouden anders de mediaan teruggeven)
+        int rank = (int)(p * (count - 1) + 0.5f);
+        return q[rank];
+    }
+    return q[2];
+}
+
+CycleStats::CycleStats() : total(0) {
+    memset(ring, 0, sizeof(ring));
+}
+
+void CycleStats::reset() {
+    total = 0;
+    for (int i = 0; i < (int)CycleMetric::COUNT; i++) {
+        metrics[i] = MetricStats();
+    }
+}
+
+void CycleStats::addCycle(const CycleRecord& record) {
+    ring[total % CYCLE_STATS_RING] = record;
+    total++;
+
+    addValue(CycleMetric::HEAT_MS, (float)record.heatMs);
+    addValue(CycleMetric::COOL_MS, (float)record.coolMs);
+    addValue(CycleMetric::HEATER_ON_MS, (float)record.heaterOnMs);
+    // Onbekende extremen (bijv. sensorfout) tellen niet mee
+    addValue(CycleMetric::PEAK, tempFromQ(record.peak));
+    addValue(CycleMetric::TROUGH, tempFromQ(record.trough));
+    addValue(CycleMetric::OVERSHOOT, tempFromQ(record.overshoot));
+}
+
+void CycleStats::addValue(CycleMetric metric, float value) {
+    if (isnan(value)) return;
+    MetricStats& stats = metrics[(uint8_t)metric];
+    if (stats.p50.getCount() == 0 || value < stats.min) stats.min = value;
+    if (stats.p50.getCount() == 0 || value > stats.max) stats.max = value;
+    stats.p50.add(value);
+    stats.p90.add(value);
+    stats.p99.add(value);
+}
+
+const CycleRecord& CycleStats::getRecord(int age) const {
+    // Buiten bereik: oudste bewaarde cyclus (aanroeper controleert met getRecordCount())
+    if (age < 0) age = 0;
+    if (age >= getRecordCount()) age = getRecordCount() - 1;
+    if (age < 0) return ring[0];
+    return ring[(total - 1 - age) % CYCLE_STATS_RING];
+}
+
+CycleMetricSummary CycleStats::getSummary(CycleMetric metric) const {
+    const MetricStats& stats = metrics[(uint8_t)metric];
+    CycleMetricSummary summary;
+    summary.count = stats.p50.getCount();
+    summary.min = (summary.count > 0) ? stats.min : NAN;
+    summary.max = (summary.count > 0) ? stats.max : NAN;
+    summary.p50 = stats.p50.get();
+    summary.p90 = stats.p90.get();
+    summary.p99 = stats.p99.get();
+    return summary;
+}
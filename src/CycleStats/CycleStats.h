@@ -0,0 +1,94 @@
+#ifndef CYCLESTATS_H
+#define CYCLESTATS_H
+
+#include <stdint.h>
+#include "../TempSensor/TempQ.h"
+
+#ifndef CYCLE_STATS_RING
+#define CYCLE_STATS_RING 32          // Laatste cycli met alle details (24 bytes per cyclus)
+#endif
+
+// Eén volledige cyclus: opwarmen, afkoelen en de temperatuur extremen na elk schakelmoment
+struct CycleRecord {
+    uint32_t cycle;        // Cyclusnummer (cyclus_teller tijdens het opwarmen)
+    uint32_t heatMs;       // Opwarmfase (incl. vasthouden)
+    uint32_t coolMs;       // Koelfase
+    uint32_t heaterOnMs;   // Tijd dat het verwarming relais aan stond (PID: som van de aan-delen)
+    TempQ peak;            // Hoogste temperatuur na uitschakelen verwarming (TEMP_Q_INVALID = onbekend)
+    TempQ trough;          // Laagste temperatuur na uitschakelen koeling
+    TempQ overshoot;       // peak - doeltemperatuur opwarmen (negatief = doel niet gehaald)
+    int16_t reserved;
+};
+
+// Grootheden met een eigen min/max en percentielen over de hele run
+enum class CycleMetric : uint8_t {
+    HEAT_MS,
+    COOL_MS,
+    HEATER_ON_MS,
+    PEAK,       // °C
+    TROUGH,     // °C
+    OVERSHOOT,  // °C
+    COUNT
+};
+
+// P² kwantiel schatter (Jain & Chlamtac): 5 markers, O(1) geheugen en tijd per waarde.
+// Tot en met 5 waarden exact (nearest rank), daarna een schatting die naar het echte kwantiel convergeert.
+class P2Quantile {
+public:
+    explicit P2Quantile(float p = 0.5f);
+    void reset();
+    void add(float x);
+    float get() const;  // NAN zonder waarden
+    uint32_t getCount() const { return count; }
+
+private:
+    float parabolic(int i, int d) const;
+    float linear(int i, int d) const;
+
+    float p;
+    float q[5];       // Marker hoogtes
+    int32_t n[5];     // Marker posities
+    float np[5];      // Gewenste posities
+    uint32_t count;
+};
+
+struct CycleMetricSummary {
+    uint32_t count;
+    float min;
+    float max;
+    float p50;
+    float p90;
+    float p99;
+};
+
+// Cyclus statistiek: ring van de laatste CYCLE_STATS_RING cycli + per CycleMetric min/max/p50/p90/p99
+// over alle cycli sinds reset() (vaste grootte, geen heap). Puur, geen Arduino afhankelijkheden.
+class CycleStats {
+public:
+    CycleStats();
+    void reset();
+    void addCycle(const CycleRecord& record);
+
+    uint32_t getCount() const { return total; }  // Cycli sinds reset()
+    int getRecordCount() const { return (total < CYCLE_STATS_RING) ? (int)total : CYCLE_STATS_RING; }
+    const CycleRecord& getRecord(int age) const;  // 0 = laatste cyclus, age < getRecordCount()
+    CycleMetricSummary getSummary(CycleMetric metric) const;
+    float getMedian(CycleMetric metric) const { return metrics[(uint8_t)metric].p50.get(); }
+
+private:
+    struct MetricStats {
+        float min;
+        float max;
+        P2Quantile p50;
+        P2Quantile p90;
+        P2Quantile p99;
+        MetricStats() : min(0.0f), max(0.0f), p50(0.50f), p90(0.90f), p99(0.99f) {}
+    };
+    void addValue(CycleMetric metric, float value);
+
+    CycleRecord ring[CYCLE_STATS_RING];
+    uint32_t total;
+    MetricStats metrics[(uint8_t)CycleMetric::COUNT];
+};
+
+#endif // CYCLESTATS_H
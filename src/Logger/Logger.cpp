@@ -146,8 +146,8 @@ void Logger::logInternal(const LogRequest* req) {
     
     // Maak timestamp
     char timestamp[20];
-    if (req->timestamp_ms > 0 && systemClock != nullptr) {
-        systemClock->getTimestampFromMillis(req->timestamp_ms, timestamp, sizeof(timestamp));
+    if (isSetMono(req->timestamp_us) && systemClock != nullptr) {
+        systemClock->getTimestampFromMono(req->timestamp_us, timestamp, sizeof(timestamp));
     } else if (systemClock != nullptr) {
         systemClock->getTimestamp(timestamp, sizeof(timestamp));
     } else {
@@ -285,8 +285,8 @@ void Logger::sendNtfyNotification(const LogRequest* req) {
     
     // Maak timestamp string
     char timestamp[20];
-    if (req->timestamp_ms > 0 && systemClock != nullptr) {
-        systemClock->getTimestampFromMillis(req->timestamp_ms, timestamp, sizeof(timestamp));
+    if (isSetMono(req->timestamp_us) && systemClock != nullptr) {
+        systemClock->getTimestampFromMono(req->timestamp_us, timestamp, sizeof(timestamp));
     } else if (systemClock != nullptr) {
         systemClock->getTimestamp(timestamp, sizeof(timestamp));
     } else {
@@ -6,6 +6,7 @@
 #include <freertos/queue.h>
 #include <ESP_Google_Sheet_Client.h>
 #include <WiFi.h>
+#include "../SystemClock/MonoClock.h"
 
 // Forward declarations
 class SystemClock;
@@ -20,7 +21,7 @@ struct LogRequest {
     float T_bottom;
     char fase_tijd[10];
     char cyclus_tijd[10];
-    unsigned long timestamp_ms;
+    MonoUs timestamp_us;  // Starttijd van de gelogde fase (MONO_US_UNSET = huidige tijd)
 };
 
 class Logger {
@@ -0,0 +1,71 @@
+#include "PidController.h"
+
+PidController::PidController()
+    : kp(PID_DEFAULT_KP), ki(PID_DEFAULT_KI), kd(PID_DEFAULT_KD),
+      integral(0.0f), lastMeasurement(0.0f), hasLast(false), output(0.0f) {
+}
+
+void PidController::setTunings(float kp, float ki, float kd) {
+    this->kp = kp;
+    this->ki = ki;
+    this->kd = kd;
+}
+
+void PidController::reset(float integral) {
+    this->integral = isnan(integral) ? 0.0f : integral;
+    hasLast = false;
+    output = 0.0f;
+}
+
+float PidController::update(float setpoint, float measurement, float dtSeconds, float rate) {
+    float error = setpoint - measurement;
+
+    // D-term op de meting (geen kick bij setpoint sprong of helling)
+    float derivative = 0.0f;
+    if (!isnan(rate)) {
+        derivative = -rate;
+    } else if (hasLast && dtSeconds > 0.0f) {
+        derivative = -(measurement - lastMeasurement) / dtSeconds;
+    }
+    lastMeasurement = measurement;
+    hasLast = true;
+
+    float unclamped = kp * error + integral + kd * derivative;
+
+    // Anti-windup (conditionele integratie)
+    bool saturatedHigh = unclamped >= 1.0f && error > 0.0f;
+    bool saturatedLow = unclamped <= 0.0f && error < 0.0f;
+    if (!saturatedHigh && !saturatedLow && dtSeconds > 0.0f) {
+        integral += ki * error * dtSeconds;
+        if (integral > 1.0f) integral = 1.0f;
+        if (integral < 0.0f) integral = 0.0f;
+    }
+
+    output = kp * error + integral + kd * derivative;
+    if (output > 1.0f) output = 1.0f;
+    if (output < 0.0f) output = 0.0f;
+    return output;
+}
+
+TimeProportionalOutput::TimeProportionalOutput()
+    : windowMs(PID_DEFAULT_WINDOW_MS), windowStartMs(0), onMs(0) {
+}
+
+void TimeProportionalOutput::reset(uint32_t nowMs) {
+    // Volgende update() start een nieuw venster
+    windowStartMs = nowMs - windowMs;
+    onMs = 0;
+}
+
+bool TimeProportionalOutput::update(uint32_t nowMs, float duty) {
+    if (nowMs - windowStartMs >= windowMs) {
+        // Nieuw venster: duty vastzetten, te korte pulsen afronden naar 0% of 100%
+        windowStartMs = nowMs;
+        if (duty < 0.0f) duty = 0.0f;
+        if (duty > 1.0f) duty = 1.0f;
+        onMs = (uint32_t)(duty * windowMs + 0.5f);
+        if (onMs < PID_MIN_SWITCH_MS) onMs = 0;
+        if (windowMs - onMs < PID_MIN_SWITCH_MS) onMs = windowMs;
+    }
+    return (nowMs - windowStartMs) < onMs;
+}
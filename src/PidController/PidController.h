@@ -0,0 +1,81 @@
+#ifndef PIDCONTROLLER_H
+#define PIDCONTROLLER_H
+
+#include <stdint.h>
+#include <math.h>
+
+// Tuning per opstelling (opgeslagen door SettingsStore, zie PidTuning daar)
+#ifndef PID_DEFAULT_KP
+#define PID_DEFAULT_KP 0.1f       // Duty per °C fout (10°C onder setpoint = vol vermogen)
+#endif
+#ifndef PID_DEFAULT_KI
+#define PID_DEFAULT_KI 0.0005f    // Duty per °C·s
+#endif
+#ifndef PID_DEFAULT_KD
+#define PID_DEFAULT_KD 2.0f       // Duty per °C/s (op de meting, geen derivative kick bij setpoint sprong)
+#endif
+#ifndef PID_DEFAULT_WINDOW_MS
+#define PID_DEFAULT_WINDOW_MS 2000 // Periode time-proportional SSR venster
+#endif
+#ifndef PID_MIN_SWITCH_MS
+#define PID_MIN_SWITCH_MS 100      // Kortere aan/uit pulsen worden 0% / 100% (5 netperiodes bij 50Hz)
+#endif
+
+// PID modus van de verwarming, per opstelling opgeslagen door SettingsStore
+struct PidTuning {
+    bool enabled;         // false = aan/uit regeling op T_top (standaard)
+    float kp;
+    float ki;
+    float kd;
+    uint32_t windowMs;    // SSR venster (1-2 s)
+    float rampCPerMin;    // Setpoint helling vanaf start opwarmen (0 = direct T_top)
+    uint32_t holdSeconds; // Tijd op T_top voordat het koelen begint (0 = direct koelen)
+
+    PidTuning()
+        : enabled(false), kp(PID_DEFAULT_KP), ki(PID_DEFAULT_KI), kd(PID_DEFAULT_KD),
+          windowMs(PID_DEFAULT_WINDOW_MS), rampCPerMin(0.0f), holdSeconds(0) {}
+};
+
+// PID met uitgang 0..1 (duty cycle van de verwarming).
+// Anti-windup: integrator alleen bijwerken als de uitgang niet verzadigd is of de fout
+// de uitgang uit de verzadiging haalt, en de I-term begrensd tot 0..1.
+class PidController {
+public:
+    PidController();
+    void setTunings(float kp, float ki, float kd);
+    void reset(float integral = 0.0f);  // integral: I-term voorinstellen (warme herstart, zie getIntegral())
+    // rate = gemeten stijgsnelheid (°C/s, bijv. alpha-beta schatter) voor de D-term;
+    // NAN = verschil van opeenvolgende metingen (ruiziger bij kwart graad resolutie)
+    float update(float setpoint, float measurement, float dtSeconds, float rate = NAN);
+
+    float getOutput() const { return output; }
+    float getIntegral() const { return integral; }
+
+private:
+    float kp;
+    float ki;
+    float kd;
+    float integral;       // Al vermenigvuldigd met ki (tuning wijziging geeft geen sprong)
+    float lastMeasurement;
+    bool hasLast;
+    float output;
+};
+
+// Vertaalt een duty cycle naar aan/uit binnen een vast venster (SSR met nuldoorgang).
+// De duty wordt alleen aan het begin van een venster overgenomen, zodat een venster niet hakkelt.
+class TimeProportionalOutput {
+public:
+    TimeProportionalOutput();
+    void setWindow(uint32_t windowMs) { this->windowMs = windowMs > 0 ? windowMs : PID_DEFAULT_WINDOW_MS; }
+    uint32_t getWindow() const { return windowMs; }
+    void reset(uint32_t nowMs);
+    bool update(uint32_t nowMs, float duty);  // true = verwarming aan
+    bool isWindowDue(uint32_t nowMs) const { return nowMs - windowStartMs >= windowMs; }
+
+private:
+    uint32_t windowMs;
+    uint32_t windowStartMs;  // uint32 ms: verschillen blijven geldig over de wrap
+    uint32_t onMs;
+};
+
+#endif // PIDCONTROLLER_H
@@ -0,0 +1,159 @@
+#include "RelayActuator.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+
+void Esp32GpioBank::configureOutput(uint8_t pin) {
+    pinMode(pin, OUTPUT);
+}
+
+void Esp32GpioBank::write(uint32_t setMask, uint32_t clearMask) {
+    // W1TC/W1TS: de hardware zet alleen de bits uit het masker, atomair t.o.v. andere tasks en cores
+    if (clearMask != 0) REG_WRITE(GPIO_OUT_W1TC_REG, clearMask);
+    if (setMask != 0) REG_WRITE(GPIO_OUT_W1TS_REG, setMask);
+}
+
+uint32_t Esp32GpioBank::readOutputs() const {
+    return REG_READ(GPIO_OUT_REG);
+}
+#endif // ARDUINO
+
+RelayActuator::RelayActuator()
+    : bank(&defaultBank), deadTimeUs((MonoUs)RELAY_DEAD_TIME_MS * MONO_US_PER_MS),
+      mode(RelayMode::OFF), target(RelayMode::OFF), waiting(false), heaterLocked(false), deadTimeWaits(0) {
+    for (int i = 0; i < (int)RelayChannel::COUNT; i++) {
+        masks[i] = 0;
+        onSince[i] = MONO_US_UNSET;
+        offSince[i] = MONO_US_UNSET;
+    }
+    memset(stats, 0, sizeof(stats));
+}
+
+void RelayActuator::setGpioBank(GpioBank* bank) {
+    this->bank = (bank != nullptr) ? bank : &defaultBank;
+}
+
+bool RelayActuator::begin(uint8_t coolerPin, uint8_t heaterPin) {
+    if (!bank->supportsPin(coolerPin) || !bank->supportsPin(heaterPin)) {
+        return false;
+    }
+    masks[(uint8_t)RelayChannel::HEATER] = 1UL << heaterPin;
+    masks[(uint8_t)RelayChannel::COOLER] = 1UL << coolerPin;
+    // Eerst laag in het uitgangsregister, dan pas als uitgang: geen puls bij het opstarten
+    bank->write(0, masks[0] | masks[1]);
+    bank->configureOutput(heaterPin);
+    bank->configureOutput(coolerPin);
+    mode = RelayMode::OFF;
+    target = RelayMode::OFF;
+    waiting = false;
+    return true;
+}
+
+void RelayActuator::set(RelayMode mode) {
+    MonoUs now = monoNowUs();
+    reconcile(now);
+    target = mode;
+    if (mode == this->mode) {
+        waiting = false;
+        return;
+    }
+    switchOff(now);
+    tryEnable(now);
+}
+
+void RelayActuator::update() {
+    MonoUs now = monoNowUs();
+    reconcile(now);
+    if (target != mode) {
+        tryEnable(now);
+    }
+}
+
+void RelayActuator::forceOff() {
+    bank->write(0, masks[0] | masks[1]);
+}
+
+void RelayActuator::forceHeaterOff() {
+    bank->write(0, masks[(uint8_t)RelayChannel::HEATER]);
+}
+
+void RelayActuator::lockHeater() {
+    heaterLocked = true;
+    __sync_synchronize();  // Zichtbaar vóór de clear write van de aanroeper
+}
+
+bool RelayActuator::isOutputHigh(RelayChannel channel) const {
+    uint32_t mask = masks[(uint8_t)channel];
+    return mask != 0 && (bank->readOutputs() & mask) != 0;
+}
+
+RelayStats RelayActuator::getStats(RelayChannel channel) const {
+    uint8_t ch = (uint8_t)channel;
+    RelayStats result = stats[ch];
+    if (isSetMono(onSince[ch])) {
+        result.onTimeMs += monoElapsedMs(onSince[ch]);
+    }
+    return result;
+}
+
+void RelayActuator::switchOff(MonoUs now) {
+    if (mode == RelayMode::OFF) return;
+    uint8_t ch = channelFor(mode);
+    bank->write(0, masks[ch]);
+    stats[ch].onTimeMs += monoElapsedMs(onSince[ch], now);
+    onSince[ch] = MONO_US_UNSET;
+    offSince[ch] = now;
+    mode = RelayMode::OFF;
+}
+
+void RelayActuator::tryEnable(MonoUs now) {
+    if (target == RelayMode::OFF || mode != RelayMode::OFF) return;
+    if (target == RelayMode::HEAT && heaterLocked) {
+        target = RelayMode::OFF;  // Niet later alsnog inschakelen: na unlockHeater() eerst een nieuwe set()
+        waiting = false;
+        return;
+    }
+    uint8_t ch = channelFor(target);
+    uint8_t opposite = ch ^ 1;
+    // Tegengestelde relais pas net uit: wachten (de SSR geleidt tot de nuldoorgang)
+    if (isSetMono(offSince[opposite]) && now - offSince[opposite] < deadTimeUs) {
+        if (!waiting) {
+            waiting = true;
+            deadTimeWaits++;
+        }
+        return;
+    }
+    waiting = false;
+    bank->write(masks[ch], 0);
+    if (target == RelayMode::HEAT) {
+        __sync_synchronize();
+        if (heaterLocked) {
+            // Vergrendeld tussen de controle hierboven en de write: de clear van de supervisor kan al
+            // geweest zijn, dus zelf direct weer uit
+            bank->write(0, masks[ch]);
+            offSince[ch] = now;
+            target = RelayMode::OFF;
+            return;
+        }
+    }
+    onSince[ch] = now;
+    stats[ch].switchCount++;
+    mode = target;
+}
+
+void RelayActuator::reconcile(MonoUs now) {
+    // Extern uitgeschakeld (forceOff() vanuit een andere task): administratie bijwerken en niet
+    // automatisch opnieuw inschakelen, pas een nieuwe set() zet de uitgang weer aan
+    if (mode == RelayMode::OFF) return;
+    uint8_t ch = channelFor(mode);
+    if ((bank->readOutputs() & masks[ch]) != 0) return;
+    stats[ch].onTimeMs += monoElapsedMs(onSince[ch], now);
+    onSince[ch] = MONO_US_UNSET;
+    offSince[ch] = now;
+    mode = RelayMode::OFF;
+    target = RelayMode::OFF;
+    waiting = false;
+}
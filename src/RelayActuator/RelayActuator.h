@@ -0,0 +1,129 @@
+#ifndef RELAYACTUATOR_H
+#define RELAYACTUATOR_H
+
+#include <stdint.h>
+#include "../SystemClock/MonoClock.h"
+
+#ifndef RELAY_DEAD_TIME_MS
+#define RELAY_DEAD_TIME_MS 20  // Tussen verwarmen en koelen: SSR schakelt pas uit bij de volgende nuldoorgang (2x 10ms bij 50Hz)
+#endif
+
+// GPIO laag voor de relais: één bank van 32 uitgangen (GPIO0..31), set en clear als bitmaskers.
+// Een write is één register schrijfactie per masker, zonder read-modify-write: andere pinnen in de
+// bank (TFT, touch, SPI) blijven onaangeroerd en een write vanuit een andere task is veilig.
+class GpioBank {
+public:
+    virtual ~GpioBank() {}
+    virtual bool supportsPin(uint8_t pin) const = 0;
+    virtual void configureOutput(uint8_t pin) = 0;
+    virtual void write(uint32_t setMask, uint32_t clearMask) = 0;  // Eerst clear, dan set
+    virtual uint32_t readOutputs() const = 0;                      // Uitgangsregister (wat er aangestuurd wordt)
+};
+
+// Host/test bank: uitgangen in een variabele, telt de writes (geen hardware)
+class MockGpioBank : public GpioBank {
+public:
+    MockGpioBank() : outputs(0), configured(0), writes(0) {}
+    bool supportsPin(uint8_t pin) const override { return pin < 32; }
+    void configureOutput(uint8_t pin) override { configured |= (1UL << pin); }
+    void write(uint32_t setMask, uint32_t clearMask) override {
+        outputs = (outputs & ~clearMask) | setMask;
+        writes++;
+    }
+    uint32_t readOutputs() const override { return outputs; }
+
+    bool isHigh(uint8_t pin) const { return (outputs >> pin) & 1; }
+    uint32_t getConfigured() const { return configured; }
+    uint32_t getWriteCount() const { return writes; }
+
+private:
+    volatile uint32_t outputs;
+    uint32_t configured;
+    uint32_t writes;
+};
+
+#ifdef ARDUINO
+// ESP32: GPIO_OUT_W1TS / GPIO_OUT_W1TC registers (alleen GPIO0..31, de relais pinnen van de CYD)
+class Esp32GpioBank : public GpioBank {
+public:
+    bool supportsPin(uint8_t pin) const override { return pin < 32; }
+    void configureOutput(uint8_t pin) override;
+    void write(uint32_t setMask, uint32_t clearMask) override;
+    uint32_t readOutputs() const override;
+};
+#endif // ARDUINO
+
+enum class RelayMode : uint8_t {
+    OFF,
+    HEAT,  // Alleen verwarming SSR
+    COOL   // Alleen koeling SSR
+};
+
+enum class RelayChannel : uint8_t {
+    HEATER,
+    COOLER,
+    COUNT
+};
+
+// Schakelcycli en aan-tijd per relais sinds begin()
+struct RelayStats {
+    uint32_t switchCount;  // Inschakelingen (slijtage SSR / aangesloten last)
+    uint64_t onTimeMs;     // Totale aan-tijd, inclusief een lopende aan-periode
+};
+
+// Verwarming/koeling SSR paar. Nooit beide tegelijk aan: uitschakelen gaat direct (één clear write),
+// de tegengestelde modus wordt pas na de dead-time ingeschakeld (één set write, via update()).
+// Non-blocking: set() wacht nooit, een uitgestelde modus volgt bij de eerstvolgende update().
+class RelayActuator {
+public:
+    RelayActuator();
+    void setGpioBank(GpioBank* bank);  // Vóór begin() aanroepen; nullptr = ESP32 registers (host: mock bank)
+    bool begin(uint8_t coolerPin, uint8_t heaterPin);  // Beide relais uit; false = pin niet in de bank
+    void setDeadTimeMs(uint32_t ms) { deadTimeUs = (MonoUs)ms * MONO_US_PER_MS; }
+    uint32_t getDeadTimeMs() const { return (uint32_t)(deadTimeUs / MONO_US_PER_MS); }
+
+    void set(RelayMode mode);
+    void update();  // Aanroepen vanuit de regellus: uitgestelde modus na de dead-time inschakelen
+
+    // Vanuit elke task (SafetySupervisor): alleen een clear write. De administratie volgt bij de
+    // volgende set()/update(), die de modus dan ook op OFF zet (geen automatisch herinschakelen).
+    void forceOff();
+    void forceHeaterOff();
+    // Vergrendeling door de SafetySupervisor (vanuit elke task), vóór forceOff(): zolang gezet schakelt
+    // de verwarming niet in. Een set(HEAT) die gelijktijdig loopt controleert na de set write opnieuw
+    // en schakelt dan direct weer uit, zodat er geen venster is tot de volgende controle.
+    void lockHeater();
+    void unlockHeater() { heaterLocked = false; }
+    bool isHeaterLocked() const { return heaterLocked; }
+
+    RelayMode getMode() const { return mode; }          // Wat nu aangestuurd wordt
+    RelayMode getTargetMode() const { return target; }  // Gevraagd (verschilt tijdens de dead-time)
+    bool isOutputHigh(RelayChannel channel) const;      // Uitgangsregister, ook na forceOff()
+    RelayStats getStats(RelayChannel channel) const;
+    uint32_t getDeadTimeWaits() const { return deadTimeWaits; }  // Omschakelingen die op de dead-time wachtten
+
+private:
+    static uint8_t channelFor(RelayMode mode) { return (mode == RelayMode::HEAT) ? 0 : 1; }
+    void switchOff(MonoUs now);
+    void tryEnable(MonoUs now);
+    void reconcile(MonoUs now);
+
+#ifdef ARDUINO
+    Esp32GpioBank defaultBank;
+#else
+    MockGpioBank defaultBank;  // Host build (test/host): uitgangen in het geheugen
+#endif
+    GpioBank* bank;
+    uint32_t masks[(uint8_t)RelayChannel::COUNT];
+    MonoUs deadTimeUs;
+    RelayMode mode;
+    RelayMode target;
+    bool waiting;  // target wacht op de dead-time (telt één keer in deadTimeWaits)
+    volatile bool heaterLocked;
+    MonoUs onSince[(uint8_t)RelayChannel::COUNT];   // MONO_US_UNSET = uit
+    MonoUs offSince[(uint8_t)RelayChannel::COUNT];  // MONO_US_UNSET = nog nooit aan geweest
+    RelayStats stats[(uint8_t)RelayChannel::COUNT];
+    uint32_t deadTimeWaits;
+};
+
+#endif // RELAYACTUATOR_H
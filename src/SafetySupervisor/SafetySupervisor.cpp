@@ -0,0 +1,175 @@
+#include "SafetySupervisor.h"
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+
+SafetySupervisor::SafetySupervisor()
+    : sensorCount(0), relays(nullptr), taskHandle(nullptr),
+      trip(SafetyTrip::NONE), tripTemp(NAN), startUs(MONO_US_UNSET),
+      lastCheckUs(MONO_US_UNSET), heaterBucket(-1), heaterWindowSumMs(0), heaterCarryUs(0),
+      heaterWindowReset(false), tripCount(0) {
+    for (int i = 0; i < SAFETY_SUPERVISOR_MAX_SENSORS; i++) {
+        sensors[i] = nullptr;
+    }
+    memset(heaterBucketMs, 0, sizeof(heaterBucketMs));
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool SafetySupervisor::addSensor(TempSensor* sensor) {
+    if (sensor == nullptr || sensorCount >= SAFETY_SUPERVISOR_MAX_SENSORS || taskHandle != nullptr) {
+        return false;
+    }
+    sensors[sensorCount++] = sensor;
+    return true;
+}
+
+bool SafetySupervisor::begin(RelayActuator* relays, const SafetyLimits& limits, uint8_t core) {
+    if (taskHandle != nullptr) {
+        return true;
+    }
+    if (relays == nullptr) {
+        return false;
+    }
+    this->relays = relays;
+    this->limits = limits;
+    startUs = monoNowUs();  // Sensor timeout telt vanaf hier als er nog geen sample is
+
+    xTaskCreatePinnedToCore(
+        task,
+        "SafetyTask",
+        3072,   // Stack size (alleen snapshots kopiëren en GPIO)
+        this,   // Parameter (this pointer)
+        SAFETY_SUPERVISOR_PRIORITY,
+        &taskHandle,
+        core
+    );
+
+    return taskHandle != nullptr;
+}
+
+void SafetySupervisor::task(void* parameter) {
+    SafetySupervisor* supervisor = static_cast<SafetySupervisor*>(parameter);
+    if (supervisor == nullptr) {
+        return;
+    }
+
+    // Vaste periode, los van loop(): een blokkerende loop() wordt door deze task onderbroken
+    TickType_t last_wake = xTaskGetTickCount();
+    while (true) {
+        supervisor->check();
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SAFETY_SUPERVISOR_PERIOD_MS));
+    }
+}
+
+void SafetySupervisor::check() {
+    MonoUs now = monoNowUs();
+    uint32_t interval_us = 0;
+    if (isSetMono(lastCheckUs)) {
+        interval_us = (uint32_t)(now - lastCheckUs);
+        if (interval_us > stats.maxCheckIntervalUs) stats.maxCheckIntervalUs = interval_us;
+    }
+    lastCheckUs = now;
+    stats.checks++;
+
+    bool heater = relays->isOutputHigh(RelayChannel::HEATER);
+    if (heaterWindowReset) {
+        heaterWindowReset = false;
+        memset(heaterBucketMs, 0, sizeof(heaterBucketMs));
+        heaterWindowSumMs = 0;
+        heaterCarryUs = 0;
+    }
+    // Aan-tijd sinds de vorige controle (verwarming nu aan = de hele periode, de veilige kant)
+    uint32_t on_us = (heater ? interval_us : 0) + heaterCarryUs;
+    heaterCarryUs = on_us % 1000;
+    accountHeater(now, on_us / 1000);
+
+    if (trip != SafetyTrip::NONE) {
+        // Trip blijft staan: verwarming laag houden, ook als loop() het relais weer zou inschakelen
+        if (heater) relays->forceHeaterOff();
+    } else {
+        // Eigen kopie van elke sensor snapshot: hoogste temperatuur en het nieuwste geldige sample
+        float max_temp = NAN;
+        MonoUs max_temp_us = now;
+        MonoUs newest_us = startUs;
+        for (int i = 0; i < sensorCount; i++) {
+            TempSensorSnapshot snap = sensors[i]->getSnapshot();
+            if (snap.status == TempSensorStatus::NO_DATA) continue;
+            TempQ temp_q = isValidQ(snap.critical) ? snap.critical : snap.median;
+            if (isValidQ(temp_q) && (isnan(max_temp) || tempFromQ(temp_q) > max_temp)) {
+                max_temp = tempFromQ(temp_q);
+                max_temp_us = snap.timestampUs;
+            }
+            if (snap.timestampUs > newest_us) newest_us = snap.timestampUs;
+        }
+
+        if (!isnan(max_temp) && max_temp > limits.maxTempC) {
+            tripNow(SafetyTrip::OVER_TEMP, max_temp, max_temp_us);
+        } else if (heater && limits.maxHeaterOnMs > 0 && heaterWindowSumMs >= limits.maxHeaterOnMs) {
+            // Grens bereikt toen de som er precies op stond (verwarming sindsdien aan)
+            tripNow(SafetyTrip::HEATER_ON, max_temp,
+                    now - (MonoUs)(heaterWindowSumMs - limits.maxHeaterOnMs) * MONO_US_PER_MS);
+        } else if (heater && monoElapsedMs(newest_us, now) >= limits.sensorLostMs) {
+            tripNow(SafetyTrip::SENSOR_LOST, max_temp, newest_us + (MonoUs)limits.sensorLostMs * MONO_US_PER_MS);
+        }
+    }
+
+    uint32_t check_us = (uint32_t)(monoNowUs() - now);
+    if (check_us > stats.maxCheckUs) stats.maxCheckUs = check_us;
+}
+
+void SafetySupervisor::accountHeater(MonoUs now, uint32_t onMs) {
+    // Glijdend venster in vakken: oude vakken vallen eruit als de tijd een vak verder is
+    MonoUs bucket_us = (MonoUs)(limits.heaterWindowMs / SAFETY_HEATER_BUCKETS) * MONO_US_PER_MS;
+    if (bucket_us <= 0) bucket_us = MONO_US_PER_MS;
+    int64_t bucket = now / bucket_us;
+    if (heaterBucket < 0) heaterBucket = bucket;
+    int64_t steps = bucket - heaterBucket;
+    if (steps >= SAFETY_HEATER_BUCKETS) {
+        memset(heaterBucketMs, 0, sizeof(heaterBucketMs));
+        heaterWindowSumMs = 0;
+    } else {
+        for (int64_t b = heaterBucket + 1; b <= bucket; b++) {
+            uint32_t& slot = heaterBucketMs[b % SAFETY_HEATER_BUCKETS];
+            heaterWindowSumMs -= slot;
+            slot = 0;
+        }
+    }
+    heaterBucket = bucket;
+    heaterBucketMs[bucket % SAFETY_HEATER_BUCKETS] += onMs;
+    heaterWindowSumMs += onMs;
+}
+
+void SafetySupervisor::tripNow(SafetyTrip reason, float temp, MonoUs violationUs) {
+    // Eerst de vlag en de vergrendeling: een setRelays() in loop() die de trip net niet zag, schakelt
+    // de verwarming daarna niet meer in (ook niet tot de volgende controle)
+    tripTemp = temp;
+    trip = reason;
+    relays->lockHeater();
+    // Dan de pinnen, daarna pas administratie: dat telt niet mee in de reactietijd
+    relays->forceOff();  // Eén clear write: beide SSR pinnen tegelijk laag
+    MonoUs low_us = monoNowUs();
+    uint32_t reaction_us = (low_us > violationUs) ? (uint32_t)(low_us - violationUs) : 0;
+    stats.lastReactionUs = reaction_us;
+    if (reaction_us > stats.maxReactionUs) stats.maxReactionUs = reaction_us;
+
+    stats.trips++;
+    __sync_synchronize();
+    tripCount = stats.trips;  // Laatst: CycleController herkent een nieuwe trip aan de teller
+}
+
+void SafetySupervisor::clearTrip() {
+    // Bewuste START: de aan-tijd van vóór de trip telt niet meer mee
+    heaterWindowReset = true;
+    trip = SafetyTrip::NONE;
+    tripTemp = NAN;
+    if (relays != nullptr) relays->unlockHeater();
+}
+
+const char* SafetySupervisor::tripName(SafetyTrip trip) {
+    switch (trip) {
+        case SafetyTrip::OVER_TEMP:   return "Maximum temperatuur";
+        case SafetyTrip::HEATER_ON:   return "Verwarming te lang aan";
+        case SafetyTrip::SENSOR_LOST: return "Sensor weg";
+        default:                      return "Geen";
+    }
+}
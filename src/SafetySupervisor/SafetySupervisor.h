@@ -0,0 +1,122 @@
+#ifndef SAFETYSUPERVISOR_H
+#define SAFETYSUPERVISOR_H
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "../TempSensor/TempSensor.h"
+#include "../SystemClock/MonoClock.h"
+#include "../RelayActuator/RelayActuator.h"
+
+#ifndef SAFETY_MAX_TEMP_C
+#define SAFETY_MAX_TEMP_C 375.0f                 // Absolute grens, ruim boven TEMP_MAX (350°C) + overshoot
+#endif
+#ifndef SAFETY_MAX_HEATER_ON_MS
+#define SAFETY_MAX_HEATER_ON_MS (60UL * 60 * 1000) // Verwarming relais maximaal zo lang aan binnen het venster
+#endif
+#ifndef SAFETY_HEATER_WINDOW_MS
+#define SAFETY_HEATER_WINDOW_MS (75UL * 60 * 1000) // Glijdend venster: pulserend (PID/autotune) > 80% duty trip ook
+#endif
+#ifndef SAFETY_HEATER_BUCKETS
+#define SAFETY_HEATER_BUCKETS 60                   // Resolutie van het venster (75 s per vak)
+#endif
+#ifndef SAFETY_SENSOR_LOST_MS
+#define SAFETY_SENSOR_LOST_MS 10000              // Verwarming aan zonder geldig sample: sensor kwijt
+#endif
+#ifndef SAFETY_SUPERVISOR_PERIOD_MS
+#define SAFETY_SUPERVISOR_PERIOD_MS 50
+#endif
+#ifndef SAFETY_SUPERVISOR_MAX_SENSORS
+#define SAFETY_SUPERVISOR_MAX_SENSORS 3
+#endif
+#ifndef SAFETY_SUPERVISOR_CORE
+#define SAFETY_SUPERVISOR_CORE 1      // Zelfde core als loop(): onderbreekt een blokkerende loop() direct
+#endif
+#ifndef SAFETY_SUPERVISOR_PRIORITY
+#define SAFETY_SUPERVISOR_PRIORITY 5  // Boven loop() (1), LoggingTask (1) en de sensor task (3)
+#endif
+
+// Harde grenzen, los van de instellingen van de cyclus (T_top, beveiligingen in CycleController)
+struct SafetyLimits {
+    float maxTempC;
+    uint32_t maxHeaterOnMs;  // Aan-tijd binnen heaterWindowMs, 0 = niet bewaken
+    uint32_t heaterWindowMs;
+    uint32_t sensorLostMs;
+
+    SafetyLimits()
+        : maxTempC(SAFETY_MAX_TEMP_C), maxHeaterOnMs(SAFETY_MAX_HEATER_ON_MS), heaterWindowMs(SAFETY_HEATER_WINDOW_MS),
+          sensorLostMs(SAFETY_SENSOR_LOST_MS) {}
+};
+
+enum class SafetyTrip : uint8_t {
+    NONE,
+    OVER_TEMP,     // Temperatuur boven maxTempC
+    HEATER_ON,     // Verwarming binnen heaterWindowMs samen langer dan maxHeaterOnMs aan (ook pulserend)
+    SENSOR_LOST    // Verwarming aan en al sensorLostMs geen geldig sample
+};
+
+// Reactietijd: van het moment dat een grens overschreden is (sample tijdstip bij OVER_TEMP,
+// verlopen limiet bij HEATER_ON/SENSOR_LOST) tot beide SSR pinnen laag zijn.
+// Het slechtste geval is begrensd door maxCheckIntervalUs + maxCheckUs (+ sample periode bij OVER_TEMP).
+struct SafetySupervisorStats {
+    uint32_t checks;
+    uint32_t trips;
+    uint32_t maxCheckIntervalUs;  // Langste tijd tussen twee controles (task jitter)
+    uint32_t maxCheckUs;          // Langste duur van één controle
+    uint32_t lastReactionUs;
+    uint32_t maxReactionUs;
+};
+
+// Onafhankelijke bewaking in een eigen FreeRTOS task met hoge prioriteit: leest de sensor snapshots
+// (wait-free, TempSensor::getSnapshot()) en de stand van het verwarming relais en zet bij een
+// overschreden grens beide SSR pinnen laag, ongeacht of loop() / CycleController::update() loopt.
+// De trip blijft staan (verwarming vergrendeld in de RelayActuator) tot clearTrip(); CycleController meldt
+// de trip bij de eerstvolgende update() en gaat naar veiligheidskoeling.
+// Zonder TEMP_SENSOR_TASK_MODE komen de samples uit loop(): een loop() die langer dan sensorLostMs
+// blokkeert terwijl de verwarming aan staat, is dan zelf een SENSOR_LOST trip.
+class SafetySupervisor {
+public:
+    SafetySupervisor();
+    bool addSensor(TempSensor* sensor);  // Hoogste temperatuur over alle sensoren telt
+    // relays: het SSR paar van CycleController (getRelays()); uitschakelen is één clear write op de bank
+    bool begin(RelayActuator* relays, const SafetyLimits& limits = SafetyLimits(), uint8_t core = SAFETY_SUPERVISOR_CORE);
+    void setLimits(const SafetyLimits& limits) { this->limits = limits; }
+    const SafetyLimits& getLimits() const { return limits; }
+
+    bool isTripped() const { return trip != SafetyTrip::NONE; }
+    SafetyTrip getTrip() const { return trip; }
+    float getTripTemp() const { return tripTemp; }
+    uint32_t getTripCount() const { return tripCount; }  // Oplopend: nieuwe trip herkennen zonder vlag
+    void clearTrip();  // Bij START: staat de oorzaak er nog, dan volgt de volgende controle opnieuw een trip
+    uint32_t getHeaterWindowMs() const { return heaterWindowSumMs; }  // Aan-tijd in het glijdende venster
+    SafetySupervisorStats getStats() const { return stats; }  // Kopie is niet atomair (diagnostiek)
+
+    static const char* tripName(SafetyTrip trip);
+    static void task(void* parameter);
+    void check();  // Eén controle; de task roept dit elke periode aan (host harness: direct)
+
+private:
+    void tripNow(SafetyTrip reason, float temp, MonoUs violationUs);
+    void accountHeater(MonoUs now, uint32_t onMs);
+
+    TempSensor* sensors[SAFETY_SUPERVISOR_MAX_SENSORS];
+    int sensorCount;
+    SafetyLimits limits;
+    RelayActuator* relays;
+    TaskHandle_t taskHandle;
+
+    volatile SafetyTrip trip;
+    volatile float tripTemp;
+    MonoUs startUs;
+    MonoUs lastCheckUs;
+    // Aan-tijd van de verwarming per vak van heaterWindowMs / SAFETY_HEATER_BUCKETS (ring, som bijgehouden)
+    uint32_t heaterBucketMs[SAFETY_HEATER_BUCKETS];
+    int64_t heaterBucket;          // Nummer van het huidige vak sinds boot, -1 = leeg
+    volatile uint32_t heaterWindowSumMs;
+    uint32_t heaterCarryUs;        // Restant onder 1 ms tussen controles
+    volatile bool heaterWindowReset;  // clearTrip() vanuit loop(): de task leegt het venster zelf
+    volatile uint32_t tripCount;
+    SafetySupervisorStats stats;
+};
+
+#endif // SAFETYSUPERVISOR_H
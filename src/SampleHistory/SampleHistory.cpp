@@ -0,0 +1,63 @@
+#include "SampleHistory.h"
+#include <Arduino.h>
+
+SampleHistory::SampleHistory()
+    : records(nullptr), capacity(0), inPsram(false), written(0) {
+}
+
+bool SampleHistory::begin() {
+    if (records != nullptr) {
+        return true;
+    }
+
+    if (psramFound()) {
+        records = (SampleRecord*)ps_malloc(SAMPLE_HISTORY_PSRAM_RECORDS * sizeof(SampleRecord));
+        if (records != nullptr) {
+            capacity = SAMPLE_HISTORY_PSRAM_RECORDS;
+            inPsram = true;
+            return true;
+        }
+    }
+
+    // Geen PSRAM: kleinere buffer in heap
+    records = (SampleRecord*)malloc(SAMPLE_HISTORY_HEAP_RECORDS * sizeof(SampleRecord));
+    if (records == nullptr) {
+        return false;
+    }
+    capacity = SAMPLE_HISTORY_HEAP_RECORDS;
+    inPsram = false;
+    return true;
+}
+
+void SampleHistory::record(unsigned long timestampMs, TempQ raw, TempQ filtered) {
+    if (records == nullptr) return;
+
+    SampleRecord& rec = records[written % capacity];
+    rec.timestampMs = (uint32_t)timestampMs;
+    rec.raw = raw;
+    rec.filtered = filtered;
+    __sync_synchronize();  // Record volledig geschreven voordat de teller het zichtbaar maakt
+    written = written + 1;
+}
+
+uint32_t SampleHistory::getOldestSeq() const {
+    uint32_t count = written;
+    return (count > capacity) ? count - capacity : 0;
+}
+
+bool SampleHistory::getRecord(uint32_t seq, SampleRecord& out) const {
+    if (records == nullptr) return false;
+
+    uint32_t count = written;
+    if (seq >= count || count - seq > capacity) {
+        return false; // Nog niet geschreven of al overschreven
+    }
+    __sync_synchronize();
+    out = records[seq % capacity];
+    __sync_synchronize();
+
+    // Opnieuw controleren: de writer kan het slot tijdens de kopie hebben hergebruikt
+    // (marge van één record voor een schrijfactie die net bezig was)
+    count = written;
+    return count - seq < capacity;
+}
@@ -0,0 +1,56 @@
+#ifndef SAMPLEHISTORY_H
+#define SAMPLEHISTORY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../TempSensor/TempQ.h"
+
+// Capaciteit in records (8 bytes per record, zie SampleRecord)
+// PSRAM: 65536 records = 512 KB = ~5.2 uur bij 285ms sample interval
+// Zonder PSRAM (CYD/ESP32-WROOM): 2048 records = 16 KB heap = ~10 minuten
+#ifndef SAMPLE_HISTORY_PSRAM_RECORDS
+#define SAMPLE_HISTORY_PSRAM_RECORDS 65536
+#endif
+#ifndef SAMPLE_HISTORY_HEAP_RECORDS
+#define SAMPLE_HISTORY_HEAP_RECORDS 2048
+#endif
+
+// Eén acquisitie, 8 bytes, little-endian (zo ook in de binaire export):
+//   offset 0  uint32  timestampMs  ms sinds boot, uit de esp_timer tijdstempel van de read (wrap na ~49 dagen)
+//   offset 4  int16   raw          ruwe temperatuur incl. offset, TempQ (TEMP_Q_INVALID = -32768 = read fout)
+//   offset 6  int16   filtered     uitgang filter keten, TempQ (TEMP_Q_INVALID = verworpen)
+// TempQ = kwart graden, ruim genoeg voor de MAX6675 (0..1023.75°C). Zie TempQ.h.
+struct SampleRecord {
+    uint32_t timestampMs;
+    TempQ raw;
+    TempQ filtered;
+};
+
+// Ringbuffer met de volledige ~3.5 Hz sample stroom (ruw + gefilterd) voor analyse van
+// overshoot rond T_top. Eén writer (TempSensor, loop() of sensor task) en lezers op een
+// andere core (web export): records worden aangeduid met een oplopend volgnummer;
+// getRecord() geeft false als het record tijdens het lezen is overschreven.
+class SampleHistory {
+public:
+    SampleHistory();
+    bool begin();  // Alloceert in PSRAM indien aanwezig, anders een kleinere buffer in heap
+
+    void record(unsigned long timestampMs, TempQ raw, TempQ filtered);
+
+    // Volgnummers: oudste beschikbare = getOldestSeq(), volgende te schrijven = getWrittenCount()
+    uint32_t getWrittenCount() const { return written; }
+    uint32_t getOldestSeq() const;
+    bool getRecord(uint32_t seq, SampleRecord& out) const;
+
+    size_t getCapacity() const { return capacity; }
+    size_t getMemoryBytes() const { return capacity * sizeof(SampleRecord); }
+    bool isInPsram() const { return inPsram; }
+
+private:
+    SampleRecord* records;
+    size_t capacity;
+    bool inPsram;
+    volatile uint32_t written;  // Totaal aantal geschreven records (index = seq % capacity)
+};
+
+#endif // SAMPLEHISTORY_H
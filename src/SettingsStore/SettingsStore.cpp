@@ -19,6 +19,24 @@ const char* SettingsStore::PREF_KEY_NTFY_LOG_TRANSITION = "ntfy_log_transition";
 const char* SettingsStore::PREF_KEY_NTFY_LOG_SAFETY = "ntfy_log_safety";
 const char* SettingsStore::PREF_KEY_NTFY_LOG_ERROR = "ntfy_log_error";
 const char* SettingsStore::PREF_KEY_NTFY_LOG_WARNING = "ntfy_log_warning";
+const char* SettingsStore::PREF_KEY_PID_ENABLED = "pid_enabled";
+const char* SettingsStore::PREF_KEY_PID_KP = "pid_kp";
+const char* SettingsStore::PREF_KEY_PID_KI = "pid_ki";
+const char* SettingsStore::PREF_KEY_PID_KD = "pid_kd";
+const char* SettingsStore::PREF_KEY_PID_WINDOW = "pid_window";
+const char* SettingsStore::PREF_KEY_PID_RAMP = "pid_ramp";
+const char* SettingsStore::PREF_KEY_PID_HOLD = "pid_hold";
+const char* SettingsStore::PREF_KEY_PROFILE_ACTIVE = "profile_active";
+static_assert(PROFILE_SLOTS <= 4, "Extra profile_N sleutels toevoegen");
+const char* SettingsStore::PROFILE_SLOT_KEYS[PROFILE_SLOTS] = { "profile_0", "profile_1", "profile_2", "profile_3" };
+const char* SettingsStore::PREF_KEY_MODEL_VALID = "model_valid";
+const char* SettingsStore::PREF_KEY_MODEL_GAIN = "model_k";
+const char* SettingsStore::PREF_KEY_MODEL_TAU = "model_tau";
+const char* SettingsStore::PREF_KEY_MODEL_DEAD = "model_l";
+const char* SettingsStore::PREF_KEY_MODEL_KU = "model_ku";
+const char* SettingsStore::PREF_KEY_MODEL_PU = "model_pu";
+const char* SettingsStore::PREF_KEY_MODEL_AMB = "model_amb";
+const char* SettingsStore::PREF_KEY_MODEL_SP = "model_sp";
 
 bool SettingsStore::begin() {
     return true; // Preferences heeft geen expliciete begin() nodig
@@ -166,3 +184,106 @@ void SettingsStore::saveCycleCount(int cycleCount) {
     prefs.end();
 }
 
+PidTuning SettingsStore::loadPidTuning() {
+    PidTuning tuning;  // Defaults uit PidController.h
+    prefs.begin(PREF_NAMESPACE, false);
+    tuning.enabled = prefs.getBool(PREF_KEY_PID_ENABLED, tuning.enabled);
+    tuning.kp = prefs.getFloat(PREF_KEY_PID_KP, tuning.kp);
+    tuning.ki = prefs.getFloat(PREF_KEY_PID_KI, tuning.ki);
+    tuning.kd = prefs.getFloat(PREF_KEY_PID_KD, tuning.kd);
+    tuning.windowMs = prefs.getUInt(PREF_KEY_PID_WINDOW, tuning.windowMs);
+    tuning.rampCPerMin = prefs.getFloat(PREF_KEY_PID_RAMP, tuning.rampCPerMin);
+    tuning.holdSeconds = prefs.getUInt(PREF_KEY_PID_HOLD, tuning.holdSeconds);
+    prefs.end();
+    
+    // Venster buiten 0.5-10 s is geen zinnige SSR periode (bijv. corrupte waarde)
+    if (tuning.windowMs < 500 || tuning.windowMs > 10000) {
+        tuning.windowMs = PID_DEFAULT_WINDOW_MS;
+    }
+    return tuning;
+}
+
+void SettingsStore::savePidTuning(const PidTuning& tuning) {
+    prefs.begin(PREF_NAMESPACE, false);
+    prefs.putBool(PREF_KEY_PID_ENABLED, tuning.enabled);
+    prefs.putFloat(PREF_KEY_PID_KP, tuning.kp);
+    prefs.putFloat(PREF_KEY_PID_KI, tuning.ki);
+    prefs.putFloat(PREF_KEY_PID_KD, tuning.kd);
+    prefs.putUInt(PREF_KEY_PID_WINDOW, tuning.windowMs);
+    prefs.putFloat(PREF_KEY_PID_RAMP, tuning.rampCPerMin);
+    prefs.putUInt(PREF_KEY_PID_HOLD, tuning.holdSeconds);
+    prefs.end();
+}
+
+bool SettingsStore::loadProfile(int slot, CycleProfile& profile) {
+    if (slot < 0 || slot >= PROFILE_SLOTS) return false;
+    prefs.begin(PREF_NAMESPACE, false);
+    bool ok = prefs.getBytesLength(PROFILE_SLOT_KEYS[slot]) == sizeof(CycleProfile) &&
+              prefs.getBytes(PROFILE_SLOT_KEYS[slot], &profile, sizeof(CycleProfile)) == sizeof(CycleProfile);
+    prefs.end();
+    // Andere layout (PROFILE_VERSION) of corrupte data: als leeg behandelen
+    if (!ok || !validateCycleProfile(profile)) return false;
+    profile.name[PROFILE_NAME_LEN - 1] = '\0';
+    return true;
+}
+
+bool SettingsStore::saveProfile(int slot, const CycleProfile& profile) {
+    if (slot < 0 || slot >= PROFILE_SLOTS || !validateCycleProfile(profile)) return false;
+    prefs.begin(PREF_NAMESPACE, false);
+    size_t written = prefs.putBytes(PROFILE_SLOT_KEYS[slot], &profile, sizeof(CycleProfile));
+    prefs.end();
+    return written == sizeof(CycleProfile);
+}
+
+void SettingsStore::deleteProfile(int slot) {
+    if (slot < 0 || slot >= PROFILE_SLOTS) return;
+    prefs.begin(PREF_NAMESPACE, false);
+    prefs.remove(PROFILE_SLOT_KEYS[slot]);
+    prefs.end();
+}
+
+int SettingsStore::loadActiveProfile() {
+    prefs.begin(PREF_NAMESPACE, false);
+    int slot = prefs.getInt(PREF_KEY_PROFILE_ACTIVE, -1);
+    prefs.end();
+    return (slot >= 0 && slot < PROFILE_SLOTS) ? slot : -1;
+}
+
+void SettingsStore::saveActiveProfile(int slot) {
+    prefs.begin(PREF_NAMESPACE, false);
+    prefs.putInt(PREF_KEY_PROFILE_ACTIVE, (slot >= 0 && slot < PROFILE_SLOTS) ? slot : -1);
+    prefs.end();
+}
+
+PlantModel SettingsStore::loadPlantModel() {
+    PlantModel model;
+    prefs.begin(PREF_NAMESPACE, false);
+    model.valid = prefs.getBool(PREF_KEY_MODEL_VALID, false);
+    model.gainC = prefs.getFloat(PREF_KEY_MODEL_GAIN, NAN);
+    model.tauS = prefs.getFloat(PREF_KEY_MODEL_TAU, NAN);
+    model.deadTimeS = prefs.getFloat(PREF_KEY_MODEL_DEAD, NAN);
+    model.ultimateGain = prefs.getFloat(PREF_KEY_MODEL_KU, NAN);
+    model.ultimatePeriodS = prefs.getFloat(PREF_KEY_MODEL_PU, NAN);
+    model.ambientC = prefs.getFloat(PREF_KEY_MODEL_AMB, NAN);
+    model.setpointC = prefs.getFloat(PREF_KEY_MODEL_SP, NAN);
+    prefs.end();
+    
+    // Half geschreven of corrupt: als geen model behandelen
+    if (!(model.gainC > 0.0f) || !(model.tauS > 0.0f) || !(model.deadTimeS > 0.0f)) {
+        model.valid = false;
+    }
+    return model;
+}
+
+void SettingsStore::savePlantModel(const PlantModel& model) {
+    prefs.begin(PREF_NAMESPACE, false);
+    prefs.putBool(PREF_KEY_MODEL_VALID, model.valid);
+    prefs.putFloat(PREF_KEY_MODEL_GAIN, model.gainC);
+    prefs.putFloat(PREF_KEY_MODEL_TAU, model.tauS);
+    prefs.putFloat(PREF_KEY_MODEL_DEAD, model.deadTimeS);
+    prefs.putFloat(PREF_KEY_MODEL_KU, model.ultimateGain);
+    prefs.putFloat(PREF_KEY_MODEL_PU, model.ultimatePeriodS);
+    prefs.putFloat(PREF_KEY_MODEL_AMB, model.ambientC);
+    prefs.putFloat(PREF_KEY_MODEL_SP, model.setpointC);
+    prefs.end();
+}
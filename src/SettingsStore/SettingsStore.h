@@ -3,6 +3,9 @@
 
 #include <Preferences.h>
 #include "../NtfyNotifier/NtfyNotifier.h"
+#include "../PidController/PidController.h"
+#include "../CycleController/CycleProfile.h"
+#include "../AutoTune/AutoTune.h"
 
 // Forward declaration voor externe constante (gedefinieerd in hoofdprogramma)
 #ifndef TEMP_MAX
@@ -52,6 +55,21 @@ public:
     // Cyclus teller (voor persistentie bij reboot)
     int loadCycleCount();
     void saveCycleCount(int cycleCount);
+    
+    // PID tuning (per opstelling)
+    PidTuning loadPidTuning();
+    void savePidTuning(const PidTuning& tuning);
+    
+    // Ramp/soak profielen: PROFILE_SLOTS opslagplaatsen (één blok bytes per slot) + gekozen profiel
+    bool loadProfile(int slot, CycleProfile& profile);  // false = leeg, oude versie of ongeldig
+    bool saveProfile(int slot, const CycleProfile& profile);
+    void deleteProfile(int slot);
+    int loadActiveProfile();  // -1 = geen profiel (T_top/T_bottom/cyclus_max)
+    void saveActiveProfile(int slot);
+    
+    // Autotune model (per opstelling); valid = false als er nog geen autotune is gedaan
+    PlantModel loadPlantModel();
+    void savePlantModel(const PlantModel& model);
 
 private:
     Preferences prefs;
@@ -74,6 +92,23 @@ private:
     static const char* PREF_KEY_NTFY_LOG_SAFETY;
     static const char* PREF_KEY_NTFY_LOG_ERROR;
     static const char* PREF_KEY_NTFY_LOG_WARNING;
+    static const char* PREF_KEY_PID_ENABLED;
+    static const char* PREF_KEY_PID_KP;
+    static const char* PREF_KEY_PID_KI;
+    static const char* PREF_KEY_PID_KD;
+    static const char* PREF_KEY_PID_WINDOW;
+    static const char* PREF_KEY_PID_RAMP;
+    static const char* PREF_KEY_PID_HOLD;
+    static const char* PREF_KEY_PROFILE_ACTIVE;
+    static const char* PROFILE_SLOT_KEYS[PROFILE_SLOTS];
+    static const char* PREF_KEY_MODEL_VALID;
+    static const char* PREF_KEY_MODEL_GAIN;
+    static const char* PREF_KEY_MODEL_TAU;
+    static const char* PREF_KEY_MODEL_DEAD;
+    static const char* PREF_KEY_MODEL_KU;
+    static const char* PREF_KEY_MODEL_PU;
+    static const char* PREF_KEY_MODEL_AMB;
+    static const char* PREF_KEY_MODEL_SP;
 };
 
 #endif // SETTINGSSTORE_H
@@ -0,0 +1,42 @@
+#ifndef MONOCLOCK_H
+#define MONOCLOCK_H
+
+#include <stdint.h>
+#include <esp_timer.h>
+
+// Monotone tijd in microseconden sinds boot (64 bits, esp_timer): wrapt niet, in tegenstelling tot
+// millis() dat na 49,7 dagen door 0 gaat. Tijdstempels van fasen, timers en grafiekpunten gebruiken
+// dit type; MONO_US_UNSET is het expliciete "niet gestart" (0 is een geldig tijdstip).
+// Op de host levert de test/simulatie esp_timer_get_time() en kan zo door de tijd springen.
+typedef int64_t MonoUs;
+
+static const MonoUs MONO_US_UNSET = INT64_MIN;
+static const MonoUs MONO_US_PER_MS = 1000;
+
+inline MonoUs monoNowUs() {
+    return esp_timer_get_time();
+}
+
+inline bool isSetMono(MonoUs t) {
+    return t != MONO_US_UNSET;
+}
+
+// Verstreken tijd in ms sinds een tijdstip; 0 als het tijdstip niet gezet is,
+// verzadigt op UINT32_MAX (duur als uint32: fasetijden en timeouts blijven 32 bits)
+inline uint32_t monoElapsedMs(MonoUs since, MonoUs now) {
+    if (!isSetMono(since) || now <= since) return 0;
+    int64_t ms = (now - since) / MONO_US_PER_MS;
+    return (ms > (int64_t)UINT32_MAX) ? UINT32_MAX : (uint32_t)ms;
+}
+
+inline uint32_t monoElapsedMs(MonoUs since) {
+    return monoElapsedMs(since, monoNowUs());
+}
+
+// Klok voor modules die met een wrap-veilige uint32 ms teller rekenen (alleen verschillen):
+// zelfde bron als monoNowUs(), zodat alle tijden in één tijdsbasis liggen
+inline uint32_t monoMillis32() {
+    return (uint32_t)(monoNowUs() / MONO_US_PER_MS);
+}
+
+#endif // MONOCLOCK_H
@@ -2,7 +2,7 @@
 #include <time.h>
 #include <WiFi.h>
 
-SystemClock::SystemClock() : syncTimeMs(0), syncUnixTime(0) {
+SystemClock::SystemClock() : syncTimeUs(MONO_US_UNSET), syncUnixTime(0) {
 }
 
 bool SystemClock::begin(int timezoneOffset) {
@@ -20,7 +20,7 @@ void SystemClock::sync() {
         ntp_tries++;
     }
     if (getLocalTime(&timeinfo)) {
-        syncTimeMs = millis();
+        syncTimeUs = monoNowUs();
         syncUnixTime = mktime(&timeinfo);
     }
 }
@@ -43,19 +43,19 @@ void SystemClock::getTimestamp(char* buffer, size_t bufferSize) {
              timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
 }
 
-void SystemClock::getTimestampFromMillis(unsigned long timestampMs, char* buffer, size_t bufferSize) {
+void SystemClock::getTimestampFromMono(MonoUs timestampUs, char* buffer, size_t bufferSize) {
     if (buffer == nullptr || bufferSize == 0) {
         return;
     }
     
-    if (syncTimeMs == 0 || syncUnixTime == 0) {
+    if (!isSetMono(syncTimeUs) || syncUnixTime == 0) {
         // Nog niet gesynchroniseerd - gebruik huidige tijd
         getTimestamp(buffer, bufferSize);
         return;
     }
     
-    // Bereken Unix tijd voor gegeven millis() waarde
-    long long delta_seconds = (long long)(timestampMs - syncTimeMs) / 1000;
+    // Bereken Unix tijd voor gegeven monotone tijd (ook vóór de sync: negatieve delta)
+    long long delta_seconds = (timestampUs - syncTimeUs) / (MONO_US_PER_MS * 1000);
     time_t target_unix_time = syncUnixTime + delta_seconds;
     
     struct tm* timeinfo = localtime(&target_unix_time);
@@ -70,6 +70,6 @@ void SystemClock::getTimestampFromMillis(unsigned long timestampMs, char* buffer
 }
 
 bool SystemClock::isSynced() const {
-    return syncTimeMs > 0 && syncUnixTime > 0;
+    return isSetMono(syncTimeUs) && syncUnixTime > 0;
 }
 
@@ -2,6 +2,7 @@
 #define SYSTEMCLOCK_H
 
 #include <time.h>
+#include "MonoClock.h"
 
 class SystemClock {
 public:
@@ -9,11 +10,11 @@ public:
     bool begin(int timezoneOffset);
     void sync();
     void getTimestamp(char* buffer, size_t bufferSize);
-    void getTimestampFromMillis(unsigned long timestampMs, char* buffer, size_t bufferSize);
+    void getTimestampFromMono(MonoUs timestampUs, char* buffer, size_t bufferSize);
     bool isSynced() const;
 
 private:
-    unsigned long syncTimeMs;
+    MonoUs syncTimeUs;  // Monotone tijd van de laatste NTP sync (MONO_US_UNSET = nooit)
     time_t syncUnixTime;
 };
 
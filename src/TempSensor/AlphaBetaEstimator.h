@@ -0,0 +1,57 @@
+#ifndef ALPHABETAESTIMATOR_H
+#define ALPHABETAESTIMATOR_H
+
+#include <math.h>
+
+// Alpha-beta (steady-state Kalman) schatter voor temperatuur en stijgsnelheid.
+// Toestand: x = temperatuur (°C), v = dT/dt (°C/s). Per meting z met tijdstap dt:
+//   voorspel: x_p = x + v * dt
+//   residu:   r   = z - x_p
+//   correctie: x = x_p + alpha * r,  v = v + (beta / dt) * r
+// Werkt op ruwe samples, dus zonder de groepsvertraging van het mediaan venster.
+// Kritisch gedempt bij beta = alpha^2 / (2 - alpha).
+class AlphaBetaEstimator {
+public:
+    AlphaBetaEstimator(float alpha = 0.4f, float beta = 0.133f)
+        : alpha(alpha), beta(beta), x(NAN), v(0.0f) {}
+
+    void setGains(float newAlpha, float newBeta) {
+        alpha = newAlpha;
+        beta = newBeta;
+    }
+
+    void reset() {
+        x = NAN;
+        v = 0.0f;
+    }
+
+    // dtS = tijd sinds vorige meting in seconden
+    void update(float z, float dtS) {
+        if (isnan(z)) return;
+        if (isnan(x) || dtS <= 0.0f) {
+            // Eerste meting (of ongeldige tijdstap): initialiseer zonder snelheid
+            x = z;
+            v = 0.0f;
+            return;
+        }
+        float xp = x + v * dtS;
+        float r = z - xp;
+        x = xp + alpha * r;
+        v = v + (beta / dtS) * r;
+    }
+
+    bool isValid() const { return !isnan(x); }
+    float getTemperature() const { return x; }
+    float getRate() const { return isnan(x) ? NAN : v; }
+
+    // Voorspelde temperatuur over aheadS seconden (lineaire extrapolatie)
+    float predict(float aheadS) const { return isnan(x) ? NAN : x + v * aheadS; }
+
+private:
+    float alpha;
+    float beta;
+    float x;
+    float v;
+};
+
+#endif // ALPHABETAESTIMATOR_H
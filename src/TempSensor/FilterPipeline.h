@@ -0,0 +1,161 @@
+#ifndef FILTERPIPELINE_H
+#define FILTERPIPELINE_H
+
+#include <limits.h>
+#include "TempQ.h"
+#include "SlidingMedian.h"
+
+// Compile-time filter keten voor thermokoppel samples (kwart graden, zie TempQ.h).
+// Elke stage heeft:
+//   bool process(TempQ& value)  - bewerkt value in-place, false = sample verwerpen (keten stopt)
+//   void reset()                - wis interne toestand
+// Pipeline<A, B, C> roept A, B en C achter elkaar aan zonder virtual dispatch;
+// de compiler kan de hele keten inlinen. Zie TempFilterChain.h voor de gebruikte keten.
+
+// Laat alleen waarden binnen [MinC, MaxC] °C door (K-type + MAX6675: -200..1200)
+template <int MinC, int MaxC>
+class RangeGate {
+public:
+    bool process(TempQ& value) {
+        return isValidQ(value) && value > MinC * TEMP_Q_PER_DEGREE && value < MaxC * TEMP_Q_PER_DEGREE;
+    }
+    void reset() {}
+};
+
+// Mediaan over de laatste N geaccepteerde waarden (incrementeel, zie SlidingMedian)
+template <int N>
+class Median {
+public:
+    bool process(TempQ& value) {
+        window.push(value);
+        value = window.median();
+        return true;
+    }
+    void reset() { window.reset(); }
+    const SlidingMedian<N>& getWindow() const { return window; }
+
+private:
+    SlidingMedian<N> window;
+};
+
+// Hampel uitschieter filter: verwerp x als |x - mediaan| > K * 1.4826 * MAD over de laatste N ruwe waarden.
+// K in tienden (KTenths = 30 -> K = 3.0). MinMadQ is de ondergrens van de MAD in kwart graden: door de
+// 0.25°C resolutie is de MAD bij een stabiele temperatuur vaak 0 en zou elke kleine stap verworpen worden.
+// Elke waarde (ook een verworpen) gaat het venster in, zodat een echte sprong na ~N/2 samples wordt
+// geaccepteerd. Kosten per sample: één SlidingMedian push + een merge-walk van N/2 stappen voor de MAD.
+template <int N, int KTenths, int MinMadQ = 2>
+class Hampel {
+public:
+    Hampel() : rejected(0) {}
+    bool process(TempQ& value) {
+        bool accept = true;
+        if (window.size() >= (N + 1) / 2) {
+            int med = window.median();
+            int mad = medianAbsDeviation(med);
+            if (mad < MinMadQ) mad = MinMadQ;
+            int deviation = value - med;
+            if (deviation < 0) deviation = -deviation;
+            // |x - m| * 10 * 10000 > KTenths * 14826 * MAD, geheel in integers
+            accept = (int64_t)deviation * 100000 <= (int64_t)KTenths * 14826 * mad;
+        }
+        window.push(value);
+        if (!accept) rejected++;
+        return accept;
+    }
+    void reset() { window.reset(); }
+    unsigned long getRejected() const { return rejected; }
+
+private:
+    // MAD uit het gesorteerde venster: de afwijkingen links en rechts van de mediaan zijn elk al
+    // oplopend, dus samenvoegen tot de middelste afwijking volstaat (geen extra sort)
+    int medianAbsDeviation(int med) const {
+        int n = window.size();
+        int right = 0;
+        while (right < n && window.rank(right) < med) right++;
+        int left = right - 1;
+        int deviation = 0;
+        for (int k = 0; k <= n / 2; k++) {
+            int left_dev = (left >= 0) ? med - window.rank(left) : INT_MAX;
+            int right_dev = (right < n) ? window.rank(right) - med : INT_MAX;
+            if (left_dev <= right_dev) {
+                deviation = left_dev;
+                left--;
+            } else {
+                deviation = right_dev;
+                right++;
+            }
+        }
+        return deviation;
+    }
+
+    SlidingMedian<N> window;
+    unsigned long rejected;
+};
+
+// Exponentieel voortschrijdend gemiddelde met alpha = Num / Den
+// (breuk omdat float template parameters niet zijn toegestaan)
+// Toestand met 8 extra fractiebits, anders blijft de uitgang bij kleine stappen hangen
+template <int Num, int Den>
+class Ema {
+public:
+    Ema() : state(0), valid(false) {}
+    bool process(TempQ& value) {
+        int32_t scaled = (int32_t)value << 8;
+        if (!valid) {
+            state = scaled;
+            valid = true;
+        } else {
+            state += (int32_t)(((int64_t)(scaled - state) * Num) / Den);
+        }
+        value = (TempQ)((state + 128) >> 8);
+        return true;
+    }
+    void reset() { valid = false; }
+
+private:
+    int32_t state;
+    bool valid;
+};
+
+// Keten van stages. Pipeline<> is het lege einde van de recursie.
+template <typename... Stages>
+class Pipeline;
+
+template <>
+class Pipeline<> {
+public:
+    bool process(TempQ&) { return true; }
+    void reset() {}
+};
+
+template <typename First, typename... Rest>
+class Pipeline<First, Rest...> {
+public:
+    bool process(TempQ& value) {
+        return first.process(value) && rest.process(value);
+    }
+
+    void reset() {
+        first.reset();
+        rest.reset();
+    }
+
+    // Toegang tot een stage op type, bijv. chain.stage<Median<7> >().getWindow()
+    template <typename S>
+    S& stage() { return stageImpl(static_cast<S*>(nullptr)); }
+    template <typename S>
+    const S& stage() const { return stageImpl(static_cast<S*>(nullptr)); }
+
+private:
+    First& stageImpl(First*) { return first; }
+    const First& stageImpl(First*) const { return first; }
+    template <typename S>
+    S& stageImpl(S*) { return rest.template stage<S>(); }
+    template <typename S>
+    const S& stageImpl(S*) const { return rest.template stage<S>(); }
+
+    First first;
+    Pipeline<Rest...> rest;
+};
+
+#endif // FILTERPIPELINE_H
@@ -0,0 +1,43 @@
+#include "Max6675Transport.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <SPI.h>
+
+Max6675BitBangTransport::Max6675BitBangTransport(uint8_t csPin, uint8_t misoPin, uint8_t sckPin, uint16_t delayUs)
+    : device(csPin, misoPin, sckPin), delayUs(delayUs) {
+}
+
+void Max6675BitBangTransport::begin() {
+    device.begin();
+    // Delay per bit voorkomt timing problemen bij hoge CPU belasting
+    device.setSWSPIdelay(delayUs);
+}
+
+bool Max6675BitBangTransport::readFrame(uint16_t& raw) {
+    // Status van de library wordt genegeerd: decodeMax6675Frame() beoordeelt het ruwe frame zelf
+    (void)device.read();
+    raw = (uint16_t)device.getRawData();
+    return true;
+}
+
+Max6675HardwareSpiTransport::Max6675HardwareSpiTransport(SPIClass* spi, uint8_t csPin, uint32_t clockHz)
+    : spi(spi), csPin(csPin), clockHz(clockHz) {
+}
+
+void Max6675HardwareSpiTransport::begin() {
+    pinMode(csPin, OUTPUT);
+    digitalWrite(csPin, HIGH);  // CS hoog = conversie loopt
+}
+
+bool Max6675HardwareSpiTransport::readFrame(uint16_t& raw) {
+    if (spi == nullptr) return false;
+    spi->beginTransaction(SPISettings(clockHz, MSBFIRST, SPI_MODE0));
+    digitalWrite(csPin, LOW);
+    raw = spi->transfer16(0);
+    digitalWrite(csPin, HIGH);  // Start nieuwe conversie
+    spi->endTransaction();
+    return true;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,112 @@
+#ifndef MAX6675TRANSPORT_H
+#define MAX6675TRANSPORT_H
+
+#include <stdint.h>
+#include "TempQ.h"
+
+#ifndef MAX6675_SW_SPI_DELAY_US
+#define MAX6675_SW_SPI_DELAY_US 1        // Software SPI delay per bit (microseconden)
+#endif
+#ifndef MAX6675_HW_SPI_CLOCK_HZ
+#define MAX6675_HW_SPI_CLOCK_HZ 4000000  // MAX6675 max 4.3 MHz
+#endif
+
+// Resultaat van het decoderen van één 16-bit MAX6675 frame
+enum class Max6675FrameStatus : uint8_t {
+    OK,
+    OPEN_CIRCUIT,  // Bit 2: thermokoppel niet aangesloten
+    BUS_ERROR      // Geen chip (0xFFFF, MISO zwevend) of dummy sign bit 15 / device ID bit 1 gezet
+};
+
+// MAX6675 frame: bit 15 dummy sign (altijd 0), bit 14..3 temperatuur in 0.25°C,
+// bit 2 open circuit, bit 1 device ID (altijd 0), bit 0 three-state.
+// Puur (geen hardware), dus ook op de host te testen met Max6675MockTransport.
+// De 12 temperatuur bits zijn direct kwart graden (TempQ), er is geen float conversie nodig.
+inline Max6675FrameStatus decodeMax6675Frame(uint16_t raw, TempQ& quarters) {
+    if (raw == 0xFFFF || (raw & 0x8002) != 0) {
+        return Max6675FrameStatus::BUS_ERROR;
+    }
+    if (raw & 0x04) {
+        return Max6675FrameStatus::OPEN_CIRCUIT;
+    }
+    quarters = (TempQ)(raw >> 3);
+    return Max6675FrameStatus::OK;
+}
+
+// Transport laag: levert alleen het ruwe 16-bit frame, decoderen gebeurt in TempSensor.
+// Een read mag niet wachten op de conversie - dat bewaakt de aanroeper.
+class Max6675Transport {
+public:
+    virtual ~Max6675Transport() {}
+    virtual void begin() = 0;
+    virtual bool readFrame(uint16_t& raw) = 0;  // false = transport fout
+};
+
+// Host/test transport: geeft een vooraf ingesteld frame terug
+class Max6675MockTransport : public Max6675Transport {
+public:
+    Max6675MockTransport() : frame(0), busOk(true), reads(0) {}
+    // Zelfde constructor als het bit-bang transport: standaard transport van TempSensor op de host
+    Max6675MockTransport(uint8_t csPin, uint8_t misoPin, uint8_t sckPin) : Max6675MockTransport() {
+        (void)csPin; (void)misoPin; (void)sckPin;
+    }
+    void begin() override {}
+    bool readFrame(uint16_t& raw) override {
+        reads++;
+        raw = frame;
+        return busOk;
+    }
+
+    void setFrame(uint16_t newFrame) { frame = newFrame; }
+    void setCelsius(float celsius) { frame = (uint16_t)((uint16_t)(celsius * 4.0f + 0.5f) << 3); }
+    void setBusOk(bool ok) { busOk = ok; }
+    unsigned long getReads() const { return reads; }
+
+private:
+    uint16_t frame;
+    bool busOk;
+    unsigned long reads;
+};
+
+#ifdef ARDUINO
+#include <MAX6675.h>
+
+class SPIClass;
+
+// Software SPI via de Rob Tillaart library (16 klokpulsen bit-bang, ~tientallen µs CPU tijd).
+// Standaard transport: werkt op elke pin combinatie.
+class Max6675BitBangTransport : public Max6675Transport {
+public:
+    Max6675BitBangTransport(uint8_t csPin, uint8_t misoPin, uint8_t sckPin,
+                            uint16_t delayUs = MAX6675_SW_SPI_DELAY_US);
+    void begin() override;
+    bool readFrame(uint16_t& raw) override;
+
+private:
+    MAX6675 device;
+    uint16_t delayUs;
+};
+
+// Hardware SPI (HSPI/VSPI): één transfer16 van enkele µs, zonder interrupts uit te zetten.
+// Let op: op de CYD zijn HSPI (TFT) en VSPI (touch) al in gebruik; een gedeelde bus kan alleen
+// als de MAX6675 op dezelfde SCK/MISO pinnen zit als dat apparaat. spi->begin() is de taak van de sketch.
+class Max6675HardwareSpiTransport : public Max6675Transport {
+public:
+    Max6675HardwareSpiTransport(SPIClass* spi, uint8_t csPin, uint32_t clockHz = MAX6675_HW_SPI_CLOCK_HZ);
+    void begin() override;
+    bool readFrame(uint16_t& raw) override;
+
+private:
+    SPIClass* spi;
+    uint8_t csPin;
+    uint32_t clockHz;
+};
+
+// Standaard transport van TempSensor (pinnen uit de constructor)
+typedef Max6675BitBangTransport Max6675DefaultTransport;
+#else
+// Host build (test/host): geen MAX6675 library, frames komen uit de mock of een eigen transport
+typedef Max6675MockTransport Max6675DefaultTransport;
+#endif // ARDUINO
+
+#endif // MAX6675TRANSPORT_H
@@ -0,0 +1,102 @@
+#ifndef SLIDINGMEDIAN_H
+#define SLIDINGMEDIAN_H
+
+#include <string.h>
+#include "TempQ.h"
+
+// Incrementele mediaan over een schuivend venster van de laatste N waarden (kwart graden).
+// Houdt naast de circulaire array (chronologisch, voor eviction) een gesorteerde kopie bij.
+// Per push(): binary search voor de positie van de oudste en de nieuwe waarde (O(log N))
+// en één memmove over alleen het stuk tussen die twee posities - geen kopie + sort per sample.
+// mediaan() is daarna O(1). Alle vergelijkingen zijn integer.
+template <int N>
+class SlidingMedian {
+public:
+    SlidingMedian() : head(0), count(0) {}
+
+    void reset() {
+        head = 0;
+        count = 0;
+    }
+
+    // Voeg waarde toe (oudste valt af als het venster vol is). TEMP_Q_INVALID wordt genegeerd.
+    void push(TempQ value) {
+        if (!isValidQ(value)) return;
+
+        if (count < N) {
+            int pos = upperBound(value, count);
+            memmove(&sorted[pos + 1], &sorted[pos], (count - pos) * sizeof(TempQ));
+            sorted[pos] = value;
+            ring[head] = value;
+            head = (head + 1) % N;
+            count++;
+            return;
+        }
+
+        // Venster vol: vervang de oudste waarde in de gesorteerde array
+        TempQ oldest = ring[head];
+        ring[head] = value;
+        head = (head + 1) % N;
+
+        int removePos = lowerBound(oldest, N);
+        if (value >= oldest) {
+            // Schuif het deel (removePos, insertPos) één plek naar links
+            int insertPos = upperBound(value, N);
+            memmove(&sorted[removePos], &sorted[removePos + 1], (insertPos - removePos - 1) * sizeof(TempQ));
+            sorted[insertPos - 1] = value;
+        } else {
+            // Schuif het deel [insertPos, removePos) één plek naar rechts
+            int insertPos = upperBound(value, removePos);
+            memmove(&sorted[insertPos + 1], &sorted[insertPos], (removePos - insertPos) * sizeof(TempQ));
+            sorted[insertPos] = value;
+        }
+    }
+
+    // Mediaan (gemiddelde van twee middelste bij even aantal, naar beneden afgerond),
+    // TEMP_Q_INVALID bij leeg venster
+    TempQ median() const {
+        if (count == 0) return TEMP_Q_INVALID;
+        if (count % 2 == 1) return sorted[count / 2];
+        return (TempQ)(((int)sorted[count / 2 - 1] + (int)sorted[count / 2]) >> 1);
+    }
+
+    // i = 0 is de nieuwste waarde, i = size() - 1 de oudste
+    TempQ newest(int i) const {
+        return ring[(head - 1 - i + 2 * N) % N];
+    }
+
+    // Gesorteerde waarde op rang i (0 = kleinste)
+    TempQ rank(int i) const { return sorted[i]; }
+
+    int size() const { return count; }
+    bool full() const { return count == N; }
+    static int capacity() { return N; }
+
+private:
+    // Eerste index in sorted[0, n) met sorted[i] >= value
+    int lowerBound(TempQ value, int n) const {
+        int lo = 0, hi = n;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (sorted[mid] < value) lo = mid + 1; else hi = mid;
+        }
+        return lo;
+    }
+
+    // Eerste index in sorted[0, n) met sorted[i] > value
+    int upperBound(TempQ value, int n) const {
+        int lo = 0, hi = n;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (sorted[mid] <= value) lo = mid + 1; else hi = mid;
+        }
+        return lo;
+    }
+
+    TempQ ring[N];
+    TempQ sorted[N];
+    int head;   // Volgende schrijfpositie in ring
+    int count;
+};
+
+#endif // SLIDINGMEDIAN_H
@@ -0,0 +1,17 @@
+#ifndef TEMPFILTERCHAIN_H
+#define TEMPFILTERCHAIN_H
+
+#include "FilterPipeline.h"
+
+// Uitschieter stage; TempSensor telt zijn verworpen samples apart (TempSensorHealth::outliers),
+// dus deze typedef moet in de keten blijven staan.
+typedef Hampel<TEMP_HAMPEL_WINDOW, TEMP_HAMPEL_K_TENTHS> TempOutlierStage;
+
+// Filter keten waarmee TempSensor elk geldig sample verwerkt.
+// Per opstelling aan te passen door alleen deze typedef te wijzigen, bijvoorbeeld:
+//   Pipeline<RangeGate<-200, 1200>, TempOutlierStage, Median<15> >             - meer ruisonderdrukking
+//   Pipeline<RangeGate<-200, 1200>, TempOutlierStage, Median<3>, Ema<1, 4> >   - kort venster + glad
+// Let op: wijzig TEMP_MEDIAN_SAMPLES en TEMP_HAMPEL_* alleen via build flag (bepalen de class layout).
+typedef Pipeline<RangeGate<-200, 1200>, TempOutlierStage, Median<TEMP_MEDIAN_SAMPLES> > TempFilterChain;
+
+#endif // TEMPFILTERCHAIN_H
@@ -0,0 +1,36 @@
+#ifndef TEMPQ_H
+#define TEMPQ_H
+
+#include <stdint.h>
+#include <math.h>
+
+// Temperatuur in kwart graden (int16), de eigen resolutie van de MAX6675 (12 bits x 0.25°C).
+// Filtering, regeling (T_top/T_bottom vergelijkingen) en grafiek opslag werken hierop;
+// omzetten naar float gebeurt alleen bij presentatie (display, JSON, logging).
+// Bereik: -8191.75..+8191.75°C. TEMP_Q_INVALID vervangt NAN.
+typedef int16_t TempQ;
+
+static const TempQ TEMP_Q_INVALID = INT16_MIN;
+static const int TEMP_Q_PER_DEGREE = 4;
+
+// Compile-time constante uit graden (exact voor veelvouden van 0.25°C), bijv. TEMP_Q(35.0)
+#define TEMP_Q(celsius) ((TempQ)((celsius) * TEMP_Q_PER_DEGREE))
+
+inline bool isValidQ(TempQ q) {
+    return q != TEMP_Q_INVALID;
+}
+
+// Afronden naar dichtstbijzijnde kwart graad, NAN -> TEMP_Q_INVALID, verzadigt op het int16 bereik
+inline TempQ tempToQ(float celsius) {
+    if (isnan(celsius)) return TEMP_Q_INVALID;
+    float quarters = roundf(celsius * TEMP_Q_PER_DEGREE);
+    if (quarters < -32767.0f) return -32767;
+    if (quarters > 32767.0f) return 32767;
+    return (TempQ)quarters;
+}
+
+inline float tempFromQ(TempQ q) {
+    return isValidQ(q) ? (float)q / TEMP_Q_PER_DEGREE : NAN;
+}
+
+#endif // TEMPQ_H
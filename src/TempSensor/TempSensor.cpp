@@ -1,221 +1,479 @@
 #include "TempSensor.h"
+#include "../SampleHistory/SampleHistory.h"
 #include <Arduino.h>
 
 TempSensor::TempSensor(uint8_t csPin, uint8_t misoPin, uint8_t sckPin) 
-    : sensor(csPin, misoPin, sckPin), offset(0.0), lastReadTime(0), currentTemp(NAN),
-      medianTemp(NAN), lastValidTemp(NAN), sampleIndex(0),
-      sampleCount(0), lastSampleMs(0) {
+    : defaultTransport(csPin, misoPin, sckPin), transport(&defaultTransport), offset(0), lastReadTime(0), hasReadTime(false), currentTemp(TEMP_Q_INVALID),
+      medianTemp(TEMP_Q_INVALID), lastValidTemp(TEMP_Q_INVALID),
+      estimator(TEMP_ESTIMATOR_ALPHA, TEMP_ESTIMATOR_BETA), estimatorEnabled(false), sampleHistory(nullptr),
+      state(TempAcquisitionState::IDLE), nextReadDueMs(0), pendingTemp(TEMP_Q_INVALID), pendingFiltered(TEMP_Q_INVALID),
+      lastPublishMs(0), pendingSampleUs(0), lastPublishUs(0),
+      consecutiveFailures(0), failureCount(0), activeSlot(0),
+      adaptiveEnabled(false), adaptiveTop(TEMP_Q_INVALID), adaptiveBottom(TEMP_Q_INVALID),
+      sampleIntervalMs(TEMP_SAMPLE_INTERVAL_MS),
+      taskHandle(nullptr), taskPeriodMs(TEMP_SAMPLE_INTERVAL_MS), taskTimer(nullptr), nextDueUs(0),
+      lastAcquireUs(0),
+      maxSampleDurationUs(0), budgetOverruns(0) {
+    for (int i = 0; i < 2; i++) {
+        snapshotSlots[i].seq = 0;
+        snapshotSlots[i].data.current = TEMP_Q_INVALID;
+        snapshotSlots[i].data.median = TEMP_Q_INVALID;
+        snapshotSlots[i].data.lastValid = TEMP_Q_INVALID;
+        snapshotSlots[i].data.critical = TEMP_Q_INVALID;
+        snapshotSlots[i].data.estimate = NAN;
+        snapshotSlots[i].data.rate = NAN;
+        snapshotSlots[i].data.timestampMs = 0;
+        snapshotSlots[i].data.timestampUs = 0;
+        snapshotSlots[i].data.status = TempSensorStatus::NO_DATA;
+    }
+    jitterStats.periods = 0;
+    jitterStats.minPeriodUs = 0;
+    jitterStats.maxPeriodUs = 0;
+    for (int i = 0; i < TempSensorJitterStats::BUCKETS; i++) {
+        jitterStats.buckets[i] = 0;
+    }
+    health.reads = 0;
+    health.openCircuit = 0;
+    health.outOfRange = 0;
+    health.outliers = 0;
+    health.busErrors = 0;
+    health.notReady = 0;
+    health.retries = 0;
+    health.maxLatencyUs = 0;
+    for (int i = 0; i < TempSensorHealth::LATENCY_BUCKETS; i++) {
+        health.latencyBuckets[i] = 0;
+    }
+}
+
+void TempSensor::setTransport(Max6675Transport* transport) {
+    this->transport = (transport != nullptr) ? transport : &defaultTransport;
 }
 
 bool TempSensor::begin() {
-    sensor.begin();
-    return true; // MAX6675 begin() retourneert void
+    transport->begin();
+    nextReadDueMs = millis();  // Eerste read direct, ook als begin() pas na een millis() wrap komt
+    return true;
 }
 
 void TempSensor::setOffset(float offset) {
-    this->offset = offset;
-    sensor.setOffset(offset);
+    // Kwart graden: de offset wordt direct bij de ruwe chip waarde opgeteld
+    this->offset = tempToQ(offset);
 }
 
-float TempSensor::readSingle() {
+TempQ TempSensor::readSingle(unsigned long now) {
     // Respecteer conversietijd van MAX6675 (220ms typisch)
     // Voorkomt onstabiele metingen door te snelle opeenvolgende reads
-    unsigned long now = millis();
-    if (lastReadTime > 0 && (now - lastReadTime) < MAX6675_CONVERSION_TIME_MS) {
-        return NAN; // Te snel na vorige read - conversie nog niet klaar
+    // now: zelfde tijdstempel als waarmee nextReadDueMs wordt gezet, anders valt een interval van
+    // precies de conversietijd soms 1 ms te kort uit (notReady)
+    if (hasReadTime && (uint32_t)(now - lastReadTime) < MAX6675_CONVERSION_TIME_MS) {
+        health.notReady++;
+        return TEMP_Q_INVALID; // Te snel na vorige read - conversie nog niet klaar
     }
     
-    uint8_t state = sensor.read();
+    uint16_t raw = 0;
+    unsigned long start_us = micros();
+    bool busOk = transport->readFrame(raw);
+    recordLatency(micros() - start_us);
     lastReadTime = now;
+    hasReadTime = true;
+    if (!busOk) {
+        health.busErrors++;
+        return TEMP_Q_INVALID;
+    }
     
-    if (state == 0) { // STATUS_OK
-        // Controleer op open circuit (bit 2 in status)
-        // De library zet bit 2 als thermocouple open circuit is
-        uint8_t status = sensor.getStatus();
-        if (status & 0x04) {
-            // Thermocouple open circuit gedetecteerd
-            // Return NAN om aan te geven dat meting ongeldig is
-            return NAN;
-        }
-        
-        float temp = sensor.getCelsius();
-        
-        // Data validatie - controleer op onrealistische waarden
-        // K-type thermocouple bereik: -200°C tot 1200°C
-        if (temp < -200.0 || temp > 1200.0) {
-            return NAN; // Onrealistische waarde - waarschijnlijk corrupte data
+    TempQ temp = TEMP_Q_INVALID;
+    Max6675FrameStatus frame_status = decodeMax6675Frame(raw, temp);
+    if (frame_status != Max6675FrameStatus::OK) {
+        // Open circuit (bit 2) of ongeldig frame: meting ongeldig
+        if (frame_status == Max6675FrameStatus::OPEN_CIRCUIT) {
+            health.openCircuit++;
+        } else {
+            health.busErrors++;
         }
-        
-        // Pas kalibratie offset toe (wordt automatisch toegepast door library via setOffset)
-        return temp;
+        return TEMP_Q_INVALID;
     }
     
-    // STATUS_ERROR of andere fout
-    return NAN;
+    // Bereik validatie gebeurt in de filter keten (RangeGate stage)
+    // Pas kalibratie offset toe
+    return (TempQ)(temp + offset);
 }
 
 float TempSensor::read() {
-    float temp = NAN;
+    // Eén directe poging zonder retry/delay - retries lopen via de state machine in sample()
+    return tempFromQ(readSingle(millis()));
+}
+
+void TempSensor::sample() {
+    // In task mode doet de sensor task de acquisitie op vaste periode
+    if (taskHandle != nullptr) return;
+    runAcquisition(millis(), false);
+}
+
+void TempSensor::acquire() {
+    runAcquisition(millis(), true);
+}
+
+bool TempSensor::startTask(unsigned long periodMs, uint8_t core) {
+    if (taskHandle != nullptr) {
+        return true;
+    }
+    // Periode korter dan de conversietijd zou lopende conversies afbreken
+    taskPeriodMs = (periodMs < MAX6675_CONVERSION_TIME_MS) ? MAX6675_CONVERSION_TIME_MS : periodMs;
     
-    // Probeer MAX6675_READ_RETRIES keer bij tijdelijke fouten
-    for (int i = 0; i < MAX6675_READ_RETRIES; i++) {
-        temp = readSingle();
-        
-        // Als we een geldige meting hebben, return direct
-        if (!isnan(temp)) {
-            return temp;
-        }
-        
-        // Bij fout: wacht kort en probeer opnieuw (behalve laatste poging)
-        if (i < (MAX6675_READ_RETRIES - 1)) {
-            delay(MAX6675_RETRY_DELAY_MS);
+    // esp_timer (µs resolutie) wekt de task; zonder timer valt de task terug op vTaskDelayUntil
+    if (taskTimer == nullptr) {
+        esp_timer_create_args_t timer_args = {};
+        timer_args.callback = timerCallback;
+        timer_args.arg = this;
+        timer_args.dispatch_method = ESP_TIMER_TASK;
+        timer_args.name = "TempSensorTimer";
+        if (esp_timer_create(&timer_args, &taskTimer) != ESP_OK) {
+            taskTimer = nullptr;
         }
     }
     
-    // Alle retries gefaald - return NAN
-    return NAN;
+    xTaskCreatePinnedToCore(
+        task,
+        "TempSensorTask",
+        4096,   // Stack size (alleen SPI + mediaan, geen JSON/SSL)
+        this,   // Parameter (this pointer)
+        TEMP_SENSOR_TASK_PRIORITY,
+        &taskHandle,
+        core
+    );
+    
+    return taskHandle != nullptr;
 }
 
-float TempSensor::readCritical() {
-    float critical_samples[MAX6675_CRITICAL_SAMPLES];
-    int valid_count = 0;
+void TempSensor::task(void* parameter) {
+    TempSensor* sensor = static_cast<TempSensor*>(parameter);
+    if (sensor == nullptr) {
+        return;
+    }
     
-    // Doe meerdere reads met delay tussen samples
-    for (int i = 0; i < MAX6675_CRITICAL_SAMPLES; i++) {
-        float temp = read(); // Gebruik normale read met retry
+    // Absoluut schema in µs: elke read valt op nextDueUs, onafhankelijk van de duur van de acquisitie
+    // of de tick resolutie. Met adaptieve sampling volgt de periode sampleIntervalMs (nooit korter dan taskPeriodMs)
+    TickType_t last_wake = xTaskGetTickCount();
+    sensor->nextDueUs = esp_timer_get_time();
+    while (true) {
+        unsigned long period_ms = sensor->taskPeriodMs;
+        if (sensor->adaptiveEnabled && sensor->sampleIntervalMs > period_ms) {
+            period_ms = sensor->sampleIntervalMs;
+        }
         
-        if (!isnan(temp)) {
-            critical_samples[valid_count++] = temp;
+        int64_t period_us = (int64_t)period_ms * 1000;
+        int64_t now_us = esp_timer_get_time();
+        sensor->nextDueUs += period_us;
+        if (sensor->nextDueUs <= now_us) {
+            sensor->nextDueUs = now_us + period_us; // Achter op schema: niet inhalen (zou conversie afbreken)
         }
         
-        // Wacht tussen samples (behalve laatste) - gebruik yield() voor responsiviteit
-        if (i < (MAX6675_CRITICAL_SAMPLES - 1)) {
-            unsigned long delay_start = millis();
-            while (millis() - delay_start < MAX6675_CRITICAL_SAMPLE_DELAY_MS) {
-                yield(); // Feed watchdog
-                delay(1); // Korte delay om CPU niet te overbelasten
-            }
+        if (sensor->taskTimer != nullptr &&
+            esp_timer_start_once(sensor->taskTimer, (uint64_t)(sensor->nextDueUs - now_us)) == ESP_OK) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        } else {
+            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(period_ms));
         }
+        sensor->acquire();
     }
-    
-    // Als we minder dan 2 geldige samples hebben, return NAN (niet betrouwbaar)
-    // Verlaagd van 3 naar 2 voor snellere respons (met 3 samples is 2 voldoende)
-    if (valid_count < 2) {
-        return NAN;
-    }
-    
-    // Bereken mediaan van geldige samples
-    return calculateMedian(critical_samples, valid_count);
 }
 
-float TempSensor::calculateMedian(float* samples, int count) {
-    if (count == 0 || samples == nullptr) return NAN;
-    
-    // Limiteer count om stack overflow te voorkomen (max 7 voor circulaire array)
-    if (count > MEDIAN_SAMPLES) {
-        count = MEDIAN_SAMPLES;
+void TempSensor::timerCallback(void* arg) {
+    // Draait in de esp_timer task: alleen de sensor task wekken, de SPI read gebeurt daar
+    TempSensor* sensor = static_cast<TempSensor*>(arg);
+    if (sensor != nullptr && sensor->taskHandle != nullptr) {
+        xTaskNotifyGive(sensor->taskHandle);
     }
+}
+
+void TempSensor::runAcquisition(unsigned long now, bool force) {
+    unsigned long start_us = micros();
     
-    // Maak kopie van array voor sorteren
-    float sorted[MEDIAN_SAMPLES];
-    int valid_count = 0;
-    for (int i = 0; i < count; i++) {
-        if (!isnan(samples[i])) {
-            sorted[valid_count++] = samples[i];
+    // Loop de state machine door tot er gewacht moet worden (nooit delay())
+    // force = true: de task periode bewaakt de conversietijd al, IDLE hoeft niet te wachten
+    bool waiting = false;
+    while (!waiting) {
+        switch (state) {
+            case TempAcquisitionState::IDLE:
+                // Wacht op volgende conversie (niet blokkerend: direct terug naar loop())
+                if (!force && (int32_t)(now - nextReadDueMs) < 0) {
+                    waiting = true;
+                } else {
+                    state = TempAcquisitionState::ACQUIRE;
+                }
+                break;
+                
+            case TempAcquisitionState::ACQUIRE:
+                pendingSampleUs = esp_timer_get_time();
+                recordPeriod(pendingSampleUs);
+                pendingTemp = readSingle(now);
+                state = TempAcquisitionState::VALIDATE;
+                break;
+                
+            case TempAcquisitionState::VALIDATE:
+                pendingFiltered = pendingTemp;
+                if (isValidQ(pendingTemp) && filter.process(pendingFiltered)) {
+                    if (sampleHistory != nullptr) {
+                        sampleHistory->record((unsigned long)(pendingSampleUs / 1000), pendingTemp, pendingFiltered);
+                    }
+                    consecutiveFailures = 0;
+                    state = TempAcquisitionState::PUBLISH;
+                } else {
+                    failureCount++;
+                    if (sampleHistory != nullptr) {
+                        sampleHistory->record((unsigned long)(pendingSampleUs / 1000), pendingTemp, TEMP_Q_INVALID);
+                    }
+                    if (isValidQ(pendingTemp)) {
+                        // Read was geldig, filter keten verwierp de waarde: uitschieter of buiten bereik
+                        unsigned long outliers = filter.stage<TempOutlierStage>().getRejected();
+                        if (outliers != health.outliers) {
+                            health.outliers = outliers;
+                        } else {
+                            health.outOfRange++;
+                        }
+                    }
+                    // Fout: probeer opnieuw zodra de volgende conversie klaar is
+                    // (eerder lezen breekt de lopende conversie af, dus geen korte retry delay)
+                    if (consecutiveFailures < MAX6675_READ_RETRIES) {
+                        consecutiveFailures++;
+                        health.retries++;
+                        nextReadDueMs = now + MAX6675_CONVERSION_TIME_MS;
+                    } else {
+                        nextReadDueMs = now + sampleIntervalMs;
+                    }
+                    publishSnapshot(criticalWindow.size() > 0 ? TempSensorStatus::READ_ERROR : TempSensorStatus::NO_DATA);
+                    state = TempAcquisitionState::IDLE;
+                    waiting = true;
+                }
+                break;
+                
+            case TempAcquisitionState::PUBLISH:
+                publish(pendingTemp, pendingFiltered, now, pendingSampleUs);
+                publishSnapshot(TempSensorStatus::OK);
+                // Volgende read: periode hangt af van de afstand tot de drempels (na estimator update)
+                sampleIntervalMs = computeIntervalMs();
+                nextReadDueMs = now + sampleIntervalMs;
+                state = TempAcquisitionState::IDLE;
+                waiting = true;
+                break;
         }
     }
     
-    if (valid_count == 0) return NAN;
-    if (valid_count == 1) return sorted[0];
-    
-    // Insertion sort (efficiënt voor kleine arrays ≤7)
-    for (int i = 1; i < valid_count; i++) {
-        float key = sorted[i];
-        int j = i - 1;
-        while (j >= 0 && sorted[j] > key) {
-            sorted[j + 1] = sorted[j];
-            j--;
-        }
-        sorted[j + 1] = key;
+    // Budget bewaking: sample() mag de loop() nooit langer dan TEMP_SAMPLE_BUDGET_US ophouden
+    unsigned long duration_us = micros() - start_us;
+    if (duration_us > maxSampleDurationUs) {
+        maxSampleDurationUs = duration_us;
     }
-    
-    // Mediaan is middelste waarde (of gemiddelde van twee middelste bij even aantal)
-    if (valid_count % 2 == 1) {
-        return sorted[valid_count / 2];
-    } else {
-        return (sorted[valid_count / 2 - 1] + sorted[valid_count / 2]) / 2.0;
+    if (duration_us > TEMP_SAMPLE_BUDGET_US) {
+        budgetOverruns++;
     }
 }
 
-void TempSensor::sample() {
-    unsigned long now = millis();
-    if (now - lastSampleMs < TEMP_SAMPLE_INTERVAL_MS) return;
-    lastSampleMs = now;
-    
-    float t = read();
-    if (!isnan(t) && t > -200 && t < 1200) { // sanity window for K-type + MAX6675
-        // Voeg nieuwe waarde toe aan circulaire array (oudste valt automatisch af)
-        samples[sampleIndex] = t;
-        sampleIndex = (sampleIndex + 1) % MEDIAN_SAMPLES;
-        
-        // Update aantal geldige metingen (max 7)
-        if (sampleCount < MEDIAN_SAMPLES) {
-            sampleCount++;
+void TempSensor::recordPeriod(int64_t nowUs) {
+    if (lastAcquireUs != 0) {
+        unsigned long period_us = (unsigned long)(nowUs - lastAcquireUs);
+        unsigned long nominal_ms = (taskHandle != nullptr) ? taskPeriodMs : TEMP_SAMPLE_INTERVAL_MS;
+        if (adaptiveEnabled) {
+            nominal_ms = sampleIntervalMs; // Geplande periode van deze acquisitie
         }
+        unsigned long nominal_us = nominal_ms * 1000UL;
+        unsigned long deviation_ms = ((period_us > nominal_us) ? (period_us - nominal_us) : (nominal_us - period_us)) / 1000UL;
         
-        // Kopieer waarden uit circulaire array in chronologische volgorde (oudste eerst)
-        // Dit is nodig omdat de circulaire array wrapt en de volgorde niet chronologisch is
-        float chrono_samples[MEDIAN_SAMPLES];
-        int count_to_use = (sampleCount >= MEDIAN_SAMPLES) ? MEDIAN_SAMPLES : sampleCount;
-        
-        // sampleIndex wijst naar de volgende positie (waar de volgende meting komt)
-        // We moeten de laatste count_to_use metingen pakken in chronologische volgorde
-        for (int i = 0; i < count_to_use; i++) {
-            // Start vanaf de oudste meting en werk vooruit
-            // Bij circulaire buffer: als index 3 is en count 7, dan zijn de metingen op posities:
-            // (3-7+7)%7=3, (3-6+7)%7=4, (3-5+7)%7=5, (3-4+7)%7=6, (3-3+7)%7=0, (3-2+7)%7=1, (3-1+7)%7=2
-            int idx = (sampleIndex - count_to_use + i + MEDIAN_SAMPLES) % MEDIAN_SAMPLES;
-            chrono_samples[i] = samples[idx];
+        static const unsigned long bucket_limits_ms[TempSensorJitterStats::BUCKETS - 1] = { 1, 2, 5, 10, 20, 50 };
+        int bucket = TempSensorJitterStats::BUCKETS - 1;
+        for (int i = 0; i < TempSensorJitterStats::BUCKETS - 1; i++) {
+            if (deviation_ms < bucket_limits_ms[i]) {
+                bucket = i;
+                break;
+            }
         }
+        jitterStats.buckets[bucket]++;
         
-        // Bereken mediaan van de waarden in chronologische volgorde
-        if (count_to_use >= MEDIAN_SAMPLES) {
-            // Array is vol - bereken mediaan van alle 7 waarden
-            medianTemp = calculateMedian(chrono_samples, MEDIAN_SAMPLES);
-        } else if (count_to_use >= 2) {
-            // Minimaal 2 waarden nodig voor mediaan
-            medianTemp = calculateMedian(chrono_samples, count_to_use);
-        } else {
-            // Nog niet genoeg waarden - gebruik laatste meting
-            medianTemp = t;
+        if (jitterStats.periods == 0 || period_us < jitterStats.minPeriodUs) {
+            jitterStats.minPeriodUs = period_us;
+        }
+        if (period_us > jitterStats.maxPeriodUs) {
+            jitterStats.maxPeriodUs = period_us;
+        }
+        jitterStats.periods++;
+    }
+    lastAcquireUs = nowUs;
+}
+
+void TempSensor::recordLatency(unsigned long latencyUs) {
+    static const unsigned long bucket_limits_us[TempSensorHealth::LATENCY_BUCKETS - 1] = { 10, 20, 50, 100, 200, 500, 1000 };
+    int bucket = TempSensorHealth::LATENCY_BUCKETS - 1;
+    for (int i = 0; i < TempSensorHealth::LATENCY_BUCKETS - 1; i++) {
+        if (latencyUs < bucket_limits_us[i]) {
+            bucket = i;
+            break;
+        }
+    }
+    health.latencyBuckets[bucket]++;
+    if (latencyUs > health.maxLatencyUs) {
+        health.maxLatencyUs = latencyUs;
+    }
+    health.reads++;
+}
+
+void TempSensor::publish(TempQ raw, TempQ filtered, unsigned long now, int64_t sampleUs) {
+    if (estimatorEnabled) {
+        // Schatter op ruwe waarde (geen mediaan vertraging), dt uit de µs tijdstempels van de reads
+        int64_t dt_us = sampleUs - lastPublishUs;
+        if (lastPublishUs == 0 || dt_us > (int64_t)TEMP_ESTIMATOR_MAX_GAP_MS * 1000) {
+            estimator.reset();
+        }
+        estimator.update(tempFromQ(raw), dt_us / 1000000.0f);
+    }
+    lastPublishMs = now;
+    lastPublishUs = sampleUs;
+    
+    // Ruwe waarde voor kritieke metingen (mediaan van laatste MAX6675_CRITICAL_SAMPLES)
+    criticalWindow.push(raw);
+    medianTemp = filtered;
+    
+    // Update huidige temperatuur en laatste geldige waarde
+    currentTemp = medianTemp; // Gebruik gefilterde waarde als huidige waarde
+    lastValidTemp = medianTemp; // Bewaar voor display bij fouten
+}
+
+void TempSensor::publishSnapshot(TempSensorStatus status) {
+    TempSensorSnapshot snap;
+    snap.current = currentTemp;
+    snap.median = medianTemp;
+    snap.lastValid = lastValidTemp;
+    snap.critical = (criticalWindow.size() >= 2) ? criticalWindow.median() : TEMP_Q_INVALID;
+    snap.estimate = estimatorEnabled ? estimator.getTemperature() : NAN;
+    snap.rate = estimatorEnabled ? estimator.getRate() : NAN;
+    snap.timestampMs = lastPublishMs;
+    snap.timestampUs = lastPublishUs;
+    snap.status = status;
+    
+    // Schrijf in het inactieve slot en maak het daarna actief (single writer)
+    uint8_t next = activeSlot ^ 1;
+    SnapshotSlot& slot = snapshotSlots[next];
+    slot.seq = slot.seq + 1;  // Oneven: schrijven bezig
+    __sync_synchronize();
+    slot.data = snap;
+    __sync_synchronize();
+    slot.seq = slot.seq + 1;  // Even: consistent
+    __sync_synchronize();
+    activeSlot = next;
+}
+
+TempSensorSnapshot TempSensor::getSnapshot() const {
+    TempSensorSnapshot snap;
+    while (true) {
+        const SnapshotSlot& slot = snapshotSlots[activeSlot];
+        uint32_t seq_before = slot.seq;
+        __sync_synchronize();
+        snap = slot.data;
+        __sync_synchronize();
+        // Alleen opnieuw als de writer dit slot tijdens de kopie heeft overschreven
+        if ((seq_before & 1) == 0 && slot.seq == seq_before) {
+            return snap;
         }
-        
-        // Update huidige temperatuur en laatste geldige waarde
-        currentTemp = medianTemp; // Gebruik mediaan als huidige waarde
-        lastValidTemp = medianTemp; // Bewaar voor display bij fouten
     }
 }
 
 float TempSensor::getCurrent() const {
-    return currentTemp;
+    return tempFromQ(getSnapshot().current);
 }
 
 float TempSensor::getMedian() const {
+    return tempFromQ(getMedianQ());
+}
+
+float TempSensor::getCritical() const {
+    return tempFromQ(getCriticalQ());
+}
+
+TempQ TempSensor::getMedianQ() const {
     // Gebruik de al berekende mediaan (wordt elke 285ms bijgewerkt in sample())
-    if (!isnan(medianTemp)) {
-        return medianTemp;
+    TempSensorSnapshot snap = getSnapshot();
+    if (isValidQ(snap.median)) {
+        return snap.median;
     }
     
     // Fallback: gebruik laatste meting als mediaan nog niet beschikbaar is
-    return currentTemp;
+    return snap.current;
 }
 
-float TempSensor::getCritical() {
-    // Gebruik readCritical() voor majority voting bij kritieke metingen
-    return readCritical();
+TempQ TempSensor::getCriticalQ() const {
+    // Geen extra reads: de kritieke mediaan is al bij publicatie berekend
+    TempSensorSnapshot snap = getSnapshot();
+    if (snap.status == TempSensorStatus::NO_DATA || (uint32_t)(millis() - snap.timestampMs) > criticalMaxAgeMs()) {
+        return TEMP_Q_INVALID; // Te weinig of te oude samples - caller valt terug op getMedianQ()
+    }
+    return snap.critical;
 }
 
-float TempSensor::getLastValid() const {
-    return lastValidTemp;
+void TempSensor::setAdaptiveTargets(float top, float bottom) {
+    adaptiveTop = tempToQ(top);
+    adaptiveBottom = tempToQ(bottom);
 }
 
+void TempSensor::clearAdaptiveTargets() {
+    adaptiveTop = TEMP_Q_INVALID;
+    adaptiveBottom = TEMP_Q_INVALID;
+}
+
+unsigned long TempSensor::computeIntervalMs() const {
+    TempQ top = adaptiveTop;
+    TempQ bottom = adaptiveBottom;
+    if (!adaptiveEnabled || (!isValidQ(top) && !isValidQ(bottom)) || !isValidQ(medianTemp)) {
+        return TEMP_SAMPLE_INTERVAL_MS;
+    }
+    
+    // Kleinste afstand tot een drempel, nu en (met schatter) over één langzame periode:
+    // bij een snelle flank wordt dus al versneld voordat de drempel binnen NEAR ligt
+    TempQ candidates[2] = { medianTemp, TEMP_Q_INVALID };
+    if (estimatorEnabled && estimator.isValid()) {
+        candidates[1] = tempToQ(estimator.predict(TEMP_ADAPTIVE_SLOW_MS / 1000.0f));
+    }
+    int distance = INT_MAX;
+    for (int i = 0; i < 2; i++) {
+        if (!isValidQ(candidates[i])) continue;
+        if (isValidQ(top)) {
+            int d = abs((int)candidates[i] - (int)top);
+            if (d < distance) distance = d;
+        }
+        if (isValidQ(bottom)) {
+            int d = abs((int)candidates[i] - (int)bottom);
+            if (d < distance) distance = d;
+        }
+    }
+    
+    const int near_q = TEMP_ADAPTIVE_NEAR_C * TEMP_Q_PER_DEGREE;
+    const int far_q = TEMP_ADAPTIVE_FAR_C * TEMP_Q_PER_DEGREE;
+    if (distance <= near_q) return MAX6675_CONVERSION_TIME_MS;
+    if (distance >= far_q) return TEMP_ADAPTIVE_SLOW_MS;
+    // Lineair tussen maximale en langzame rate
+    return MAX6675_CONVERSION_TIME_MS +
+           (unsigned long)(TEMP_ADAPTIVE_SLOW_MS - MAX6675_CONVERSION_TIME_MS) * (distance - near_q) / (far_q - near_q);
+}
+
+unsigned long TempSensor::criticalMaxAgeMs() const {
+    // Bij een langzame adaptieve periode schuift de leeftijdsgrens mee (3 perioden)
+    unsigned long adaptive_age_ms = 3 * sampleIntervalMs;
+    return (adaptive_age_ms > MAX6675_CRITICAL_MAX_AGE_MS) ? adaptive_age_ms : MAX6675_CRITICAL_MAX_AGE_MS;
+}
+
+void TempSensor::setEstimatorEnabled(bool enabled) {
+    if (enabled && !estimatorEnabled) {
+        estimator.reset();
+    }
+    estimatorEnabled = enabled;
+}
+
+float TempSensor::getEstimate() const {
+    return getSnapshot().estimate;
+}
+
+float TempSensor::getRate() const {
+    return getSnapshot().rate;
+}
+
+float TempSensor::getLastValid() const {
+    return tempFromQ(getSnapshot().lastValid);
+}
@@ -1,8 +1,10 @@
 #ifndef TEMPSENSOR_H
 #define TEMPSENSOR_H
 
-#include <MAX6675.h>
 #include <math.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
 
 // Forward declarations voor externe constanten
 #ifndef MAX6675_CONVERSION_TIME_MS
@@ -11,48 +13,238 @@
 #ifndef MAX6675_READ_RETRIES
 #define MAX6675_READ_RETRIES 3
 #endif
-#ifndef MAX6675_RETRY_DELAY_MS
-#define MAX6675_RETRY_DELAY_MS 10
-#endif
 #ifndef MAX6675_CRITICAL_SAMPLES
 #define MAX6675_CRITICAL_SAMPLES 3
 #endif
-#ifndef MAX6675_CRITICAL_SAMPLE_DELAY_MS
-#define MAX6675_CRITICAL_SAMPLE_DELAY_MS 30
+#ifndef MAX6675_CRITICAL_MAX_AGE_MS
+#define MAX6675_CRITICAL_MAX_AGE_MS (3 * TEMP_SAMPLE_INTERVAL_MS) // Ouder = niet meer kritiek bruikbaar
 #endif
 #ifndef TEMP_SAMPLE_INTERVAL_MS
 #define TEMP_SAMPLE_INTERVAL_MS 285
 #endif
+#ifndef TEMP_SAMPLE_BUDGET_US
+#define TEMP_SAMPLE_BUDGET_US 2000 // Maximale tijd die één sample() aanroep mag kosten
+#endif
+// Mediaan venster grootte (gebruikt door TempFilterChain). Bepaalt de class layout: wijzig via build flag (-D) zodat
+// de sketch en TempSensor.cpp dezelfde waarde zien, niet met een #define in de sketch.
+#ifndef TEMP_MEDIAN_SAMPLES
+#define TEMP_MEDIAN_SAMPLES 5   // Klein venster (minder vertraging): uitschieters vangt de Hampel stage al af
+#endif
+// Hampel uitschieter stage vóór de mediaan (zelfde regel: layout bepalend, alleen via build flag wijzigen)
+#ifndef TEMP_HAMPEL_WINDOW
+#define TEMP_HAMPEL_WINDOW 7
+#endif
+#ifndef TEMP_HAMPEL_K_TENTHS
+#define TEMP_HAMPEL_K_TENTHS 30  // Drempel K = 3.0 (x 1.4826 x MAD)
+#endif
+#include "TempFilterChain.h"
+#include "AlphaBetaEstimator.h"
+#include "Max6675Transport.h"
+
+class SampleHistory;
+
+// Alpha-beta schatter (optioneel, zie setEstimatorEnabled())
+#ifndef TEMP_ESTIMATOR_ALPHA
+#define TEMP_ESTIMATOR_ALPHA 0.4f
+#endif
+#ifndef TEMP_ESTIMATOR_BETA
+#define TEMP_ESTIMATOR_BETA 0.133f      // Kritisch gedempt: alpha^2 / (2 - alpha)
+#endif
+#ifndef TEMP_ESTIMATOR_MAX_GAP_MS
+#define TEMP_ESTIMATOR_MAX_GAP_MS 2000  // Langer zonder geldig sample = schatter opnieuw starten
+#endif
+
+// Adaptieve sample rate (optioneel, zie setAdaptiveSampling())
+// Ver van T_top/T_bottom: TEMP_ADAPTIVE_SLOW_MS, dichtbij: elke conversie (MAX6675_CONVERSION_TIME_MS)
+#ifndef TEMP_ADAPTIVE_SLOW_MS
+#define TEMP_ADAPTIVE_SLOW_MS 1000
+#endif
+#ifndef TEMP_ADAPTIVE_NEAR_C
+#define TEMP_ADAPTIVE_NEAR_C 5   // Binnen deze afstand (°C) tot een drempel: maximale rate
+#endif
+#ifndef TEMP_ADAPTIVE_FAR_C
+#define TEMP_ADAPTIVE_FAR_C 30   // Vanaf deze afstand: langzame rate (daartussen lineair)
+#endif
+
+#ifndef TEMP_SENSOR_TASK_CORE
+#define TEMP_SENSOR_TASK_CORE 0      // Sensor task op Core 0 (Core 1 = loop() + LoggingTask)
+#endif
+#ifndef TEMP_SENSOR_TASK_PRIORITY
+#define TEMP_SENSOR_TASK_PRIORITY 3  // Boven loop() en LoggingTask (prioriteit 1)
+#endif
+
+// Acquisitie state machine (wordt gedreven door sample() of de sensor task, slaapt nooit)
+// IDLE:     wacht tot conversie klaar is (MAX6675 heeft ~220ms nodig na CS hoog)
+// ACQUIRE:  CS laag + 16 bits inklokken via het transport (bit-bang: tientallen µs, hardware SPI: enkele µs)
+// VALIDATE: open circuit controle + filter keten (TempFilterChain: bereik, mediaan, ...)
+// PUBLISH:  gefilterde waarde en kritieke samples bijwerken
+enum class TempAcquisitionState : uint8_t {
+    IDLE,
+    ACQUIRE,
+    VALIDATE,
+    PUBLISH
+};
+
+enum class TempSensorStatus : uint8_t {
+    NO_DATA,     // Nog geen geldige meting
+    OK,          // Laatste acquisitie geldig
+    READ_ERROR   // Laatste acquisitie ongeldig (waarden = laatste geldige)
+};
+
+// Snapshot van de gepubliceerde sensorwaarden (wordt als geheel gekopieerd door lezers)
+// Temperaturen in kwart graden (TempQ), float alleen voor de schatter uitgangen
+struct TempSensorSnapshot {
+    TempQ current;
+    TempQ median;
+    TempQ lastValid;
+    TempQ critical;             // Mediaan van laatste MAX6675_CRITICAL_SAMPLES ruwe samples
+    float estimate;             // Alpha-beta temperatuur (NAN als schatter uit staat)
+    float rate;                 // Alpha-beta dT/dt in °C/s (NAN als schatter uit staat)
+    unsigned long timestampMs;  // millis() van laatste geldige sample
+    int64_t timestampUs;        // esp_timer_get_time() op het moment van de read (µs sinds boot)
+    TempSensorStatus status;
+};
+
+// Verdeling van de gerealiseerde sample periode (afwijking t.o.v. nominale periode)
+struct TempSensorJitterStats {
+    static const int BUCKETS = 7;  // |afwijking| <1, <2, <5, <10, <20, <50, >=50 ms
+    unsigned long periods;
+    unsigned long minPeriodUs;
+    unsigned long maxPeriodUs;
+    unsigned long buckets[BUCKETS];
+};
+
+// Sensor gezondheid: fouten per oorzaak + verdeling van de read duur (transport transactie)
+struct TempSensorHealth {
+    static const int LATENCY_BUCKETS = 8;  // <10, <20, <50, <100, <200, <500, <1000, >=1000 µs
+    unsigned long reads;           // Uitgevoerde transport reads
+    unsigned long openCircuit;     // Bit 2 gezet (thermokoppel los)
+    unsigned long outOfRange;      // Verworpen door de filter keten buiten de Hampel stage (RangeGate)
+    unsigned long outliers;        // Verworpen door de Hampel stage (TempOutlierStage)
+    unsigned long busErrors;       // Transport fout of ongeldig frame (0xFFFF, bit 15/1)
+    unsigned long notReady;        // Read geweigerd: conversie nog niet klaar
+    unsigned long retries;         // Ingeplande snelle retries na een fout
+    unsigned long maxLatencyUs;
+    unsigned long latencyBuckets[LATENCY_BUCKETS];
+};
 
 class TempSensor {
 public:
     TempSensor(uint8_t csPin, uint8_t misoPin, uint8_t sckPin);
+    void setTransport(Max6675Transport* transport);  // Vóór begin() aanroepen; nullptr = software SPI op de pinnen uit de constructor (host: mock)
     bool begin();
-    void setOffset(float offset);
-    void sample();  // Aanroepen vanuit loop()
+    void setOffset(float offset);  // Afgerond op 0.25°C (resolutie van de MAX6675)
+    void sample();  // Aanroepen vanuit loop() - non-blocking, no-op in task mode
+    void acquire(); // Directe acquisitie; caller bewaakt de conversietijd (task / TempSensorArray)
+    bool startTask(unsigned long periodMs = TEMP_SAMPLE_INTERVAL_MS, uint8_t core = TEMP_SENSOR_TASK_CORE);
+    bool isTaskMode() const { return taskHandle != nullptr; }
+    static void task(void* parameter);
+    static void timerCallback(void* arg);
+    void setSampleHistory(SampleHistory* history) { sampleHistory = history; }  // Elke acquisitie (ruw + gefilterd) vastleggen
+    
+    // Wait-free getters (lezen de gepubliceerde snapshot, veilig vanaf elke core)
+    TempSensorSnapshot getSnapshot() const;
     float getCurrent() const;
     float getMedian() const;
-    float getCritical();  // Majority voting (niet const omdat readCritical() wordt aangeroepen)
+    float getCritical() const;  // Mediaan van laatste ruwe samples (geen extra reads)
     float getLastValid() const;
-    float read();  // Public voor backward compatibility (gebruikt in warm-up)
+    float read();  // Eén directe read zonder wachten (gebruikt in warm-up)
+    
+    // Zelfde waarden in kwart graden voor regeling (TEMP_Q_INVALID i.p.v. NAN)
+    TempQ getMedianQ() const;
+    TempQ getCriticalQ() const;
+    
+    // Adaptieve sample rate: sneller naarmate de (voorspelde) temperatuur een drempel nadert.
+    // Drempels komen van CycleController; zonder drempels geldt TEMP_SAMPLE_INTERVAL_MS.
+    void setAdaptiveSampling(bool enabled) { adaptiveEnabled = enabled; }
+    bool isAdaptiveSampling() const { return adaptiveEnabled; }
+    void setAdaptiveTargets(float top, float bottom);
+    void clearAdaptiveTargets();
+    unsigned long getSampleIntervalMs() const { return sampleIntervalMs; }
+    
+    // Optionele toestandsschatter: temperatuur + stijgsnelheid met minder vertraging dan de mediaan
+    void setEstimatorEnabled(bool enabled);
+    bool isEstimatorEnabled() const { return estimatorEnabled; }
+    float getEstimate() const;  // °C
+    float getRate() const;      // °C/s
+    
+    // Jitter statistiek van de gerealiseerde sample periode (diagnostiek, kopie is niet atomair)
+    TempSensorJitterStats getJitterStats() const { return jitterStats; }
+
+    // Timing diagnostiek (budget bewaking van sample())
+    unsigned long getMaxSampleDurationUs() const { return maxSampleDurationUs; }
+    unsigned long getBudgetOverruns() const { return budgetOverruns; }
+    int getConsecutiveFailures() const { return consecutiveFailures; }
+    unsigned long getFailureCount() const { return failureCount; }
+    TempSensorHealth getHealth() const { return health; }  // Kopie is niet atomair (diagnostiek)
 
 private:
-    float readSingle();
-    float readCritical();
-    float calculateMedian(float* samples, int count);
-    
-    MAX6675 sensor;
-    float offset;
+    TempQ readSingle(unsigned long now);
+    void runAcquisition(unsigned long now, bool force);
+    void publish(TempQ raw, TempQ filtered, unsigned long now, int64_t sampleUs);
+    void publishSnapshot(TempSensorStatus status);
+    void recordPeriod(int64_t nowUs);
+    void recordLatency(unsigned long latencyUs);
+    unsigned long computeIntervalMs() const;
+    unsigned long criticalMaxAgeMs() const;
+
+    Max6675DefaultTransport defaultTransport;
+    Max6675Transport* transport;
+    TempQ offset;
     unsigned long lastReadTime;
-    float currentTemp;
-    float medianTemp;
-    float lastValidTemp;
-    static const int MEDIAN_SAMPLES = 7;
-    float samples[MEDIAN_SAMPLES];
-    int sampleIndex;
-    int sampleCount;
-    unsigned long lastSampleMs;
+    bool hasReadTime;           // Los van lastReadTime: na een millis() wrap is 0 een geldig tijdstip
+    TempQ currentTemp;
+    TempQ medianTemp;
+    TempQ lastValidTemp;
+    TempFilterChain filter;                              // Compile-time filter keten
+    SlidingMedian<MAX6675_CRITICAL_SAMPLES> criticalWindow;  // Laatste ruwe (geaccepteerde) samples
+    AlphaBetaEstimator estimator;
+    bool estimatorEnabled;
+    SampleHistory* sampleHistory;
+
+    // State machine
+    TempAcquisitionState state;
+    unsigned long nextReadDueMs;
+    TempQ pendingTemp;
+    TempQ pendingFiltered;
+    unsigned long lastPublishMs;
+    int64_t pendingSampleUs;    // Tijdstip van de lopende acquisitie (esp_timer, µs)
+    int64_t lastPublishUs;
+    int consecutiveFailures;
+    unsigned long failureCount;
+    
+    // Snapshot publicatie: double buffer met sequence teller per slot (seqlock)
+    // De writer schrijft altijd in het inactieve slot en wisselt daarna activeSlot.
+    // Een lezer hoeft alleen opnieuw te kopiëren als er tijdens zijn kopie twee keer gepubliceerd is.
+    struct SnapshotSlot {
+        volatile uint32_t seq;  // Oneven = schrijven bezig
+        TempSensorSnapshot data;
+    };
+    SnapshotSlot snapshotSlots[2];
+    volatile uint8_t activeSlot;
+    
+    // Adaptieve sample rate
+    bool adaptiveEnabled;
+    volatile TempQ adaptiveTop;     // TEMP_Q_INVALID = geen drempel
+    volatile TempQ adaptiveBottom;
+    volatile unsigned long sampleIntervalMs;  // Huidige (geplande) sample periode
+    
+    // Sensor task (optioneel)
+    TaskHandle_t taskHandle;
+    unsigned long taskPeriodMs;
+    esp_timer_handle_t taskTimer;  // One-shot timer die de task op het absolute schema wekt
+    int64_t nextDueUs;
+    
+    // Jitter statistiek
+    TempSensorJitterStats jitterStats;
+    int64_t lastAcquireUs;
+
+    // Sensor gezondheid
+    TempSensorHealth health;
+
+    // Timing diagnostiek
+    unsigned long maxSampleDurationUs;
+    unsigned long budgetOverruns;
 };
 
 #endif // TEMPSENSOR_H
-
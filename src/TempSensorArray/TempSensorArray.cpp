@@ -0,0 +1,202 @@
+#include "TempSensorArray.h"
+#include <Arduino.h>
+
+TempSensorArray::TempSensorArray()
+    : channelCount(0), nextChannel(0), slotMs(TEMP_SAMPLE_INTERVAL_MS), nextSlotDueMs(0), startedMs(0),
+      disagreementCallback(nullptr), disagreementMask(0), disagreementCount(0), lostMask(0), lostCount(0) {
+    for (int i = 0; i < TEMP_ARRAY_MAX_CHANNELS; i++) {
+        channels[i] = nullptr;
+    }
+}
+
+bool TempSensorArray::addChannel(TempSensor* sensor) {
+    if (sensor == nullptr || channelCount >= TEMP_ARRAY_MAX_CHANNELS) {
+        return false;
+    }
+    channels[channelCount++] = sensor;
+    // Verdeel de sample periode over alle kanalen (per kanaal blijft de periode TEMP_SAMPLE_INTERVAL_MS)
+    slotMs = TEMP_SAMPLE_INTERVAL_MS / channelCount;
+    return true;
+}
+
+void TempSensorArray::begin() {
+    for (int i = 0; i < channelCount; i++) {
+        channels[i]->begin();
+    }
+    nextSlotDueMs = millis();
+    startedMs = nextSlotDueMs;
+}
+
+void TempSensorArray::sample() {
+    if (channelCount == 0) return;
+    
+    unsigned long now = millis();
+    if ((int32_t)(now - nextSlotDueMs) < 0) return;
+    
+    // Lees precies één chip per slot; de rest converteert ondertussen door
+    TempSensor* channel = channels[nextChannel];
+    if (!channel->isTaskMode()) {
+        channel->acquire();
+    }
+    nextChannel = (nextChannel + 1) % channelCount;
+    
+    // Vast raster: bij een late loop() niet inhalen maar op het volgende slot verder
+    nextSlotDueMs += slotMs;
+    if ((int32_t)(now - nextSlotDueMs) >= 0) {
+        nextSlotDueMs = now + slotMs;
+    }
+}
+
+TempSensor* TempSensorArray::getChannel(int index) const {
+    if (index < 0 || index >= channelCount) return nullptr;
+    return channels[index];
+}
+
+float TempSensorArray::getCritical(TempControlSource source, int channel) const {
+    return tempFromQ(aggregate(source, channel, true));
+}
+
+float TempSensorArray::getMedian(TempControlSource source, int channel) const {
+    return tempFromQ(aggregate(source, channel, false));
+}
+
+TempQ TempSensorArray::getCriticalQ(TempControlSource source, int channel) const {
+    return aggregate(source, channel, true);
+}
+
+TempQ TempSensorArray::getMedianQ(TempControlSource source, int channel) const {
+    return aggregate(source, channel, false);
+}
+
+TempQ TempSensorArray::aggregate(TempControlSource source, int channel, bool critical) const {
+    if (source == TempControlSource::CHANNEL) {
+        TempSensor* sensor = getChannel(channel);
+        if (sensor == nullptr) return TEMP_Q_INVALID;
+        return critical ? sensor->getCriticalQ() : sensor->getMedianQ();
+    }
+    
+    TempQ result = TEMP_Q_INVALID;
+    int32_t sum = 0;
+    int valid = 0;
+    TempQ values[TEMP_ARRAY_MAX_CHANNELS];
+    uint8_t lost = 0;
+    unsigned long now = millis();
+    bool settled = (uint32_t)(now - startedMs) > MAX6675_CRITICAL_MAX_AGE_MS;  // Na de eerste ronde reads
+    for (int i = 0; i < channelCount; i++) {
+        // Kanalen zonder recente geldige meting (bijv. losgeraakt thermokoppel) tellen niet mee,
+        // anders blijft hun laatste waarde het maximum of gemiddelde bepalen
+        TempSensorSnapshot snap = channels[i]->getSnapshot();
+        TempQ temp = critical ? snap.critical : snap.median;
+        if (snap.status == TempSensorStatus::NO_DATA || (uint32_t)(now - snap.timestampMs) > MAX6675_CRITICAL_MAX_AGE_MS) {
+            temp = TEMP_Q_INVALID;
+            if (settled) lost |= (uint8_t)(1 << i);
+        }
+        values[i] = temp;
+        if (!isValidQ(temp)) continue;
+        sum += temp;
+        valid++;
+        if (!isValidQ(result) || temp > result) {
+            result = temp;
+        }
+    }
+    if (source == TempControlSource::VOTE) {
+        result = vote(values, (channelCount < 3) ? channelCount : 3);
+    } else if (valid > 0 && source == TempControlSource::MEAN) {
+        result = (TempQ)(sum / valid);
+    }
+    // Uitval op basis van status en leeftijd (niet de waarde): kritiek en mediaan geven hetzelfde masker
+    reportLost(lost, result);
+    return result;
+}
+
+TempQ TempSensorArray::vote(const TempQ* values, int count) const {
+    // Onafhankelijke metingen van fysiek gescheiden chips: een losgeraakt of verlopen thermokoppel
+    // wordt overstemd in plaats van dat dezelfde chip opnieuw gelezen wordt.
+    //   3 geldig: paar binnen tolerantie = meerderheid, derde kanaal wijkt af
+    //   2 geldig: eens = gemiddelde, oneens = geen meerderheid
+    //   geen meerderheid: hoogste waarde (veilige kant: eerder stoppen met verwarmen, langer koelen)
+    const int tolerance = TEMP_VOTE_TOLERANCE_C * TEMP_Q_PER_DEGREE;
+    int idx[3];
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (isValidQ(values[i])) idx[n++] = i;
+    }
+    if (n <= 1) {
+        // Gedegradeerd: niets om over te stemmen; het uitgevallen kanaal meldt aggregate() via reportLost()
+        reportDisagreement(0, -1, TEMP_Q_INVALID, TEMP_Q_INVALID);
+        return (n == 1) ? values[idx[0]] : TEMP_Q_INVALID;
+    }
+    
+    TempQ highest = values[idx[0]];
+    for (int i = 1; i < n; i++) {
+        if (values[idx[i]] > highest) highest = values[idx[i]];
+    }
+    
+    uint8_t mask = 0;
+    TempQ consensus = highest;
+    int odd_channel = -1;
+    if (n == 2) {
+        if (abs((int)values[idx[0]] - (int)values[idx[1]]) <= tolerance) {
+            consensus = (TempQ)(((int)values[idx[0]] + (int)values[idx[1]]) / 2);
+        } else {
+            mask = 0x80;
+        }
+    } else {
+        // Zoek het paar met de kleinste afstand; binnen tolerantie = meerderheid
+        int best_a = 0, best_b = 1, best_dist = INT_MAX;
+        for (int a = 0; a < 3; a++) {
+            for (int b = a + 1; b < 3; b++) {
+                int dist = abs((int)values[idx[a]] - (int)values[idx[b]]);
+                if (dist < best_dist) {
+                    best_dist = dist;
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+        if (best_dist > tolerance) {
+            mask = 0x80;
+        } else {
+            int other = 3 - best_a - best_b;
+            int mid = ((int)values[idx[best_a]] + (int)values[idx[best_b]]) / 2;
+            if (abs((int)values[idx[other]] - mid) <= tolerance) {
+                // Alle drie eens: mediaan van drie
+                TempQ a = values[idx[0]], b = values[idx[1]], c = values[idx[2]];
+                consensus = (a > b) ? ((b > c) ? b : ((a > c) ? c : a)) : ((a > c) ? a : ((b > c) ? c : b));
+            } else {
+                consensus = (TempQ)mid;
+                odd_channel = idx[other];
+                mask = (uint8_t)(1 << odd_channel);
+            }
+        }
+    }
+    
+    reportDisagreement(mask, odd_channel, (odd_channel >= 0) ? values[odd_channel] : highest, consensus);
+    return consensus;
+}
+
+void TempSensorArray::reportDisagreement(uint8_t mask, int channel, TempQ channelTemp, TempQ consensus) const {
+    // Alleen nieuwe onenigheid melden (overgang), anders zou elke regel-iteratie een log opleveren
+    uint8_t new_bits = mask & ~disagreementMask;
+    disagreementMask = mask;
+    if (new_bits == 0) return;
+    disagreementCount++;
+    if (disagreementCallback) {
+        disagreementCallback(channel, tempFromQ(channelTemp), tempFromQ(consensus));
+    }
+}
+
+void TempSensorArray::reportLost(uint8_t mask, TempQ consensus) const {
+    // Zelfde overgang regel als reportDisagreement(): één melding per kanaal dat uitvalt, een kanaal
+    // dat terugkomt en opnieuw uitvalt wordt opnieuw gemeld
+    uint8_t new_bits = mask & ~lostMask;
+    lostMask = mask;
+    for (int i = 0; i < channelCount && new_bits != 0; i++) {
+        if ((new_bits & (1 << i)) == 0) continue;
+        new_bits &= (uint8_t)~(1 << i);
+        lostCount++;
+        if (disagreementCallback) {
+            disagreementCallback(i, NAN, tempFromQ(consensus));
+        }
+    }
+}
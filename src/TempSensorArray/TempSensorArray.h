@@ -0,0 +1,74 @@
+#ifndef TEMPSENSORARRAY_H
+#define TEMPSENSORARRAY_H
+
+#include <stdint.h>
+#include "../TempSensor/TempSensor.h"
+
+#ifndef TEMP_ARRAY_MAX_CHANNELS
+#define TEMP_ARRAY_MAX_CHANNELS 4
+#endif
+#ifndef TEMP_VOTE_TOLERANCE_C
+#define TEMP_VOTE_TOLERANCE_C 5  // Kanalen binnen deze afstand (°C) zijn het eens
+#endif
+
+// Welke temperatuur de regeling gebruikt
+enum class TempControlSource : uint8_t {
+    CHANNEL,  // Eén gekozen kanaal
+    MAX,      // Hoogste temperatuur over alle geldige kanalen (veiligste keuze bij verwarmen)
+    MEAN,     // Gemiddelde over alle geldige kanalen
+    VOTE      // 2-of-3 stemming over de eerste drie kanalen (zie vote())
+};
+
+// Meerdere MAX6675 chips op gedeelde SCK/SO met elk een eigen CS pin.
+// Elk kanaal is een volledige TempSensor (eigen filter keten, offset en fout tellers).
+// Round-robin planning: de sample periode wordt in N gelijke slots verdeeld en per slot
+// wordt precies één chip gelezen. Een read onderbreekt alleen de conversie van die chip,
+// dus de 220ms conversies van de andere chips lopen ondertussen door en elk kanaal
+// haalt de volledige rate per chip.
+class TempSensorArray {
+public:
+    TempSensorArray();
+    bool addChannel(TempSensor* sensor);  // Kanaal 0 = eerste toegevoegde sensor
+    void begin();
+    void sample();  // Aanroepen vanuit loop() - hooguit één SPI transactie per aanroep
+
+    int getChannelCount() const { return channelCount; }
+    TempSensor* getChannel(int index) const;
+
+    // Temperaturen volgens de gekozen bron (NAN / TEMP_Q_INVALID als geen geldig kanaal)
+    float getCritical(TempControlSource source, int channel) const;
+    float getMedian(TempControlSource source, int channel) const;
+    TempQ getCriticalQ(TempControlSource source, int channel) const;
+    TempQ getMedianQ(TempControlSource source, int channel) const;
+    
+    // Melding bij onenigheid in VOTE mode: channel = afwijkend kanaal (-1 = geen meerderheid),
+    // alleen bij overgang van eens naar oneens (niet elke aanroep).
+    // Ook een kanaal dat uitvalt (geen data of te oude meting) wordt zo gemeld, in elke bron behalve
+    // CHANNEL: channelTemp = NAN, consensusTemp = de temperatuur waarmee verder geregeld wordt (of NAN)
+    typedef void (*DisagreementCallback)(int channel, float channelTemp, float consensusTemp);
+    void setDisagreementCallback(DisagreementCallback cb) { disagreementCallback = cb; }
+    unsigned long getDisagreementCount() const { return disagreementCount; }
+    unsigned long getLostCount() const { return lostCount; }
+    uint8_t getLostMask() const { return lostMask; }  // Bit per uitgevallen kanaal
+
+private:
+    TempQ aggregate(TempControlSource source, int channel, bool critical) const;
+    TempQ vote(const TempQ* values, int count) const;
+    void reportDisagreement(uint8_t mask, int channel, TempQ channelTemp, TempQ consensus) const;
+    void reportLost(uint8_t mask, TempQ consensus) const;
+
+    TempSensor* channels[TEMP_ARRAY_MAX_CHANNELS];
+    int channelCount;
+    int nextChannel;
+    unsigned long slotMs;
+    unsigned long nextSlotDueMs;
+    unsigned long startedMs;  // begin(): kanalen zonder data tellen pas na MAX6675_CRITICAL_MAX_AGE_MS als uitgevallen
+    
+    DisagreementCallback disagreementCallback;
+    mutable uint8_t disagreementMask;  // Bit per kanaal (bit 7 = geen meerderheid), voor melding bij overgang
+    mutable unsigned long disagreementCount;
+    mutable uint8_t lostMask;  // Bit per kanaal zonder recente geldige meting, voor melding bij overgang
+    mutable unsigned long lostCount;
+};
+
+#endif // TEMPSENSORARRAY_H
@@ -0,0 +1,195 @@
+#include "ThermalSim.h"
+#include <string.h>
+#include <math.h>
+
+ThermalSim::ThermalSim(const ThermalSimConfig& config)
+    : cfg(config), targetTop(80.0f), targetBottom(25.0f) {
+    reset();
+}
+
+void ThermalSim::reset() {
+    plantC = cfg.initialC;
+    simTimeMs = 0;
+    lastAdvanceMs = 0;
+    advanced = false;
+    rng = 0x1234567u;
+    openCircuit = false;
+    busError = false;
+
+    float steps = cfg.deadTimeS * 1000.0f / THERMAL_SIM_STEP_MS;
+    if (steps < 0.0f) steps = 0.0f;
+    if (steps > THERMAL_SIM_MAX_DEAD_STEPS) steps = THERMAL_SIM_MAX_DEAD_STEPS;
+    deadSteps = (uint16_t)steps;
+    memset(heaterDelay, 0, sizeof(heaterDelay));
+    delayIndex = 0;
+    remainderMs = 0;
+
+    lastHeating = false;
+    heaterSeen = false;
+    cycles = 0;
+    peakC = plantC;
+    valleyC = plantC;
+    trackingPeak = false;
+    trackingValley = false;
+    overshootSum = 0.0f;
+    maxOvershoot = 0.0f;
+    overshootCount = 0;
+    undershootSum = 0.0f;
+    maxUndershoot = 0.0f;
+    undershootCount = 0;
+    topCrossMs = -1;
+    bottomCrossMs = -1;
+    topLatencySum = 0;
+    topLatencyCount = 0;
+    bottomLatencySum = 0;
+    bottomLatencyCount = 0;
+    heaterOffMs = -1;
+    safetyTrips = 0;
+}
+
+void ThermalSim::advanceTo(unsigned long nowMs, bool heaterOn, bool coolerOn) {
+    if (!advanced) {
+        advanced = true;
+        lastAdvanceMs = nowMs;
+        return;
+    }
+    step((uint32_t)(nowMs - lastAdvanceMs), heaterOn, coolerOn);
+    lastAdvanceMs = nowMs;
+}
+
+void ThermalSim::step(uint32_t dtMs, bool heaterOn, bool coolerOn) {
+    // Vaste stapgrootte: de dode tijd ring en de meetcijfers hebben een vaste tijdsbasis
+    remainderMs += dtMs;
+    while (remainderMs >= THERMAL_SIM_STEP_MS) {
+        remainderMs -= THERMAL_SIM_STEP_MS;
+        simTimeMs += THERMAL_SIM_STEP_MS;
+        integrate(heaterOn, coolerOn);
+        // Fasen volgen de koeling: de verwarming kan binnen een opwarmfase pulseren (PID modus)
+        track(!coolerOn);
+    }
+}
+
+void ThermalSim::integrate(bool heaterOn, bool coolerOn) {
+    // Verwarming stand van L seconden geleden (ring schuift één stap op)
+    bool delayedHeater = heaterOn;
+    if (deadSteps > 0) {
+        delayedHeater = heaterDelay[delayIndex] != 0;
+        heaterDelay[delayIndex] = heaterOn ? 1 : 0;
+        delayIndex = (delayIndex + 1) % deadSteps;
+    }
+
+    float tau = coolerOn ? cfg.tauCoolS : cfg.tauHeatS;
+    float target = cfg.ambientC + (delayedHeater ? cfg.heaterGainC : 0.0f);
+    // Exacte oplossing over één stap (stabiel voor elke tau/stap verhouding)
+    float alpha = 1.0f - expf(-(THERMAL_SIM_STEP_MS / 1000.0f) / tau);
+    plantC += (target - plantC) * alpha;
+}
+
+void ThermalSim::track(bool heatingPhase) {
+    int64_t now = (int64_t)simTimeMs;
+
+    if (heatingPhase && !lastHeating) {
+        // Koeling uit: einde koelfase
+        if (trackingPeak) {
+            float overshoot = peakC - targetTop;
+            overshootSum += overshoot;
+            if (overshootCount == 0 || overshoot > maxOvershoot) maxOvershoot = overshoot;
+            overshootCount++;
+            trackingPeak = false;
+        }
+        if (heaterSeen) {
+            cycles++;
+            if (bottomCrossMs >= 0) {
+                bottomLatencySum += now - bottomCrossMs;
+                bottomLatencyCount++;
+            }
+        }
+        trackingValley = heaterSeen;  // Eerste opwarming vanaf omgeving is geen undershoot
+        heaterSeen = true;
+        heaterOffMs = -1;
+        topCrossMs = -1;
+        valleyC = plantC;
+    } else if (!heatingPhase && lastHeating) {
+        // Koeling aan: einde opwarmfase
+        if (trackingValley) {
+            float undershoot = targetBottom - valleyC;
+            undershootSum += undershoot;
+            if (undershootCount == 0 || undershoot > maxUndershoot) maxUndershoot = undershoot;
+            undershootCount++;
+            trackingValley = false;
+        }
+        if (topCrossMs >= 0) {
+            topLatencySum += now - topCrossMs;
+            topLatencyCount++;
+            heaterOffMs = -1;
+        } else {
+            heaterOffMs = now;  // Voortijdig uit: latency wordt negatief als T_top alsnog gehaald wordt
+        }
+        bottomCrossMs = -1;
+        peakC = plantC;
+        trackingPeak = true;
+    }
+    lastHeating = heatingPhase;
+
+    if (heatingPhase) {
+        if (topCrossMs < 0 && plantC >= targetTop) topCrossMs = now;
+        if (trackingValley && plantC < valleyC) valleyC = plantC;
+    } else {
+        if (trackingPeak && plantC > peakC) peakC = plantC;
+        if (heaterOffMs >= 0 && plantC >= targetTop) {
+            topLatencySum += heaterOffMs - now;
+            topLatencyCount++;
+            heaterOffMs = -1;
+        }
+        if (heaterSeen && bottomCrossMs < 0 && plantC <= targetBottom) bottomCrossMs = now;
+    }
+}
+
+float ThermalSim::noise() {
+    // xorshift32: deterministisch, zodat runs met dezelfde instellingen vergelijkbaar zijn
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return ((float)(rng & 0xFFFF) / 32767.5f - 1.0f) * cfg.noiseC;
+}
+
+float ThermalSim::getMeasuredTemp() {
+    return plantC + noise();
+}
+
+void ThermalSim::onTransition(const char* status) {
+    if (status != nullptr && strncmp(status, "Beveiliging", 11) == 0) {
+        safetyTrips++;
+    }
+}
+
+void ThermalSim::getReport(ThermalSimReport& out) const {
+    out.simHours = (float)simTimeMs / 3600000.0f;
+    out.cycles = cycles;
+    out.cyclesPerHour = (out.simHours > 0.0f) ? cycles / out.simHours : 0.0f;
+    out.maxOvershootC = maxOvershoot;
+    out.avgOvershootC = overshootCount ? overshootSum / overshootCount : 0.0f;
+    out.maxUndershootC = maxUndershoot;
+    out.avgUndershootC = undershootCount ? undershootSum / undershootCount : 0.0f;
+    out.avgTopLatencyMs = topLatencyCount ? (int32_t)(topLatencySum / topLatencyCount) : 0;
+    out.avgBottomLatencyMs = bottomLatencyCount ? (int32_t)(bottomLatencySum / bottomLatencyCount) : 0;
+    out.safetyTrips = safetyTrips;
+}
+
+bool Max6675SimTransport::readFrame(uint16_t& raw) {
+    if (sim == nullptr) return false;
+    if (sim->isBusError()) {
+        raw = 0xFFFF;
+        return true;
+    }
+    if (sim->isOpenCircuit()) {
+        raw = 0x0004;
+        return true;
+    }
+    // MAX6675 bereik 0..1023.75°C in kwart graden, bits 14..3
+    float measured = sim->getMeasuredTemp();
+    if (measured < 0.0f) measured = 0.0f;
+    if (measured > 1023.75f) measured = 1023.75f;
+    raw = (uint16_t)((uint16_t)(measured * 4.0f + 0.5f) << 3);
+    return true;
+}
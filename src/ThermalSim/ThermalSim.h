@@ -0,0 +1,133 @@
+#ifndef THERMALSIM_H
+#define THERMALSIM_H
+
+#include <stdint.h>
+#include "../TempSensor/Max6675Transport.h"
+
+// Vaste integratie stap van het model; step() verdeelt langere intervallen in stappen van deze grootte
+#ifndef THERMAL_SIM_STEP_MS
+#define THERMAL_SIM_STEP_MS 100
+#endif
+// Maximale dode tijd (in stappen van THERMAL_SIM_STEP_MS): 600 = 60 seconden, 1 byte per stap
+#ifndef THERMAL_SIM_MAX_DEAD_STEPS
+#define THERMAL_SIM_MAX_DEAD_STEPS 600
+#endif
+
+// First-order-plus-dead-time model van oven + thermokoppel:
+//   dT/dt = (T_ambient + K * u(t - L) - T) / tau
+// u = verwarming aan (0/1), L = dode tijd (warmte moet door element/wand naar het thermokoppel),
+// tau = tijdconstante, korter als de koeling (ventilator) aan staat.
+struct ThermalSimConfig {
+    float ambientC;      // Omgevingstemperatuur
+    float heaterGainC;   // K: eindtemperatuur boven omgeving met verwarming continu aan
+    float tauHeatS;      // Tijdconstante zonder koeling (seconden)
+    float tauCoolS;      // Tijdconstante met koeling aan (seconden)
+    float deadTimeS;     // L: dode tijd van de verwarming (seconden, max THERMAL_SIM_MAX_DEAD_STEPS stappen)
+    float noiseC;        // Meetruis amplitude (uniform +/-, graden)
+    float initialC;      // Starttemperatuur
+
+    ThermalSimConfig()
+        : ambientC(20.0f), heaterGainC(250.0f), tauHeatS(900.0f), tauCoolS(300.0f),
+          deadTimeS(15.0f), noiseC(0.25f), initialC(20.0f) {}
+};
+
+// Resultaten over de gesimuleerde tijd (echte plant temperatuur, niet de meting)
+struct ThermalSimReport {
+    float simHours;
+    uint32_t cycles;              // Aantal opwarmfasen na een koelfase (fasen volgen de koeling relais)
+    float cyclesPerHour;
+    float maxOvershootC;          // Hoogste piek boven T_top in de koelfase
+    float avgOvershootC;
+    float maxUndershootC;         // Laagste dal onder T_bottom in de opwarmfase
+    float avgUndershootC;
+    int32_t avgTopLatencyMs;      // Plant >= T_top tot koeling aan (negatief = voortijdig omgeschakeld)
+    int32_t avgBottomLatencyMs;   // Plant <= T_bottom tot koeling uit
+    uint32_t safetyTrips;         // "Beveiliging: ..." transities (via onTransition())
+};
+
+// Plant model + meetcijfers. Geen Arduino afhankelijkheden: de aanroeper levert tijd en relais
+// standen, zodat het model zowel op het board (THERMAL_SIM_MODE in de sketch, echte tijd) als in de
+// host harness (test/host/ThermalSimRunner, versnelde tijd) gebruikt kan worden.
+class ThermalSim {
+public:
+    explicit ThermalSim(const ThermalSimConfig& config = ThermalSimConfig());
+    void reset();
+
+    // Simuleer dtMs met de gegeven relais standen
+    void step(uint32_t dtMs, bool heaterOn, bool coolerOn);
+    // Gemak voor de loop(): simuleert de tijd sinds de vorige aanroep
+    void advanceTo(unsigned long nowMs, bool heaterOn, bool coolerOn);
+
+    float getPlantTemp() const { return plantC; }
+    float getMeasuredTemp();  // Plant + ruis (zoals het thermokoppel het ziet)
+    uint64_t getSimTimeMs() const { return simTimeMs; }
+
+    // Foutinjectie: thermokoppel los (open circuit frame) of geen chip (0xFFFF)
+    void setOpenCircuit(bool open) { openCircuit = open; }
+    void setBusError(bool error) { busError = error; }
+    bool isOpenCircuit() const { return openCircuit; }
+    bool isBusError() const { return busError; }
+
+    // Meetcijfers: drempels bepalen overshoot/latency, transities tellen beveiligingen
+    void setTargets(float tTop, float tBottom) { targetTop = tTop; targetBottom = tBottom; }
+    void onTransition(const char* status);
+    void getReport(ThermalSimReport& out) const;
+
+private:
+    void integrate(bool heaterOn, bool coolerOn);
+    void track(bool heatingPhase);
+    float noise();
+
+    ThermalSimConfig cfg;
+    float plantC;
+    uint64_t simTimeMs;
+    unsigned long lastAdvanceMs;
+    bool advanced;
+    uint32_t rng;
+    bool openCircuit;
+    bool busError;
+
+    // Dode tijd: ring van verwarming standen per stap
+    uint8_t heaterDelay[THERMAL_SIM_MAX_DEAD_STEPS];
+    uint16_t deadSteps;
+    uint16_t delayIndex;
+    uint32_t remainderMs;
+
+    // Meetcijfers
+    float targetTop;
+    float targetBottom;
+    bool lastHeating;
+    bool heaterSeen;
+    uint32_t cycles;
+    float peakC;              // Piek sinds start koelfase
+    float valleyC;            // Dal sinds start opwarmfase
+    bool trackingPeak;
+    bool trackingValley;
+    float overshootSum;
+    float maxOvershoot;
+    uint32_t overshootCount;
+    float undershootSum;
+    float maxUndershoot;
+    uint32_t undershootCount;
+    int64_t topCrossMs;       // -1 = niet gepasseerd in deze fase
+    int64_t bottomCrossMs;
+    int64_t heaterOffMs;      // Koelfase gestart voordat de plant T_top haalde (-1 = n.v.t.)
+    int64_t topLatencySum;
+    uint32_t topLatencyCount;
+    int64_t bottomLatencySum;
+    uint32_t bottomLatencyCount;
+    uint32_t safetyTrips;
+};
+
+// MAX6675 transport dat frames uit het model levert (zelfde decodering als de echte chip)
+class Max6675SimTransport : public Max6675Transport {
+public:
+    explicit Max6675SimTransport(ThermalSim* sim) : sim(sim) {}
+    void begin() override {}
+    bool readFrame(uint16_t& raw) override;
+
+private:
+    ThermalSim* sim;
+};
+
+#endif // THERMALSIM_H
@@ -11,6 +11,7 @@ UIController::UIController()
       getCycleCountCallback(nullptr), getHeatingElapsedCallback(nullptr), getCoolingElapsedCallback(nullptr),
       getMedianTempCallback(nullptr), getLastValidTempCallback(nullptr),
       ttopCallback(nullptr), tbottomCallback(nullptr), cyclusMaxCallback(nullptr),
+      profileSelectCallback(nullptr), profileNameCallback(nullptr),
       screen_main(nullptr), text_label_temp(nullptr), text_label_temp_value(nullptr),
       text_label_cyclus(nullptr), text_label_status(nullptr), text_label_t_top(nullptr),
       text_label_t_bottom(nullptr), text_label_verwarmen_tijd(nullptr), text_label_koelen_tijd(nullptr),
@@ -18,14 +19,15 @@ UIController::UIController()
       btn_stop(nullptr), btn_graph(nullptr), btn_t_top_plus(nullptr), btn_t_top_minus(nullptr),
       btn_t_bottom_plus(nullptr), btn_t_bottom_minus(nullptr), btn_temp_plus(nullptr),
       btn_temp_minus(nullptr),       btn_cyclus_plus(nullptr), btn_cyclus_minus(nullptr),
+      text_label_profile(nullptr), btn_profile(nullptr),
       init_status_label(nullptr), wifi_status_label(nullptr), gs_status_label(nullptr),
       ap_status_label_prefix(nullptr), ap_status_label_ssid(nullptr), ap_status_label_ip_label(nullptr), ap_status_label_ip(nullptr),
       screen_graph(nullptr), chart(nullptr), chart_series_rising(nullptr), chart_series_falling(nullptr),
       graph_temps(nullptr), graph_times(nullptr), graph_write_index(0), graph_count(0),
-      graph_data_ready(false), graph_last_log_time(0), last_graph_update_ms(0),
+      graph_data_ready(false), graph_last_log_time(MONO_US_UNSET), last_graph_update_ms(0),
       graph_force_rebuild(false), draw_buf(nullptr),
       firmwareVersionMajor(3), firmwareVersionMinor(98),
-      last_display_ms(0), last_displayed_time(0) {
+      last_display_ms(0), last_displayed_time(MONO_US_UNSET) {
     // Initialiseer y_axis_labels array
     for (int i = 0; i < 6; i++) {
         y_axis_labels[i] = nullptr;
@@ -97,6 +99,14 @@ void UIController::update() {
         lv_label_set_text(text_label_status, status_text);
     }
     
+    // Update gekozen profiel
+    if (text_label_profile != nullptr && profileNameCallback) {
+        const char* name = profileNameCallback();
+        char profile_text[40];
+        snprintf(profile_text, sizeof(profile_text), "Profiel: %s", name != nullptr ? name : "geen");
+        lv_label_set_text(text_label_profile, profile_text);
+    }
+    
     // Update temperatuur instellingen
     if (text_label_t_top != nullptr && ttopCallback) {
         char t_top_text[32];
@@ -195,16 +205,18 @@ void UIController::logGraphData() {
     }
     
     // Log temperatuur data elke 5 seconden
-    unsigned long now = millis();
+    MonoUs now = monoNowUs();
+    bool log_due = !isSetMono(graph_last_log_time) ||
+                   monoElapsedMs(graph_last_log_time, now) >= TEMP_GRAPH_LOG_INTERVAL_MS;
     
     // BELANGRIJK: Gebruik mediaan temperatuur voor grafiek (net zoals statusovergangen)
-    float temp_for_graph = getMedianTempCallback ? getMedianTempCallback() : NAN;
+    TempQ temp_for_graph = tempToQ(getMedianTempCallback ? getMedianTempCallback() : NAN);
     
-    // Accepteer alle waarden behalve NAN (ook 0.0 is geldig)
-    bool valid_temp = !isnan(temp_for_graph) && temp_for_graph >= -50.0 && temp_for_graph <= 350.0;
+    // Accepteer alle waarden behalve ongeldig (ook 0.0 is geldig)
+    bool valid_temp = isValidQ(temp_for_graph) && temp_for_graph >= TEMP_Q(-50.0) && temp_for_graph <= TEMP_Q(350.0);
     
     // BELANGRIJK: graph_last_log_time wordt alleen gereset bij START, niet bij cyclus overgangen
-    if (valid_temp && (now - graph_last_log_time >= TEMP_GRAPH_LOG_INTERVAL_MS)) {
+    if (valid_temp && log_due) {
         // EENVOUDIGE CIRCULAIRE ARRAY: Schrijf naar graph_write_index
         graph_temps[graph_write_index] = temp_for_graph;
         graph_times[graph_write_index] = now;
@@ -227,7 +239,7 @@ void UIController::logGraphData() {
         if (lv_scr_act() == screen_graph) {
             updateGraph();
         }
-    } else if (!valid_temp && (now - graph_last_log_time >= TEMP_GRAPH_LOG_INTERVAL_MS)) {
+    } else if (!valid_temp && log_due) {
         // Temperatuur is ongeldig, maar tijd is verstreken
         // Update graph_last_log_time om te voorkomen dat de functie blijft proberen
         graph_last_log_time = now;
@@ -299,13 +311,19 @@ void UIController::onTbottomMinus() {
 
 void UIController::onTempOffsetPlus() {
     if (settingChangeCallback) {
-        settingChangeCallback("temp_offset", 0.1);  // +0.1
+        settingChangeCallback("temp_offset", 0.25);  // +0.25 (resolutie MAX6675)
     }
 }
 
 void UIController::onTempOffsetMinus() {
     if (settingChangeCallback) {
-        settingChangeCallback("temp_offset", -0.1);  // -0.1
+        settingChangeCallback("temp_offset", -0.25);  // -0.25
+    }
+}
+
+void UIController::onProfileButton() {
+    if (profileSelectCallback) {
+        profileSelectCallback();
     }
 }
 
@@ -479,6 +497,7 @@ void UIController::setButtonsGray() {
     if (btn_t_top_plus != nullptr) lv_obj_set_style_bg_color(btn_t_top_plus, lv_color_hex(gray_color), LV_PART_MAIN);
     if (btn_t_bottom_minus != nullptr) lv_obj_set_style_bg_color(btn_t_bottom_minus, lv_color_hex(gray_color), LV_PART_MAIN);
     if (btn_t_bottom_plus != nullptr) lv_obj_set_style_bg_color(btn_t_bottom_plus, lv_color_hex(gray_color), LV_PART_MAIN);
+    if (btn_profile != nullptr) lv_obj_set_style_bg_color(btn_profile, lv_color_hex(gray_color), LV_PART_MAIN);
     if (btn_start != nullptr) lv_obj_set_style_bg_color(btn_start, lv_color_hex(gray_color), LV_PART_MAIN);
     if (btn_graph != nullptr) lv_obj_set_style_bg_color(btn_graph, lv_color_hex(gray_color), LV_PART_MAIN);
     
@@ -495,6 +514,7 @@ void UIController::setButtonsNormal() {
     if (btn_t_top_plus != nullptr) lv_obj_set_style_bg_color(btn_t_top_plus, lv_color_hex(0x0066CC), LV_PART_MAIN); // Blauw
     if (btn_t_bottom_minus != nullptr) lv_obj_set_style_bg_color(btn_t_bottom_minus, lv_color_hex(0x0066CC), LV_PART_MAIN); // Blauw
     if (btn_t_bottom_plus != nullptr) lv_obj_set_style_bg_color(btn_t_bottom_plus, lv_color_hex(0x0066CC), LV_PART_MAIN); // Blauw
+    if (btn_profile != nullptr) lv_obj_set_style_bg_color(btn_profile, lv_color_hex(0x0066CC), LV_PART_MAIN); // Blauw
     if (btn_start != nullptr) lv_obj_set_style_bg_color(btn_start, lv_color_hex(0x00AA00), LV_PART_MAIN); // Groen
     if (btn_graph != nullptr) lv_obj_set_style_bg_color(btn_graph, lv_color_hex(0x0066CC), LV_PART_MAIN); // Blauw
     
@@ -694,6 +714,23 @@ void UIController::createMainScreen() {
     lv_obj_align(text_label_koelen_tijd, LV_ALIGN_TOP_RIGHT, -5, 130);
     lv_obj_set_width(text_label_koelen_tijd, 140);
     
+    // Regel 6: Profiel (links) met [>] knop: volgend opgeslagen ramp/soak profiel of geen
+    text_label_profile = lv_label_create(lv_screen_active());
+    lv_label_set_text(text_label_profile, "Profiel: geen");
+    lv_obj_set_style_text_align(text_label_profile, LV_TEXT_ALIGN_LEFT, 0);
+    lv_obj_align(text_label_profile, LV_ALIGN_TOP_LEFT, 10, 160);
+    lv_obj_set_width(text_label_profile, 185);
+    lv_label_set_long_mode(text_label_profile, LV_LABEL_LONG_CLIP);
+    
+    btn_profile = lv_btn_create(lv_screen_active());
+    lv_obj_set_size(btn_profile, 25, 25);
+    lv_obj_align(btn_profile, LV_ALIGN_TOP_LEFT, 200, 158);
+    lv_obj_set_style_bg_color(btn_profile, lv_color_hex(0x0066CC), LV_PART_MAIN);
+    lv_obj_t * btn_profile_label = lv_label_create(btn_profile);
+    lv_label_set_text(btn_profile_label, ">");
+    lv_obj_center(btn_profile_label);
+    lv_obj_add_event_cb(btn_profile, profile_select_event, LV_EVENT_ALL, NULL);
+    
     // Status regels
     init_status_label = lv_label_create(lv_screen_active());
     lv_label_set_text(init_status_label, "WiFi initialiseren");
@@ -888,13 +925,13 @@ void UIController::updateGraph() {
     
     // BELANGRIJK: Reset last_displayed_time bij force rebuild om nieuwe punten te kunnen tonen
     if (graph_force_rebuild) {
-        last_displayed_time = 0; // Reset zodat fillChart alle punten toont
+        last_displayed_time = MONO_US_UNSET; // Reset zodat fillChart alle punten toont
     }
     
-    if (graph_force_rebuild || last_displayed_time == 0) {
+    if (graph_force_rebuild || !isSetMono(last_displayed_time)) {
         fillChart();
         // Bepaal tijd van nieuwste punt voor volgende update
-        unsigned long max_time = 0;
+        MonoUs max_time = MONO_US_UNSET;  // Kleinste waarde: elk gezet tijdstip is groter
         int points_to_check = (graph_count < GRAPH_POINTS) ? graph_count : GRAPH_POINTS;
         int start_index = (graph_count < GRAPH_POINTS) ? 0 : graph_write_index;
         for (int j = 0; j < points_to_check; j++) {
@@ -903,11 +940,7 @@ void UIController::updateGraph() {
                 max_time = graph_times[i];
             }
         }
-        if (max_time > 0) {
-            last_displayed_time = max_time;
-        } else {
-            last_displayed_time = 0;
-        }
+        last_displayed_time = max_time;
         graph_force_rebuild = false; // Reset flag
         return;
     }
@@ -916,7 +949,7 @@ void UIController::updateGraph() {
     int points_to_check = (graph_count < GRAPH_POINTS) ? graph_count : GRAPH_POINTS;
     int start_index = (graph_count < GRAPH_POINTS) ? 0 : graph_write_index;
     int points_added = 0;
-    unsigned long newest_time = last_displayed_time;
+    MonoUs newest_time = last_displayed_time;
     
     // Haal T_top op via callback
     float max_temp = ttopCallback ? ttopCallback() : 100.0;
@@ -929,12 +962,12 @@ void UIController::updateGraph() {
         if (i < 0 || i >= GRAPH_POINTS) break;
         
         // Check of dit punt nieuwer is dan laatst weergegeven
-        if (graph_times[i] == 0 || graph_times[i] <= last_displayed_time) {
+        if (!isSetMono(graph_times[i]) || graph_times[i] <= last_displayed_time) {
             continue; // Skip oude punten
         }
         
         // Check of dit punt geldig is
-        if (isnan(graph_temps[i]) || graph_temps[i] < -50.0 || graph_temps[i] > 350.0) {
+        if (!isValidQ(graph_temps[i]) || graph_temps[i] < TEMP_Q(-50.0) || graph_temps[i] > TEMP_Q(350.0)) {
             // Ongeldig punt: voeg leeg punt toe maar update tijd wel
             lv_chart_set_next_value(chart, chart_series_rising, LV_CHART_POINT_NONE);
             lv_chart_set_next_value(chart, chart_series_falling, LV_CHART_POINT_NONE);
@@ -945,7 +978,7 @@ void UIController::updateGraph() {
             continue;
         }
         
-        int chart_value = (int)(graph_temps[i] + 0.5);
+        int chart_value = (graph_temps[i] + TEMP_Q_PER_DEGREE / 2) / TEMP_Q_PER_DEGREE; // Afgerond op hele graden
         chart_value = constrain(chart_value, (int)min_temp, (int)max_temp);
         addChartPoint(i, graph_temps[i], chart_value);
         
@@ -998,13 +1031,13 @@ void UIController::fillChart() {
         if (i < 0 || i >= GRAPH_POINTS) continue;
         
         // Check of dit punt geldig is
-        if (graph_times[i] == 0 || isnan(graph_temps[i]) || 
-            graph_temps[i] < -50.0 || graph_temps[i] > 350.0) {
+        if (!isSetMono(graph_times[i]) || !isValidQ(graph_temps[i]) || 
+            graph_temps[i] < TEMP_Q(-50.0) || graph_temps[i] > TEMP_Q(350.0)) {
             // Ongeldig punt: skip
             continue;
         }
         
-        int chart_value = (int)(graph_temps[i] + 0.5);
+        int chart_value = (graph_temps[i] + TEMP_Q_PER_DEGREE / 2) / TEMP_Q_PER_DEGREE; // Afgerond op hele graden
         chart_value = constrain(chart_value, (int)min_temp, (int)max_temp);
         addChartPoint(i, graph_temps[i], chart_value);
         
@@ -1027,7 +1060,7 @@ void UIController::clearChart() {
     }
 }
 
-void UIController::addChartPoint(int index, float tempValue, int chartValue) {
+void UIController::addChartPoint(int index, TempQ tempValue, int chartValue) {
     // Null pointer check voor arrays
     if (graph_temps == nullptr || graph_times == nullptr) {
         return;
@@ -1046,7 +1079,7 @@ void UIController::addChartPoint(int index, float tempValue, int chartValue) {
         // Normaal geval: vergelijk met vorige index
         int prev_index = index - 1;
         if (prev_index >= 0 && prev_index < GRAPH_POINTS) {
-            if (!isnan(graph_temps[prev_index]) && graph_times[prev_index] > 0) {
+            if (isValidQ(graph_temps[prev_index]) && isSetMono(graph_times[prev_index])) {
                 rising = tempValue > graph_temps[prev_index];
                 has_previous = true;
             }
@@ -1055,7 +1088,7 @@ void UIController::addChartPoint(int index, float tempValue, int chartValue) {
         // Bij wrap-around (buffer vol): vergelijk met laatste punt in buffer
         int prev_index = (graph_write_index - 1 + GRAPH_POINTS) % GRAPH_POINTS;
         if (prev_index >= 0 && prev_index < GRAPH_POINTS) {
-            if (!isnan(graph_temps[prev_index]) && graph_times[prev_index] > 0) {
+            if (isValidQ(graph_temps[prev_index]) && isSetMono(graph_times[prev_index])) {
                 rising = tempValue > graph_temps[prev_index];
                 has_previous = true;
             }
@@ -1092,8 +1125,8 @@ bool UIController::allocateBuffers() {
     draw_buf = (uint32_t*)malloc(draw_buf_bytes);
     
     // Alloceer grafiek buffers
-    graph_temps = (float*)malloc(GRAPH_POINTS * sizeof(float));
-    graph_times = (unsigned long*)malloc(GRAPH_POINTS * sizeof(unsigned long));
+    graph_temps = (TempQ*)malloc(GRAPH_POINTS * sizeof(TempQ));
+    graph_times = (MonoUs*)malloc(GRAPH_POINTS * sizeof(MonoUs));
     
     if (draw_buf && graph_temps && graph_times) {
         return true;
@@ -1106,13 +1139,13 @@ void UIController::initGraphData() {
         return;
     }
     for (int i = 0; i < GRAPH_POINTS; i++) {
-        graph_temps[i] = NAN;
-        graph_times[i] = 0;
+        graph_temps[i] = TEMP_Q_INVALID;
+        graph_times[i] = MONO_US_UNSET;
     }
     graph_write_index = 0;
     graph_count = 0;
     graph_data_ready = false;
-    graph_last_log_time = 0;
+    graph_last_log_time = MONO_US_UNSET;
     graph_force_rebuild = false;
     last_graph_update_ms = 0;
 }
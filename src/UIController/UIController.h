@@ -4,6 +4,8 @@
 #include <lvgl.h>
 #include <stdint.h>
 #include <math.h>  // Voor NAN
+#include "../TempSensor/TempQ.h"
+#include "../SystemClock/MonoClock.h"
 
 // Forward declarations voor externe functies
 // Deze worden later vervangen door callbacks
@@ -18,6 +20,7 @@ void t_bottom_plus_event(lv_event_t * e);
 void t_bottom_minus_event(lv_event_t * e);
 void temp_plus_event(lv_event_t * e);
 void temp_minus_event(lv_event_t * e);
+void profile_select_event(lv_event_t * e);
 void update_graph_y_axis_labels(void);
 
 class UIController {
@@ -38,6 +41,7 @@ public:
     void onTbottomMinus();
     void onTempOffsetPlus();
     void onTempOffsetMinus();
+    void onProfileButton();
     
     // Status updates
     void updateTemperature(float temp, float lastValidTemp);
@@ -70,15 +74,15 @@ public:
     lv_chart_series_t* getChartSeriesRising() const { return chart_series_rising; }
     lv_chart_series_t* getChartSeriesFalling() const { return chart_series_falling; }
     lv_obj_t* getYAxisLabel(int index) const { return (index >= 0 && index < 6) ? y_axis_labels[index] : nullptr; }
-    float* getGraphTemps() const { return graph_temps; }
-    unsigned long* getGraphTimes() const { return graph_times; }
+    TempQ* getGraphTemps() const { return graph_temps; }
+    MonoUs* getGraphTimes() const { return graph_times; }
     int getGraphWriteIndex() const { return graph_write_index; }
     int getGraphCount() const { return graph_count; }
     bool isGraphDataReady() const { return graph_data_ready; }
-    unsigned long getGraphLastLogTime() const { return graph_last_log_time; }
+    MonoUs getGraphLastLogTime() const { return graph_last_log_time; }
     bool isGraphForceRebuild() const { return graph_force_rebuild; }
     void setGraphForceRebuild(bool value) { graph_force_rebuild = value; }
-    void setGraphLastLogTime(unsigned long time) { graph_last_log_time = time; }
+    void setGraphLastLogTime(MonoUs time) { graph_last_log_time = time; }
     void setGraphWriteIndex(int index) { graph_write_index = index; }
     void setGraphCount(int count) { graph_count = count; }
     void setGraphDataReady(bool ready) { graph_data_ready = ready; }
@@ -113,11 +117,15 @@ public:
     void setTtopCallback(float (*cb)());  // Voor T_top waarde
     void setTbottomCallback(float (*cb)());  // Voor T_bottom waarde
     void setCyclusMaxCallback(int (*cb)());  // Voor cyclus_max waarde
+    typedef void (*ProfileSelectCallback)();  // Volgend opgeslagen profiel kiezen (of geen)
+    typedef const char* (*ProfileNameCallback)();  // nullptr = geen profiel
+    void setProfileSelectCallback(ProfileSelectCallback cb) { profileSelectCallback = cb; }
+    void setProfileNameCallback(ProfileNameCallback cb) { profileNameCallback = cb; }
 
 private:
     void fillChart();
     void clearChart();
-    void addChartPoint(int index, float tempValue, int chartValue);
+    void addChartPoint(int index, TempQ tempValue, int chartValue);
     bool allocateBuffers();
     void initGraphData();
     void updateGraphYAxis();  // Voor update_graph_y_axis_labels()
@@ -151,6 +159,8 @@ private:
     float (*ttopCallback)();
     float (*tbottomCallback)();
     int (*cyclusMaxCallback)();
+    ProfileSelectCallback profileSelectCallback;
+    ProfileNameCallback profileNameCallback;
     
     // LVGL objecten - Main screen
     lv_obj_t* screen_main;
@@ -175,6 +185,8 @@ private:
     lv_obj_t* btn_temp_minus;
     lv_obj_t* btn_cyclus_plus;
     lv_obj_t* btn_cyclus_minus;
+    lv_obj_t* text_label_profile;
+    lv_obj_t* btn_profile;
     lv_obj_t* init_status_label;
     lv_obj_t* wifi_status_label;
     lv_obj_t* gs_status_label;
@@ -190,13 +202,13 @@ private:
     lv_chart_series_t* chart_series_falling;
     lv_obj_t* y_axis_labels[6];
     
-    // Grafiek data
-    float* graph_temps;
-    unsigned long* graph_times;
+    // Grafiek data (temperaturen in kwart graden: 2 bytes per punt)
+    TempQ* graph_temps;
+    MonoUs* graph_times;             // MONO_US_UNSET = leeg punt
     int graph_write_index;
     int graph_count;
     bool graph_data_ready;
-    unsigned long graph_last_log_time;
+    MonoUs graph_last_log_time;
     unsigned long last_graph_update_ms;
     bool graph_force_rebuild;
     
@@ -213,7 +225,7 @@ private:
     
     // Timers voor updates
     unsigned long last_display_ms;
-    unsigned long last_displayed_time;  // Voor grafiek updates
+    MonoUs last_displayed_time;  // Voor grafiek updates (MONO_US_UNSET = nog niets getoond)
 };
 
 #endif // UICONTROLLER_H
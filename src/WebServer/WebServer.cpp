@@ -3,13 +3,15 @@
 #include "../CycleController/CycleController.h"
 #include "../TempSensor/TempSensor.h"
 #include "../UIController/UIController.h"
+#include "../SampleHistory/SampleHistory.h"
+#include "../SafetySupervisor/SafetySupervisor.h"
 #include <Arduino.h>
 #include <stdlib.h>
 #include <string.h>
 
 ConfigWebServer::ConfigWebServer(int port) 
     : server(port), settingsStore(nullptr), cycleController(nullptr), 
-      tempSensor(nullptr), uiController(nullptr),
+      tempSensor(nullptr), uiController(nullptr), sampleHistory(nullptr), safetySupervisor(nullptr),
       startCallback(nullptr), stopCallback(nullptr), settingsChangeCallback(nullptr),
       getCurrentTempCallback(nullptr), getMedianTempCallback(nullptr),
       isActiveCallback(nullptr), isHeatingCallback(nullptr),
@@ -18,7 +20,11 @@ ConfigWebServer::ConfigWebServer(int port)
       getTempOffsetCallback(nullptr), getClientEmailCallback(nullptr),
       getProjectIdCallback(nullptr), getPrivateKeyCallback(nullptr),
       getSpreadsheetIdCallback(nullptr), getNtfyTopicCallback(nullptr),
-      getNtfySettingsCallback(nullptr), saveNtfySettingsCallback(nullptr) {
+      getNtfySettingsCallback(nullptr), saveNtfySettingsCallback(nullptr),
+      getPidTuningCallback(nullptr), savePidTuningCallback(nullptr),
+      getProfileCallback(nullptr), saveProfileCallback(nullptr),
+      getActiveProfileCallback(nullptr), selectProfileCallback(nullptr),
+      startAutoTuneCallback(nullptr) {
 }
 
 void ConfigWebServer::begin() {
@@ -29,6 +35,15 @@ void ConfigWebServer::begin() {
     server.on("/start", HTTP_POST, [this]() { handleStart(); });
     server.on("/stop", HTTP_POST, [this]() { handleStop(); });
     server.on("/save", HTTP_POST, [this]() { handleSaveSettings(); });
+    server.on("/history.csv", HTTP_GET, [this]() { handleHistoryCsv(); });
+    server.on("/history.bin", HTTP_GET, [this]() { handleHistoryBin(); });
+    server.on("/pid", HTTP_GET, [this]() { handleGetPid(); });
+    server.on("/pid", HTTP_POST, [this]() { handleSavePid(); });
+    server.on("/profiles", HTTP_GET, [this]() { handleGetProfiles(); });
+    server.on("/profile", HTTP_POST, [this]() { handleSaveProfile(); });
+    server.on("/autotune", HTTP_GET, [this]() { handleGetAutoTune(); });
+    server.on("/autotune", HTTP_POST, [this]() { handleStartAutoTune(); });
+    server.on("/cyclestats", HTTP_GET, [this]() { handleCycleStats(); });
     
     server.begin();
 }
@@ -55,7 +70,7 @@ void ConfigWebServer::handleSettings() {
         response += ",\"tBottom\":25.0";
     }
     if (getTempOffsetCallback) {
-        response += ",\"tempOffset\":" + String(getTempOffsetCallback(), 1);
+        response += ",\"tempOffset\":" + String(getTempOffsetCallback(), 2);
     } else {
         response += ",\"tempOffset\":0.0";
     }
@@ -132,6 +147,301 @@ void ConfigWebServer::handleStatus() {
     server.send(200, "application/json", generateStatusJSON());
 }
 
+bool ConfigWebServer::getHistoryRange(uint32_t& first, uint32_t& end) {
+    if (sampleHistory == nullptr || sampleHistory->getCapacity() == 0) {
+        server.send(503, "text/plain", "Sample history niet beschikbaar");
+        return false;
+    }
+    
+    // ?since=<seq> voor incrementeel ophalen, anders vanaf het oudste record
+    end = sampleHistory->getWrittenCount();
+    first = sampleHistory->getOldestSeq();
+    if (server.hasArg("since")) {
+        uint32_t since = (uint32_t)strtoul(server.arg("since").c_str(), nullptr, 10);
+        if (since > first) first = since;
+    }
+    if (first > end) first = end;
+    if (end - first > HISTORY_EXPORT_MAX_RECORDS) {
+        end = first + HISTORY_EXPORT_MAX_RECORDS;
+    }
+    
+    // Volgende ?since= waarde voor de client
+    server.sendHeader("X-History-Next", String((unsigned long)end).c_str());
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    return true;
+}
+
+void ConfigWebServer::handleHistoryCsv() {
+    uint32_t first, end;
+    if (!getHistoryRange(first, end)) return;
+    server.send(200, "text/csv", "seq,timestamp_ms,raw_c,filtered_c\n");
+    
+    // Chunks van een vaste stack buffer: geen String groei over duizenden regels
+    char chunk[1024];
+    size_t len = 0;
+    for (uint32_t seq = first; seq < end; seq++) {
+        SampleRecord rec;
+        if (!sampleHistory->getRecord(seq, rec)) continue; // Tijdens export overschreven
+        
+        char raw_str[12] = "";
+        char filtered_str[12] = "";
+        if (isValidQ(rec.raw)) snprintf(raw_str, sizeof(raw_str), "%.2f", tempFromQ(rec.raw));
+        if (isValidQ(rec.filtered)) snprintf(filtered_str, sizeof(filtered_str), "%.2f", tempFromQ(rec.filtered));
+        
+        if (len > sizeof(chunk) - 64) {
+            server.sendContent(chunk, len);
+            len = 0;
+            yield();
+        }
+        len += snprintf(chunk + len, sizeof(chunk) - len, "%lu,%lu,%s,%s\n",
+                        (unsigned long)seq, (unsigned long)rec.timestampMs, raw_str, filtered_str);
+    }
+    if (len > 0) {
+        server.sendContent(chunk, len);
+    }
+    server.sendContent(""); // Einde chunked response
+}
+
+void ConfigWebServer::handleHistoryBin() {
+    uint32_t first, end;
+    if (!getHistoryRange(first, end)) return;
+    server.send(200, "application/octet-stream", "");
+    
+    // Ruwe SampleRecord structs (8 bytes, little-endian, layout zie SampleHistory.h)
+    // Overschreven records worden overgeslagen; het timestamp veld blijft oplopend
+    SampleRecord chunk[128];
+    size_t count = 0;
+    for (uint32_t seq = first; seq < end; seq++) {
+        if (!sampleHistory->getRecord(seq, chunk[count])) continue;
+        if (++count == sizeof(chunk) / sizeof(chunk[0])) {
+            server.sendContent((const char*)chunk, count * sizeof(SampleRecord));
+            count = 0;
+            yield();
+        }
+    }
+    if (count > 0) {
+        server.sendContent((const char*)chunk, count * sizeof(SampleRecord));
+    }
+    server.sendContent("");
+}
+
+void ConfigWebServer::handleGetPid() {
+    PidTuning tuning = getPidTuningCallback ? getPidTuningCallback() : PidTuning();
+    String response = "{\"enabled\":" + String(tuning.enabled ? "true" : "false");
+    response += ",\"kp\":" + String(tuning.kp, 4);
+    response += ",\"ki\":" + String(tuning.ki, 6);
+    response += ",\"kd\":" + String(tuning.kd, 3);
+    response += ",\"windowMs\":" + String((unsigned long)tuning.windowMs);
+    response += ",\"rampCPerMin\":" + String(tuning.rampCPerMin, 2);
+    response += ",\"holdSeconds\":" + String((unsigned long)tuning.holdSeconds);
+    response += "}";
+    server.send(200, "application/json", response);
+}
+
+void ConfigWebServer::handleSavePid() {
+    String body = server.hasArg("plain") ? server.arg("plain") : "";
+    if (body.length() == 0 || savePidTuningCallback == nullptr) {
+        server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Geen data ontvangen\"}");
+        return;
+    }
+    
+    // Ontbrekende velden behouden hun huidige waarde
+    PidTuning tuning = getPidTuningCallback ? getPidTuningCallback() : PidTuning();
+    String value;
+    if (parseJsonValue(body, "\"enabled\"", value)) tuning.enabled = (value == "true" || value == "1");
+    if (parseJsonValue(body, "\"kp\"", value)) tuning.kp = value.toFloat();
+    if (parseJsonValue(body, "\"ki\"", value)) tuning.ki = value.toFloat();
+    if (parseJsonValue(body, "\"kd\"", value)) tuning.kd = value.toFloat();
+    if (parseJsonValue(body, "\"windowMs\"", value)) tuning.windowMs = (uint32_t)value.toInt();
+    if (parseJsonValue(body, "\"rampCPerMin\"", value)) tuning.rampCPerMin = value.toFloat();
+    if (parseJsonValue(body, "\"holdSeconds\"", value)) tuning.holdSeconds = (uint32_t)value.toInt();
+    
+    if (tuning.kp < 0.0f || tuning.ki < 0.0f || tuning.kd < 0.0f || tuning.rampCPerMin < 0.0f ||
+        tuning.windowMs < 500 || tuning.windowMs > 10000) {
+        server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Ongeldige PID waarden\"}");
+        return;
+    }
+    
+    savePidTuningCallback(tuning);
+    server.send(200, "application/json", "{\"status\":\"ok\",\"message\":\"PID instellingen opgeslagen\"}");
+}
+
+bool ConfigWebServer::parseJsonValue(const String& body, const char* key, String& value) {
+    // Platte JSON: waarde tot de volgende ',' of '}' (strings zonder komma's), quotes verwijderd
+    int keyIdx = body.indexOf(key);
+    if (keyIdx < 0) return false;
+    int colonIdx = body.indexOf(':', keyIdx);
+    int commaIdx = body.indexOf(',', colonIdx);
+    int endIdx = body.indexOf('}', colonIdx);
+    if (commaIdx < 0 || commaIdx > endIdx) commaIdx = endIdx;
+    if (colonIdx < 0 || commaIdx <= colonIdx) return false;
+    value = body.substring(colonIdx + 1, commaIdx);
+    value.trim();
+    if (value.length() >= 2 && value.charAt(0) == '"' && value.charAt(value.length() - 1) == '"') {
+        value = value.substring(1, value.length() - 1);
+    }
+    return true;
+}
+
+void ConfigWebServer::handleGetProfiles() {
+    int active = getActiveProfileCallback ? getActiveProfileCallback() : -1;
+    String response = "{\"active\":" + String(active);
+    if (cycleController != nullptr) {
+        response += ",\"running\":" + String(cycleController->isProfileRunning() ? "true" : "false");
+    }
+    response += ",\"maxSegments\":" + String(PROFILE_MAX_SEGMENTS);
+    response += ",\"profiles\":[";
+    for (int slot = 0; slot < PROFILE_SLOTS; slot++) {
+        if (slot > 0) response += ",";
+        CycleProfile profile;
+        if (getProfileCallback == nullptr || !getProfileCallback(slot, profile)) {
+            response += "null";
+            continue;
+        }
+        char segments[PROFILE_MAX_SEGMENTS * 32];
+        formatCycleProfile(profile, segments, sizeof(segments));
+        response += "{\"slot\":" + String(slot);
+        response += ",\"name\":\"" + String(profile.name) + "\"";
+        response += ",\"segments\":\"" + String(segments) + "\"}";
+    }
+    response += "]}";
+    server.send(200, "application/json", response);
+}
+
+void ConfigWebServer::handleSaveProfile() {
+    String body = server.hasArg("plain") ? server.arg("plain") : "";
+    if (body.length() == 0 || saveProfileCallback == nullptr || selectProfileCallback == nullptr) {
+        server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Geen data ontvangen\"}");
+        return;
+    }
+    
+    // {"slot":n,"name":"...","segments":"H120r5h600;C30x50@0"} slaat op, "segments":"" wist het slot,
+    // {"active":n} kiest het profiel voor de volgende START (-1 = geen profiel)
+    String value;
+    if (parseJsonValue(body, "\"slot\"", value)) {
+        int slot = value.toInt();
+        String segments;
+        if (slot < 0 || slot >= PROFILE_SLOTS || !parseJsonValue(body, "\"segments\"", segments)) {
+            server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Ongeldig slot\"}");
+            return;
+        }
+        if (segments.length() == 0) {
+            saveProfileCallback(slot, nullptr);
+        } else {
+            String name;
+            if (!parseJsonValue(body, "\"name\"", name)) name = "Profiel " + String(slot + 1);
+            CycleProfile profile;
+            if (!parseCycleProfile(segments.c_str(), name.c_str(), profile) || !saveProfileCallback(slot, &profile)) {
+                server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Ongeldig profiel\"}");
+                return;
+            }
+        }
+    }
+    if (parseJsonValue(body, "\"active\"", value) && !selectProfileCallback(value.toInt())) {
+        server.send(409, "application/json", "{\"status\":\"error\",\"message\":\"Profiel loopt, eerst STOP\"}");
+        return;
+    }
+    server.send(200, "application/json", "{\"status\":\"ok\",\"message\":\"Profiel opgeslagen\"}");
+}
+
+String ConfigWebServer::generateAutoTuneJSON() {
+    static const char* STATUS_NAMES[] = { "idle", "heatup", "relay", "done", "failed" };
+    AutoTuneStatus status = cycleController->getAutoTuneStatus();
+    String response = "{\"status\":\"" + String(STATUS_NAMES[(uint8_t)status]) + "\"";
+    response += ",\"running\":" + String(cycleController->getState() == CycleState::AUTOTUNE ? "true" : "false");
+    response += ",\"cycles\":" + String(cycleController->getAutoTuneCycles());
+    response += ",\"cyclesTotal\":" + String(AUTOTUNE_RELAY_CYCLES);
+    
+    // Laatst geschatte (of opgeslagen) model
+    const PlantModel& model = cycleController->getPlantModel();
+    if (model.valid) {
+        response += ",\"model\":{\"gainC\":" + String(model.gainC, 1);
+        response += ",\"tauS\":" + String(model.tauS, 1);
+        response += ",\"deadTimeS\":" + String(model.deadTimeS, 1);
+        if (!isnan(model.ultimateGain)) {
+            response += ",\"ku\":" + String(model.ultimateGain, 4);
+        }
+        response += ",\"puS\":" + String(model.ultimatePeriodS, 1);
+        response += ",\"ambientC\":" + String(model.ambientC, 1);
+        response += ",\"setpointC\":" + String(model.setpointC, 1) + "}";
+    }
+    response += "}";
+    return response;
+}
+
+void ConfigWebServer::handleGetAutoTune() {
+    if (cycleController == nullptr) {
+        server.send(503, "application/json", "{\"status\":\"error\",\"message\":\"Geen controller\"}");
+        return;
+    }
+    server.send(200, "application/json", generateAutoTuneJSON());
+}
+
+void ConfigWebServer::handleStartAutoTune() {
+    String body = server.hasArg("plain") ? server.arg("plain") : "";
+    String value;
+    if (startAutoTuneCallback == nullptr || !parseJsonValue(body, "\"setpoint\"", value)) {
+        server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Geen setpoint ontvangen\"}");
+        return;
+    }
+    float setpoint = value.toFloat();
+    if (setpoint <= 0.0f || setpoint > TEMP_MAX) {
+        server.send(400, "application/json", "{\"status\":\"error\",\"message\":\"Ongeldig setpoint\"}");
+        return;
+    }
+    if (!startAutoTuneCallback(setpoint)) {
+        // Niet uit, of al te warm om een afkoelhelling te meten
+        server.send(409, "application/json", "{\"status\":\"error\",\"message\":\"Autotune alleen vanuit Uit, minimaal 10°C onder het setpoint\"}");
+        return;
+    }
+    server.send(200, "application/json", "{\"status\":\"ok\",\"message\":\"Autotune gestart\"}");
+}
+
+// Getal of null (NAN / TEMP_Q_INVALID) voor JSON
+static String jsonNumber(float value, unsigned int decimals) {
+    return isnan(value) ? String("null") : String(value, decimals);
+}
+
+void ConfigWebServer::handleCycleStats() {
+    if (cycleController == nullptr) {
+        server.send(503, "application/json", "{\"status\":\"error\",\"message\":\"Geen controller\"}");
+        return;
+    }
+    static const char* METRIC_NAMES[] = { "heatMs", "coolMs", "heaterOnMs", "peak", "trough", "overshoot" };
+    static_assert(sizeof(METRIC_NAMES) / sizeof(METRIC_NAMES[0]) == (int)CycleMetric::COUNT, "METRIC_NAMES aanvullen");
+    const CycleStats& stats = cycleController->getCycleStats();
+    
+    // Samenvatting over de hele run: tijden in ms, temperaturen in °C
+    String response = "{\"count\":" + String(stats.getCount()) + ",\"metrics\":{";
+    for (int m = 0; m < (int)CycleMetric::COUNT; m++) {
+        CycleMetricSummary summary = stats.getSummary((CycleMetric)m);
+        unsigned int decimals = (m <= (int)CycleMetric::HEATER_ON_MS) ? 0 : 2;
+        if (m > 0) response += ",";
+        response += "\"" + String(METRIC_NAMES[m]) + "\":{\"n\":" + String(summary.count);
+        response += ",\"min\":" + jsonNumber(summary.min, decimals);
+        response += ",\"max\":" + jsonNumber(summary.max, decimals);
+        response += ",\"p50\":" + jsonNumber(summary.p50, decimals);
+        response += ",\"p90\":" + jsonNumber(summary.p90, decimals);
+        response += ",\"p99\":" + jsonNumber(summary.p99, decimals) + "}";
+    }
+    
+    // Laatste cycli, nieuwste eerst
+    response += "},\"recent\":[";
+    for (int age = 0; age < stats.getRecordCount(); age++) {
+        const CycleRecord& record = stats.getRecord(age);
+        if (age > 0) response += ",";
+        response += "{\"cycle\":" + String(record.cycle);
+        response += ",\"heatMs\":" + String(record.heatMs);
+        response += ",\"coolMs\":" + String(record.coolMs);
+        response += ",\"heaterOnMs\":" + String(record.heaterOnMs);
+        response += ",\"peak\":" + jsonNumber(tempFromQ(record.peak), 2);
+        response += ",\"trough\":" + jsonNumber(tempFromQ(record.trough), 2);
+        response += ",\"overshoot\":" + jsonNumber(tempFromQ(record.overshoot), 2) + "}";
+    }
+    response += "]}";
+    server.send(200, "application/json", response);
+}
+
 void ConfigWebServer::handleStart() {
     if (startCallback) {
         startCallback();
@@ -345,6 +655,108 @@ String ConfigWebServer::generateStatusJSON() {
         }
     }
     
+    // Stijgsnelheid uit alpha-beta schatter (alleen als schatter aan staat)
+    if (tempSensor != nullptr) {
+        float rate = tempSensor->getRate();
+        if (!isnan(rate)) {
+            response += ",\"tempRate\":" + String(rate, 2);
+        }
+    }
+    
+    // Sensor gezondheid (fouten per oorzaak + read duur histogram)
+    if (tempSensor != nullptr) {
+        TempSensorHealth health = tempSensor->getHealth();
+        response += ",\"sensorHealth\":{\"reads\":" + String(health.reads);
+        response += ",\"openCircuit\":" + String(health.openCircuit);
+        response += ",\"outOfRange\":" + String(health.outOfRange);
+        response += ",\"outliers\":" + String(health.outliers);
+        response += ",\"busErrors\":" + String(health.busErrors);
+        response += ",\"notReady\":" + String(health.notReady);
+        response += ",\"retries\":" + String(health.retries);
+        response += ",\"maxLatencyUs\":" + String(health.maxLatencyUs);
+        response += ",\"latencyBuckets\":[";
+        for (int i = 0; i < TempSensorHealth::LATENCY_BUCKETS; i++) {
+            if (i > 0) response += ",";
+            response += String(health.latencyBuckets[i]);
+        }
+        response += "]}";
+        
+        // Gemeten sample periode (µs tijdstempels) en afwijking t.o.v. de geplande periode
+        TempSensorJitterStats jitter = tempSensor->getJitterStats();
+        response += ",\"sampleJitter\":{\"periods\":" + String(jitter.periods);
+        response += ",\"minPeriodUs\":" + String(jitter.minPeriodUs);
+        response += ",\"maxPeriodUs\":" + String(jitter.maxPeriodUs);
+        response += ",\"buckets\":[";
+        for (int i = 0; i < TempSensorJitterStats::BUCKETS; i++) {
+            if (i > 0) response += ",";
+            response += String(jitter.buckets[i]);
+        }
+        response += "]}";
+    }
+    
+    // Voorspelde vs gemeten piek van de laatste opwarmfase (geleerde naloop)
+    if (cycleController != nullptr) {
+        PeakPrediction peak = cycleController->getLastPeak();
+        response += ",\"peak\":{\"predictive\":" + String(cycleController->isPredictiveCutoff() ? "true" : "false");
+        response += ",\"lagS\":" + String(peak.lagSeconds, 1);
+        response += ",\"cycles\":" + String(peak.cycles);
+        if (!isnan(peak.actualPeak)) {
+            response += ",\"cutoff\":" + String(peak.cutoffTemp, 2);
+            response += ",\"actual\":" + String(peak.actualPeak, 2);
+        }
+        if (!isnan(peak.predictedPeak)) {
+            response += ",\"predicted\":" + String(peak.predictedPeak, 2);
+        }
+        response += "}";
+        
+        // PID modus: huidige duty en (helling) setpoint
+        if (cycleController->getPidTuning().enabled) {
+            response += ",\"pid\":{\"duty\":" + String(cycleController->getPidDuty(), 3);
+            float setpoint = cycleController->getPidSetpoint();
+            if (!isnan(setpoint)) {
+                response += ",\"setpoint\":" + String(setpoint, 2);
+            }
+            response += "}";
+        }
+        
+        // Ramp/soak profiel: naam, huidig segment (0-based) en doorloop van het herhaalblok
+        if (cycleController->hasProfile()) {
+            response += ",\"profile\":{\"name\":\"" + String(cycleController->getProfile().name) + "\"";
+            response += ",\"running\":" + String(cycleController->isProfileRunning() ? "true" : "false");
+            if (cycleController->isProfileRunning()) {
+                response += ",\"segment\":" + String(cycleController->getProfileSegment());
+                response += ",\"loop\":" + String(cycleController->getProfileLoop());
+            }
+            response += "}";
+        }
+        
+        // Autotune voortgang en model
+        response += ",\"autotune\":" + generateAutoTuneJSON();
+        
+        // SSR paar: schakelcycli en totale aan-tijd per relais
+        const RelayActuator& relays = cycleController->getRelays();
+        RelayStats heater = relays.getStats(RelayChannel::HEATER);
+        RelayStats cooler = relays.getStats(RelayChannel::COOLER);
+        response += ",\"relays\":{\"heater\":{\"switches\":" + String(heater.switchCount);
+        response += ",\"onTimeS\":" + String((unsigned long)(heater.onTimeMs / 1000)) + "}";
+        response += ",\"cooler\":{\"switches\":" + String(cooler.switchCount);
+        response += ",\"onTimeS\":" + String((unsigned long)(cooler.onTimeMs / 1000)) + "}";
+        response += ",\"deadTimeMs\":" + String(relays.getDeadTimeMs());
+        response += ",\"deadTimeWaits\":" + String(relays.getDeadTimeWaits()) + "}";
+    }
+    
+    // Onafhankelijke bewaking: trip en gemeten reactietijden (µs)
+    if (safetySupervisor != nullptr) {
+        SafetySupervisorStats stats = safetySupervisor->getStats();
+        response += ",\"supervisor\":{\"trip\":\"" + String(SafetySupervisor::tripName(safetySupervisor->getTrip())) + "\"";
+        response += ",\"trips\":" + String(stats.trips);
+        response += ",\"checks\":" + String(stats.checks);
+        response += ",\"maxCheckIntervalUs\":" + String(stats.maxCheckIntervalUs);
+        response += ",\"maxCheckUs\":" + String(stats.maxCheckUs);
+        response += ",\"lastReactionUs\":" + String(stats.lastReactionUs);
+        response += ",\"maxReactionUs\":" + String(stats.maxReactionUs) + "}";
+    }
+    
     if (isActiveCallback) {
         response += ",\"isActive\":" + String(isActiveCallback() ? "true" : "false");
     }
@@ -370,7 +782,7 @@ String ConfigWebServer::generateStatusJSON() {
     }
     
     if (getTempOffsetCallback) {
-        response += ",\"tempOffset\":" + String(getTempOffsetCallback(), 1);
+        response += ",\"tempOffset\":" + String(getTempOffsetCallback(), 2);
     }
     
     response += "}";
@@ -610,7 +1022,7 @@ String ConfigWebServer::generateHTML() {
                     </div>
                     <div class="form-group">
                         <label for="tempOffset">Temperatuur Offset (°C):</label>
-                        <input type="number" id="tempOffset" name="tempOffset" step="0.1" min="-10" max="10" required>
+                        <input type="number" id="tempOffset" name="tempOffset" step="0.25" min="-10" max="10" required>
                         <small style="color: #666; display: block; margin-top: 4px;">Kalibratie offset voor temperatuursensor. Wordt toegepast op alle metingen om systematische afwijkingen te corrigeren (bijv. +2.5°C als sensor 2.5°C te laag meet).</small>
                     </div>
                     <div class="form-group">
@@ -623,6 +1035,28 @@ String ConfigWebServer::generateHTML() {
                 </form>
             </div>
             
+            <div class="section">
+                <h2>🔧 Autotune</h2>
+                <div class="form-group">
+                    <label for="autotuneSetpoint">Setpoint (°C):</label>
+                    <input type="number" id="autotuneSetpoint" step="1" min="30" max="350" value="80">
+                    <small style="color: #666; display: block; margin-top: 4px;">Verwarming schakelt als relais rond het setpoint tot het model (K, tau, dode tijd) bekend is. Start vanuit een afgekoelde opstelling; daarna volgt veiligheidskoeling. Het model zet de PID waarden en de naloop van de voorspellende uitschakeling.</small>
+                </div>
+                <div class="status">
+                    <div class="status-item">
+                        <span class="status-label">Autotune:</span>
+                        <span class="status-value" id="autotuneStatus">--</span>
+                    </div>
+                    <div class="status-item">
+                        <span class="status-label">Model:</span>
+                        <span class="status-value" id="autotuneModel">--</span>
+                    </div>
+                </div>
+                <div class="button-group">
+                    <button type="button" id="autotuneBtn" class="btn-primary">🔧 Start Autotune</button>
+                </div>
+            </div>
+            
             <div class="section">
                 <h2>📊 Google Sheets Configuratie</h2>
                 <form id="googleForm">
@@ -735,6 +1169,17 @@ String ConfigWebServer::generateHTML() {
                     document.getElementById('cycleCount').textContent = 
                         data.cycleCount !== undefined ? data.cycleCount : '--';
                     
+                    if (data.autotune) {
+                        const at = data.autotune;
+                        const names = { idle: 'Niet gedaan', heatup: 'Opwarmen', relay: 'Oscillatie',
+                                        done: 'Klaar', failed: 'Mislukt' };
+                        document.getElementById('autotuneStatus').textContent = (names[at.status] || at.status) +
+                            (at.status === 'relay' ? ' (' + at.cycles + '/' + at.cyclesTotal + ')' : '');
+                        document.getElementById('autotuneModel').textContent = at.model ?
+                            'K ' + at.model.gainC.toFixed(0) + '°C, tau ' + at.model.tauS.toFixed(0) +
+                            ' s, L ' + at.model.deadTimeS.toFixed(1) + ' s' : '--';
+                    }
+                    
                     // Update knop kleuren op basis van isActive status
                     const startBtn = document.getElementById('startBtn');
                     const stopBtn = document.getElementById('stopBtn');
@@ -865,6 +1310,20 @@ String ConfigWebServer::generateHTML() {
             }
         });
         
+        document.getElementById('autotuneBtn').addEventListener('click', async () => {
+            try {
+                const response = await fetch('/autotune', {
+                    method: 'POST',
+                    headers: { 'Content-Type': 'application/json' },
+                    body: JSON.stringify({ setpoint: parseFloat(document.getElementById('autotuneSetpoint').value) })
+                });
+                const result = await response.json();
+                showMessage(result.message || 'Autotune gestart', result.status !== 'ok');
+            } catch (error) {
+                showMessage('Fout bij starten autotune: ' + error.message, true);
+            }
+        });
+        
         function resetNtfyTopic() {
             // Reset naar standaard topic
             const defaultTopic = 'VGGM-KOOIKLEM';
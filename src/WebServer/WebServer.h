@@ -4,12 +4,22 @@
 #include <WebServer.h>
 #include <Arduino.h>
 #include "../NtfyNotifier/NtfyNotifier.h"
+#include "../PidController/PidController.h"
+#include "../CycleController/CycleProfile.h"
+
+// Maximaal aantal history records per export request (client pagineert met ?since=)
+// Houdt de blokkade van loop() per request beperkt (~8192 records = ~250 KB CSV)
+#ifndef HISTORY_EXPORT_MAX_RECORDS
+#define HISTORY_EXPORT_MAX_RECORDS 8192
+#endif
 
 // Forward declarations
 class SettingsStore;
 class CycleController;
 class TempSensor;
 class UIController;
+class SampleHistory;
+class SafetySupervisor;
 
 class ConfigWebServer {
 public:
@@ -22,6 +32,8 @@ public:
     void setCycleController(CycleController* controller) { cycleController = controller; }
     void setTempSensor(TempSensor* sensor) { tempSensor = sensor; }
     void setUIController(UIController* controller) { uiController = controller; }
+    void setSampleHistory(SampleHistory* history) { sampleHistory = history; }
+    void setSafetySupervisor(SafetySupervisor* supervisor) { safetySupervisor = supervisor; }
     
     // Callbacks voor acties
     typedef void (*StartCallback)();
@@ -54,6 +66,26 @@ public:
     typedef NtfyNotificationSettings (*GetNtfySettingsCallback)();
     typedef void (*SaveNtfySettingsCallback)(const char* topic, const NtfyNotificationSettings& settings);
     
+    // PID tuning callbacks (GET/POST /pid)
+    typedef PidTuning (*GetPidTuningCallback)();
+    typedef void (*SavePidTuningCallback)(const PidTuning& tuning);
+    void setGetPidTuningCallback(GetPidTuningCallback cb) { getPidTuningCallback = cb; }
+    void setSavePidTuningCallback(SavePidTuningCallback cb) { savePidTuningCallback = cb; }
+    
+    // Ramp/soak profiel callbacks (GET /profiles, POST /profile)
+    typedef bool (*GetProfileCallback)(int slot, CycleProfile& profile);          // false = leeg slot
+    typedef bool (*SaveProfileCallback)(int slot, const CycleProfile* profile);   // nullptr = slot wissen
+    typedef int (*GetActiveProfileCallback)();                                    // -1 = geen profiel
+    typedef bool (*SelectProfileCallback)(int slot);                              // false = profiel loopt nog
+    void setGetProfileCallback(GetProfileCallback cb) { getProfileCallback = cb; }
+    void setSaveProfileCallback(SaveProfileCallback cb) { saveProfileCallback = cb; }
+    void setGetActiveProfileCallback(GetActiveProfileCallback cb) { getActiveProfileCallback = cb; }
+    void setSelectProfileCallback(SelectProfileCallback cb) { selectProfileCallback = cb; }
+    
+    // Autotune (GET/POST /autotune): model en voortgang komen rechtstreeks uit de CycleController
+    typedef bool (*StartAutoTuneCallback)(float setpointC);                       // false = systeem niet uit
+    void setStartAutoTuneCallback(StartAutoTuneCallback cb) { startAutoTuneCallback = cb; }
+    
     void setGetCurrentTempCallback(GetCurrentTempCallback cb) { getCurrentTempCallback = cb; }
     void setGetMedianTempCallback(GetMedianTempCallback cb) { getMedianTempCallback = cb; }
     void setIsActiveCallback(IsActiveCallback cb) { isActiveCallback = cb; }
@@ -79,6 +111,8 @@ private:
     CycleController* cycleController;
     TempSensor* tempSensor;
     UIController* uiController;
+    SampleHistory* sampleHistory;
+    SafetySupervisor* safetySupervisor;
     
     // Callbacks
     StartCallback startCallback;
@@ -100,6 +134,13 @@ private:
     GetNtfyTopicCallback getNtfyTopicCallback;
     GetNtfySettingsCallback getNtfySettingsCallback;
     SaveNtfySettingsCallback saveNtfySettingsCallback;
+    GetPidTuningCallback getPidTuningCallback;
+    SavePidTuningCallback savePidTuningCallback;
+    GetProfileCallback getProfileCallback;
+    SaveProfileCallback saveProfileCallback;
+    GetActiveProfileCallback getActiveProfileCallback;
+    SelectProfileCallback selectProfileCallback;
+    StartAutoTuneCallback startAutoTuneCallback;
     
     // Handler functies
     void handleRoot();
@@ -108,6 +149,18 @@ private:
     void handleStart();
     void handleStop();
     void handleSaveSettings();
+    void handleHistoryCsv();
+    void handleHistoryBin();
+    void handleGetPid();
+    void handleSavePid();
+    void handleGetProfiles();
+    void handleSaveProfile();
+    void handleGetAutoTune();
+    void handleStartAutoTune();
+    String generateAutoTuneJSON();
+    void handleCycleStats();
+    static bool parseJsonValue(const String& body, const char* key, String& value);
+    bool getHistoryRange(uint32_t& first, uint32_t& end);
     
     // HTML generatie
     String generateHTML();
@@ -0,0 +1,152 @@
+// Warme herstart: checkpoint validatie en de crash loop bewaking van CycleController::resume().
+// Een "reset" is hier een nieuwe CycleController die het checkpoint van de vorige hervat.
+#include "HostTest.h"
+#include "HostMocks.h"
+#include "CycleController/CycleController.h"
+#include "CycleController/CycleCheckpoint.h"
+#include "TempSensor/TempSensor.h"
+#include "Logger/Logger.h"
+#include <string.h>
+
+static Logger g_logger;
+static CycleCheckpoint g_store;  // RTC geheugen
+
+static void runFor(TempSensor& sensor, CycleController& controller, uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += 10) {
+        hostAdvanceMs(10);
+        sensor.sample();
+        controller.update();
+    }
+}
+
+static void testValidation() {
+    CycleCheckpoint cp;
+    memset(&cp, 0xA5, sizeof(cp));  // Willekeurige inhoud na power-on
+    CHECK(!isValidCycleCheckpoint(cp));
+    memset(&cp, 0, sizeof(cp));
+    cp.state = (uint8_t)CycleState::HEATING;
+    sealCycleCheckpoint(cp);
+    CHECK(isValidCycleCheckpoint(cp));
+    cp.cycleCount++;  // Reset halverwege het schrijven: CRC klopt niet meer
+    CHECK(!isValidCycleCheckpoint(cp));
+    sealCycleCheckpoint(cp);
+    cp.version = CYCLE_CHECKPOINT_VERSION - 1;
+    CHECK(!isValidCycleCheckpoint(cp));
+    sealCycleCheckpoint(cp);
+    invalidateCycleCheckpoint(cp);
+    CHECK(!isValidCycleCheckpoint(cp));
+}
+
+// Reset na een korte tijd draaien: hervatten tot CYCLE_RESUME_MAX, daarna veiligheidskoeling
+static void testCrashLoop() {
+    hostSetTimeUs(1000000);
+    Max6675MockTransport mock;
+    mock.setCelsius(30.0f);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&mock);
+    sensor.begin();
+
+    {
+        CycleController first;
+        first.begin(&sensor, &g_logger, 5, 23);
+        first.setCheckpointStore(&g_store);
+        runFor(sensor, first, 1000);
+        first.start();
+        runFor(sensor, first, 5000);
+        CHECK(first.isHeating());
+        CHECK(isValidCycleCheckpoint(g_store));
+        CHECK_EQ(g_store.resumeCount, 0);
+    }
+
+    for (int restart = 1; restart <= CYCLE_RESUME_MAX; restart++) {
+        hostAdvanceMs(2000);  // Opstarten na de reset
+        CycleController controller;
+        controller.begin(&sensor, &g_logger, 5, 23);
+        controller.setCheckpointStore(&g_store);
+        CHECK(controller.resume(g_store));
+        CHECK(controller.isHeating());
+        CHECK(controller.getRelays().isOutputHigh(RelayChannel::HEATER));
+        CHECK_EQ(controller.getResumeCount(), restart);
+        CHECK_EQ(g_store.resumeCount, restart);
+        runFor(sensor, controller, 30000);  // Crasht weer binnen het venster
+    }
+
+    // Volgende reset: geweigerd, gelogd, verwarming uit en veiligheidskoeling
+    hostAdvanceMs(2000);
+    {
+        CycleController controller;
+        controller.begin(&sensor, &g_logger, 5, 23);
+        controller.setCheckpointStore(&g_store);
+        CHECK(!controller.resume(g_store));
+        CHECK(controller.isSafetyCooling());
+        CHECK(strstr(hostLastLogStatus(), "geweigerd") != nullptr);
+        controller.update();
+        CHECK(!controller.getRelays().isOutputHigh(RelayChannel::HEATER));
+        CHECK(controller.getRelays().isOutputHigh(RelayChannel::COOLER));
+        CHECK(isValidCycleCheckpoint(g_store));
+        CHECK_EQ(g_store.resumeCount, CYCLE_RESUME_MAX);
+    }
+
+    // Reset tijdens die veiligheidskoeling: weer geweigerd, nooit terug naar verwarmen
+    hostAdvanceMs(2000);
+    {
+        CycleController controller;
+        controller.begin(&sensor, &g_logger, 5, 23);
+        controller.setCheckpointStore(&g_store);
+        CHECK(!controller.resume(g_store));
+        CHECK(controller.isSafetyCooling());
+        CHECK(!controller.getRelays().isOutputHigh(RelayChannel::HEATER));
+
+        // Bewuste START wist de teller
+        controller.start();
+        CHECK(controller.isHeating());
+        CHECK_EQ(controller.getResumeCount(), 0);
+        CHECK_EQ(g_store.resumeCount, 0);
+    }
+}
+
+// Na CYCLE_RESUME_WINDOW_MS stabiel draaien telt een volgende reset weer als eerste
+static void testStableWindow() {
+    hostSetTimeUs(1000000);
+    Max6675MockTransport mock;
+    mock.setCelsius(30.0f);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&mock);
+    sensor.begin();
+    {
+        CycleController first;
+        first.begin(&sensor, &g_logger, 5, 23);
+        first.setCheckpointStore(&g_store);
+        runFor(sensor, first, 1000);
+        first.start();
+        runFor(sensor, first, 2000);
+    }
+    g_store.resumeCount = CYCLE_RESUME_MAX - 1;  // Al een paar herstarts achter de rug
+    sealCycleCheckpoint(g_store);
+
+    hostAdvanceMs(2000);
+    CycleController controller;
+    controller.begin(&sensor, &g_logger, 5, 23);
+    controller.setCheckpointStore(&g_store);
+    CHECK(controller.resume(g_store));
+    CHECK_EQ(controller.getResumeCount(), CYCLE_RESUME_MAX);
+    runFor(sensor, controller, CYCLE_RESUME_WINDOW_MS - 10000);
+    CHECK_EQ(g_store.resumeCount, CYCLE_RESUME_MAX);  // Nog binnen het venster
+    runFor(sensor, controller, 10000 + CYCLE_CHECKPOINT_INTERVAL_MS);
+    CHECK_EQ(controller.getResumeCount(), 0);
+    CHECK_EQ(g_store.resumeCount, 0);
+
+    hostAdvanceMs(2000);
+    CycleController next;
+    next.begin(&sensor, &g_logger, 5, 23);
+    next.setCheckpointStore(&g_store);
+    CHECK(next.resume(g_store));
+    CHECK_EQ(next.getResumeCount(), 1);
+}
+
+int main() {
+    testValidation();
+    testCrashLoop();
+    testStableWindow();
+    return hostTestResult();
+}
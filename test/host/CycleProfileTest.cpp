@@ -0,0 +1,177 @@
+// Ramp/soak profielen: tekstvorm heen en terug, validatie, en een herhaalblok in CycleController
+// tegen het ThermalSim model (zelfde opbouw als ThermalSimRunner).
+#include "HostTest.h"
+#include "HostMocks.h"
+#include "CycleController/CycleProfile.h"
+#include "CycleController/CycleController.h"
+#include "ThermalSim/ThermalSim.h"
+#include "TempSensor/TempSensor.h"
+#include "Logger/Logger.h"
+#include <string.h>
+
+#define SIM_PIN_KOELEN 5
+#define SIM_PIN_VERWARMING 23
+
+static void testRoundTrip() {
+    const char* texts[] = {
+        "H120r5h600;C30x50@0;H200h1800",
+        "H80",
+        "H100;H150r2.5h60x3@1;C40;H90h5",
+        "H350r10;C0",
+    };
+    for (const char* text : texts) {
+        CycleProfile profile;
+        CHECK(parseCycleProfile(text, "test", profile));
+        char buffer[160];
+        size_t len = formatCycleProfile(profile, buffer, sizeof(buffer));
+        CHECK_EQ(len, strlen(text));
+        CHECK(strcmp(buffer, text) == 0);
+
+        CycleProfile again;
+        CHECK(parseCycleProfile(buffer, "test", again));
+        CHECK(memcmp(&profile, &again, sizeof(profile)) == 0);
+    }
+
+    CycleProfile profile;
+    CHECK(parseCycleProfile("H120r5h600;C30x50@0;H200h1800", "a\"b\\c", profile));
+    CHECK_EQ(profile.count, 3);
+    CHECK_EQ(profile.segments[0].target, TEMP_Q(120));
+    CHECK_EQ(profile.segments[0].rampQPerMin, 5 * TEMP_Q_PER_DEGREE);
+    CHECK_EQ(profile.segments[0].holdSeconds, 600);
+    CHECK(profile.segments[1].mode == (uint8_t)SegmentMode::COOL);
+    CHECK_EQ(profile.segments[1].repeat, 50);
+    CHECK_EQ(profile.segments[1].loopTo, 0);
+    CHECK(strcmp(profile.name, "a_b_c") == 0);  // Geen quotes of backslashes in JSON
+
+    // Te kleine buffer: afgekapt op een segmentgrens
+    char small[16];
+    formatCycleProfile(profile, small, sizeof(small));
+    CHECK(strcmp(small, "H120r5h600") == 0);
+}
+
+static void testRejected() {
+    CycleProfile profile;
+    // Syntax en bereik
+    CHECK(!parseCycleProfile("", "x", profile));
+    CHECK(!parseCycleProfile("X100", "x", profile));
+    CHECK(!parseCycleProfile("H400", "x", profile));
+    CHECK(!parseCycleProfile("H100x3", "x", profile));
+    CHECK(!parseCycleProfile("H100;C30x2@5", "x", profile));  // Blok eindigt vóór zijn begin
+    // Eerste segment koelen
+    CHECK(!parseCycleProfile("C30;H100", "x", profile));
+    // Koelen met helling of houdtijd
+    CHECK(!parseCycleProfile("H100;C30r5", "x", profile));
+    CHECK(!parseCycleProfile("H100;C30h60", "x", profile));
+    // Geneste blokken: binnenste blok [1..1], buitenste [0..2]
+    CHECK(!parseCycleProfile("H100;H120x2@1;C30x3@0", "x", profile));
+    // Overlappende blokken: [1..2] en [0..3]
+    CHECK(!parseCycleProfile("H100;H120;C30x2@1;H150x2@0", "x", profile));
+    // Na elkaar is toegestaan
+    CHECK(parseCycleProfile("H100;C30x2@0;H150;C40x3@2", "x", profile));
+
+    // validateCycleProfile() ook los (opgeslagen profielen komen niet via de parser)
+    CHECK(parseCycleProfile("H120r5h600;C30x50@0;H200h1800", "x", profile));
+    CHECK(validateCycleProfile(profile));
+    CycleProfile bad = profile;
+    bad.segments[0].mode = (uint8_t)SegmentMode::COOL;
+    CHECK(!validateCycleProfile(bad));
+    bad = profile;
+    bad.segments[1].rampQPerMin = 4;
+    CHECK(!validateCycleProfile(bad));
+    bad = profile;
+    bad.segments[1].holdSeconds = 1;
+    CHECK(!validateCycleProfile(bad));
+    bad = profile;
+    bad.segments[2].repeat = 2;  // [0..2] om het blok [0..1] heen
+    bad.segments[2].loopTo = 0;
+    CHECK(!validateCycleProfile(bad));
+    bad = profile;
+    bad.version = PROFILE_VERSION + 1;
+    CHECK(!validateCycleProfile(bad));
+    bad = profile;
+    bad.count = 0;
+    CHECK(!validateCycleProfile(bad));
+}
+
+static ThermalSim* g_sim = nullptr;
+static int g_profile_done = 0;
+
+static void onTransition(const char* status, float temp, MonoUs timestamp) {
+    g_sim->onTransition(status);
+    if (strcmp(status, "Profiel voltooid") == 0) g_profile_done++;
+}
+
+static void testRepeatBlockInController() {
+    hostSetTimeUs(1000000);
+    ThermalSimConfig plant;
+    ThermalSim sim(plant);
+    g_sim = &sim;
+    sim.setTargets(120.0f, 30.0f);
+    Max6675SimTransport transport(&sim);
+
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&transport);
+    sensor.begin();
+    sensor.setEstimatorEnabled(true);
+
+    static Logger logger;
+    CycleController controller;
+    controller.begin(&sensor, &logger, SIM_PIN_KOELEN, SIM_PIN_VERWARMING);
+    controller.setTransitionCallback(onTransition);
+
+    CycleProfile profile;
+    CHECK(parseCycleProfile("H120r5h600;C30x50@0;H200h1800", "herhaal", profile));
+    CHECK(controller.setProfile(profile));
+    controller.start();
+    CHECK(controller.isProfileRunning());
+    CHECK(!controller.setProfile(profile));  // Niet wisselen tijdens een lopend profiel
+
+    const RelayActuator& relays = controller.getRelays();
+    // Segment wissels tellen: 1 -> 0 is een herhaling, 1 -> 2 het einde van het blok
+    int segment = controller.getProfileSegment();
+    int max_loop = 0;
+    int repeats = 0;
+    int block_exits = 0;
+    int cool_segments = 0;
+    bool finished = false;
+    const int64_t end_us = hostTimeUs() + (int64_t)80 * 3600 * 1000000;
+    while (hostTimeUs() < end_us) {
+        hostAdvanceMs(10);
+        sim.advanceTo((unsigned long)(hostTimeUs() / 1000), relays.isOutputHigh(RelayChannel::HEATER),
+                      relays.isOutputHigh(RelayChannel::COOLER));
+        sensor.sample();
+        controller.update();
+
+        int now = controller.getProfileSegment();
+        if (now != segment) {
+            if (segment == 1 && now == 0) repeats++;
+            if (segment == 1 && now == 2) block_exits++;
+            if (now == 1) cool_segments++;
+            segment = now;
+        }
+        if (controller.isProfileRunning() && controller.getProfileLoop() > max_loop) {
+            max_loop = controller.getProfileLoop();
+        }
+        if (!controller.isProfileRunning()) {
+            finished = true;
+            break;
+        }
+    }
+
+    CHECK(finished);
+    CHECK_EQ(cool_segments, 50);
+    CHECK_EQ(repeats, 49);
+    CHECK_EQ(block_exits, 1);
+    CHECK_EQ(max_loop, 50);
+    CHECK_EQ(g_profile_done, 1);
+    CHECK_EQ(segment, -1);
+    CHECK(controller.getState() == CycleState::SAFETY_COOLING);
+    CHECK(controller.hasProfile());  // Blijft geladen voor de volgende START
+}
+
+int main() {
+    testRoundTrip();
+    testRejected();
+    testRepeatBlockInController();
+    return hostTestResult();
+}
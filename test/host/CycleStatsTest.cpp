@@ -0,0 +1,120 @@
+// CycleStats: P² kwantielen (exact tot en met 5 waarden, daarna schatting) en de cyclus ring.
+#include "HostTest.h"
+#include "LegacyMedian.h"
+#include "CycleStats/CycleStats.h"
+#include <algorithm>
+#include <vector>
+
+// Nearest rank zoals P2Quantile::get() in de opstart fase
+static float nearestRank(std::vector<float> values, float p) {
+    std::sort(values.begin(), values.end());
+    return values[(size_t)(p * (values.size() - 1) + 0.5f)];
+}
+
+static void testStartup() {
+    P2Quantile p50(0.50f), p90(0.90f), p99(0.99f);
+    CHECK(isnan(p50.get()));
+
+    // Waarden niet gesorteerd aangeboden; bij elke telling tot en met 5 exact
+    const float values[5] = { 1850.0f, 1700.0f, 1915.0f, 1793.0f, 1750.0f };
+    std::vector<float> seen;
+    for (int i = 0; i < 5; i++) {
+        p50.add(values[i]);
+        p90.add(values[i]);
+        p99.add(values[i]);
+        seen.push_back(values[i]);
+        CHECK_NEAR(p50.get(), nearestRank(seen, 0.50f), 0.001);
+        CHECK_NEAR(p90.get(), nearestRank(seen, 0.90f), 0.001);
+        CHECK_NEAR(p99.get(), nearestRank(seen, 0.99f), 0.001);
+    }
+
+    // Grens: precies 5 waarden geeft niet de mediaan voor p90/p99
+    CHECK_EQ(p50.getCount(), 5);
+    CHECK_NEAR(p50.get(), 1793.0, 0.001);
+    CHECK_NEAR(p90.get(), 1915.0, 0.001);
+    CHECK_NEAR(p99.get(), 1915.0, 0.001);
+
+    // Daarna blijft de volgorde p50 <= p90 <= p99 binnen min..max
+    p50.add(1800.0f);
+    p90.add(1800.0f);
+    p99.add(1800.0f);
+    CHECK(p50.get() <= p90.get());
+    CHECK(p90.get() <= p99.get());
+    CHECK(p99.get() <= 1915.0f);
+
+    // NAN telt niet mee
+    P2Quantile single(0.9f);
+    single.add(NAN);
+    CHECK_EQ(single.getCount(), 0);
+    single.add(42.0f);
+    CHECK_NEAR(single.get(), 42.0, 0.001);
+}
+
+// Veel waarden: schatting dicht bij het exacte kwantiel
+static void testConvergence() {
+    TestRng rng(12345);
+    P2Quantile p50(0.50f), p90(0.90f), p99(0.99f);
+    std::vector<float> all;
+    for (int i = 0; i < 20000; i++) {
+        float x = (float)rng.range(0, 10000);
+        p50.add(x);
+        p90.add(x);
+        p99.add(x);
+        all.push_back(x);
+    }
+    CHECK_NEAR(p50.get(), nearestRank(all, 0.50f), 150.0);
+    CHECK_NEAR(p90.get(), nearestRank(all, 0.90f), 150.0);
+    CHECK_NEAR(p99.get(), nearestRank(all, 0.99f), 150.0);
+}
+
+static void testCycleStats() {
+    CycleStats stats;
+    CycleMetricSummary empty = stats.getSummary(CycleMetric::HEAT_MS);
+    CHECK_EQ(empty.count, 0);
+    CHECK(isnan(empty.min));
+    CHECK(isnan(empty.p90));
+
+    const uint32_t heat[5] = { 1850, 1700, 1915, 1793, 1750 };
+    for (uint32_t i = 0; i < 5; i++) {
+        CycleRecord record = {};
+        record.cycle = i + 1;
+        record.heatMs = heat[i];
+        record.coolMs = 1000;
+        record.peak = TEMP_Q(80.0);
+        record.trough = TEMP_Q_INVALID;  // Onbekend: telt niet mee
+        record.overshoot = TEMP_Q(0.5);
+        stats.addCycle(record);
+    }
+    CycleMetricSummary summary = stats.getSummary(CycleMetric::HEAT_MS);
+    CHECK_EQ(summary.count, 5);
+    CHECK_NEAR(summary.min, 1700.0, 0.001);
+    CHECK_NEAR(summary.max, 1915.0, 0.001);
+    CHECK_NEAR(summary.p50, 1793.0, 0.001);
+    CHECK_NEAR(summary.p90, 1915.0, 0.001);
+    CHECK_NEAR(summary.p99, 1915.0, 0.001);
+    CHECK_EQ(stats.getSummary(CycleMetric::TROUGH).count, 0);
+    CHECK_NEAR(stats.getMedian(CycleMetric::PEAK), 80.0, 0.001);
+
+    // Ring: leeftijd 0 = laatste cyclus, na overlopen alleen de laatste CYCLE_STATS_RING
+    CHECK_EQ(stats.getRecord(0).cycle, 5);
+    CHECK_EQ(stats.getRecord(4).cycle, 1);
+    for (uint32_t i = 6; i <= CYCLE_STATS_RING + 10; i++) {
+        CycleRecord record = {};
+        record.cycle = i;
+        stats.addCycle(record);
+    }
+    CHECK_EQ(stats.getRecordCount(), CYCLE_STATS_RING);
+    CHECK_EQ(stats.getRecord(0).cycle, CYCLE_STATS_RING + 10);
+    CHECK_EQ(stats.getRecord(CYCLE_STATS_RING - 1).cycle, 11);
+
+    stats.reset();
+    CHECK_EQ(stats.getCount(), 0);
+    CHECK_EQ(stats.getSummary(CycleMetric::HEAT_MS).count, 0);
+}
+
+int main() {
+    testStartup();
+    testConvergence();
+    testCycleStats();
+    return hostTestResult();
+}
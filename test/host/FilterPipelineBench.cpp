@@ -0,0 +1,59 @@
+// Benchmark kosten per sample van verschillende filter ketens (Pipeline, volledig geïnlined).
+//
+//   FilterPipelineBench [samples]   (standaard 2000000)
+#include "LegacyMedian.h"
+#include "TempSensor/TempSensor.h"
+#include "TempSensor/FilterPipeline.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+template <typename Chain>
+static void bench(const char* name, const TempQ* input, int samples) {
+    Chain chain;
+    long long sum = 0;
+    int accepted = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; i++) {
+        TempQ v = input[i];
+        if (chain.process(v)) {
+            sum += v;
+            accepted++;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / samples;
+    printf("%-58s %7.1f ns/sample  %5.2f%% verworpen  (controle %lld)\n", name, ns,
+           100.0 * (samples - accepted) / samples, sum);
+}
+
+int main(int argc, char** argv) {
+    int samples = (argc > 1) ? atoi(argv[1]) : 2000000;
+    if (samples <= 0) samples = 1;
+    TempQ* input = new TempQ[samples];
+    TestRng rng(4242);
+    int level = TEMP_Q(25.0);
+    for (int i = 0; i < samples; i++) {
+        // Opwarmen/afkoelen tussen 25 en 300°C met ruis, uitschieters en af en toe een ongeldige waarde
+        level += ((i / 20000) % 2 == 0) ? 1 : -1;
+        if (level < TEMP_Q(25.0)) level = TEMP_Q(25.0);
+        if (level > TEMP_Q(300.0)) level = TEMP_Q(300.0);
+        int r = rng.range(0, 999);
+        if (r < 2) input[i] = TEMP_Q_INVALID;
+        else if (r < 12) input[i] = (TempQ)(level + rng.range(-400, 400));
+        else input[i] = (TempQ)(level + rng.range(-2, 2));
+    }
+
+    printf("%d samples\n", samples);
+    bench<Pipeline<RangeGate<-200, 1200>, Median<7> > >("RangeGate + Median<7> (oorspronkelijk)", input, samples);
+    bench<TempFilterChain>("TempFilterChain (RangeGate + Hampel<7> + Median<5>)", input, samples);
+    bench<Pipeline<RangeGate<-200, 1200>, Hampel<9, 30>, Median<7>, Ema<1, 4> > >(
+        "RangeGate + Hampel<9> + Median<7> + Ema<1/4>", input, samples);
+    bench<Pipeline<RangeGate<-200, 1200>, TempOutlierStage, Median<15> > >(
+        "RangeGate + Hampel<7> + Median<15>", input, samples);
+    bench<Pipeline<RangeGate<-200, 1200>, Hampel<15, 30>, Median<31> > >(
+        "RangeGate + Hampel<15> + Median<31>", input, samples);
+    bench<Pipeline<RangeGate<-200, 1200>, Median<3>, Ema<1, 4> > >("RangeGate + Median<3> + Ema<1/4>", input, samples);
+    delete[] input;
+    return 0;
+}
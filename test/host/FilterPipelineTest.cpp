@@ -0,0 +1,158 @@
+// Filter stages (RangeGate, Median, Hampel, Ema) los en als Pipeline: verwerpen, doorgeven, reset
+// en geen virtual dispatch.
+#include "HostTest.h"
+#include "LegacyMedian.h"
+#include "TempSensor/TempSensor.h"
+#include "TempSensor/FilterPipeline.h"
+#include <type_traits>
+
+static_assert(!std::is_polymorphic<TempFilterChain>::value, "filter keten mag geen vtable hebben");
+static_assert(!std::is_polymorphic<Pipeline<RangeGate<0, 100>, Hampel<9, 30>, Median<7>, Ema<1, 4> > >::value,
+              "filter keten mag geen vtable hebben");
+
+static void testRangeGate() {
+    RangeGate<-200, 1200> gate;
+    TempQ v = TEMP_Q(20.0);
+    CHECK(gate.process(v));
+    CHECK_EQ(v, TEMP_Q(20.0));                 // Waarde ongewijzigd
+    v = TEMP_Q(-200.0);
+    CHECK(!gate.process(v));                   // Grenzen zelf vallen erbuiten
+    v = TEMP_Q(1200.0);
+    CHECK(!gate.process(v));
+    v = TEMP_Q(1199.75);
+    CHECK(gate.process(v));
+    v = TEMP_Q_INVALID;
+    CHECK(!gate.process(v));
+}
+
+static void testMedianStage() {
+    Median<3> median;
+    const TempQ in[] = { 10, 30, 20, 100, 21 };
+    const TempQ out[] = { 10, 20, 20, 30, 21 };
+    for (int i = 0; i < 5; i++) {
+        TempQ v = in[i];
+        CHECK(median.process(v));
+        CHECK_EQ(v, out[i]);
+    }
+    CHECK_EQ(median.getWindow().size(), 3);
+    median.reset();
+    CHECK_EQ(median.getWindow().size(), 0);
+}
+
+static void testHampel() {
+    Hampel<7, 30> hampel;
+    TestRng rng(7);
+    // Stabiel signaal met ruis van één kwart graad: alles door (MinMadQ voorkomt MAD = 0 verwerping)
+    for (int i = 0; i < 200; i++) {
+        TempQ v = (TempQ)(TEMP_Q(100.0) + rng.range(-1, 1));
+        CHECK(hampel.process(v));
+    }
+    CHECK_EQ(hampel.getRejected(), 0);
+
+    // Losse uitschieter: verworpen en geteld, daarna weer door
+    TempQ spike = TEMP_Q(140.0);
+    CHECK(!hampel.process(spike));
+    CHECK_EQ(hampel.getRejected(), 1);
+    TempQ normal = TEMP_Q(100.0);
+    CHECK(hampel.process(normal));
+
+    // Echte sprong: na hooguit ~N/2 samples geaccepteerd (verworpen waarden gaan ook het venster in)
+    int rejected_in_step = 0;
+    bool accepted = false;
+    for (int i = 0; i < 7 && !accepted; i++) {
+        TempQ v = TEMP_Q(130.0);
+        accepted = hampel.process(v);
+        if (!accepted) rejected_in_step++;
+    }
+    CHECK(accepted);
+    CHECK(rejected_in_step <= 4);
+
+    // Opwarmfase: pas beoordelen vanaf (N + 1) / 2 waarden in het venster
+    hampel.reset();
+    TempQ first = TEMP_Q(20.0);
+    TempQ jump = TEMP_Q(300.0);
+    CHECK(hampel.process(first));
+    CHECK(hampel.process(jump));
+}
+
+static void testEma() {
+    Ema<1, 4> ema;
+    TempQ v = TEMP_Q(50.0);
+    CHECK(ema.process(v));
+    CHECK_EQ(v, TEMP_Q(50.0));                 // Eerste waarde direct
+    for (int i = 0; i < 200; i++) {
+        v = TEMP_Q(60.0);
+        ema.process(v);
+    }
+    CHECK_EQ(v, TEMP_Q(60.0));                 // Convergeert volledig (fractiebits, geen hangen)
+    v = TEMP_Q(60.0) + 1;
+    ema.process(v);
+    CHECK_EQ(v, TEMP_Q(60.0));                 // Eén kwart stap: eerst nog afgerond naar de oude waarde
+    for (int i = 0; i < 50; i++) {
+        v = TEMP_Q(60.0) + 1;
+        ema.process(v);
+    }
+    CHECK_EQ(v, TEMP_Q(60.0) + 1);
+    ema.reset();
+    v = TEMP_Q(10.0);
+    ema.process(v);
+    CHECK_EQ(v, TEMP_Q(10.0));
+}
+
+static void testPipeline() {
+    typedef Hampel<5, 30> Outliers;
+    typedef Pipeline<RangeGate<0, 400>, Outliers, Median<3> > Chain;
+    Chain chain;
+    TempQ v = TEMP_Q(100.0);
+    CHECK(chain.process(v));
+    CHECK_EQ(chain.stage<Median<3> >().getWindow().size(), 1);
+
+    // Verworpen door de eerste stage: latere stages zien het sample niet
+    v = TEMP_Q(500.0);
+    CHECK(!chain.process(v));
+    CHECK_EQ(chain.stage<Median<3> >().getWindow().size(), 1);
+
+    for (int i = 0; i < 5; i++) {
+        v = TEMP_Q(100.0);
+        CHECK(chain.process(v));
+    }
+    v = TEMP_Q(200.0);
+    CHECK(!chain.process(v));                  // Hampel
+    CHECK_EQ(chain.stage<Outliers>().getRejected(), 1);
+    CHECK_EQ(chain.stage<Median<3> >().getWindow().size(), 3);
+
+    chain.reset();
+    CHECK_EQ(chain.stage<Median<3> >().getWindow().size(), 0);
+
+    Pipeline<> empty;
+    v = 123;
+    CHECK(empty.process(v));
+    CHECK_EQ(v, 123);
+}
+
+// Keten van TempSensor: zelfde uitkomst als range check + losse mediaan zolang er geen uitschieters zijn
+static void testSensorChain() {
+    TempFilterChain chain;
+    LegacyMedian<TEMP_MEDIAN_SAMPLES> reference;
+    TestRng rng(3);
+    int level = TEMP_Q(150.0);
+    int mismatches = 0;
+    for (int i = 0; i < 5000; i++) {
+        level += rng.range(-1, 1);
+        TempQ v = (TempQ)level;
+        reference.push(v);
+        if (!chain.process(v) || v != reference.median()) mismatches++;
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(chain.stage<TempOutlierStage>().getRejected(), 0);
+}
+
+int main() {
+    testRangeGate();
+    testMedianStage();
+    testHampel();
+    testEma();
+    testPipeline();
+    testSensorChain();
+    return hostTestResult();
+}
@@ -0,0 +1,85 @@
+#include "HostMocks.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Logger/Logger.h"
+#include <stdio.h>
+
+static int64_t g_time_us = 0;
+static int64_t g_timer_read_cost_us = 0;
+static uint8_t g_pins[64];
+static unsigned long g_delay_calls = 0;
+static bool g_log_verbose = false;
+static unsigned long g_log_count = 0;
+static char g_last_log[sizeof(((LogRequest*)nullptr)->status)] = "";
+
+void hostSetTimeUs(int64_t us) { g_time_us = us; }
+void hostAdvanceUs(int64_t us) { g_time_us += us; }
+void hostAdvanceMs(uint32_t ms) { g_time_us += (int64_t)ms * 1000; }
+int64_t hostTimeUs() { return g_time_us; }
+void hostSetTimerReadCostUs(int64_t us) { g_timer_read_cost_us = us; }
+
+int hostPinLevel(uint8_t pin) { return (pin < sizeof(g_pins)) ? g_pins[pin] : LOW; }
+
+unsigned long hostDelayCalls() { return g_delay_calls; }
+void hostResetDelayCalls() { g_delay_calls = 0; }
+
+void hostSetLogVerbose(bool verbose) { g_log_verbose = verbose; }
+unsigned long hostLogCount() { return g_log_count; }
+const char* hostLastLogStatus() { return g_last_log; }
+
+// --- Arduino ---
+unsigned long millis() { return (unsigned long)(uint32_t)(g_time_us / 1000); }
+unsigned long micros() { return (unsigned long)(uint32_t)g_time_us; }
+void delay(unsigned long ms) { g_delay_calls++; hostAdvanceMs(ms); }
+void delayMicroseconds(unsigned int us) { g_delay_calls++; hostAdvanceUs(us); }
+void yield() {}
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+void digitalWrite(uint8_t pin, uint8_t val) { if (pin < sizeof(g_pins)) g_pins[pin] = val ? HIGH : LOW; }
+int digitalRead(uint8_t pin) { return hostPinLevel(pin); }
+void* ps_malloc(size_t size) { return malloc(size); }
+bool psramFound() { return false; }
+
+// --- esp_timer ---
+int64_t esp_timer_get_time() {
+    int64_t now = g_time_us;
+    g_time_us += g_timer_read_cost_us;
+    return now;
+}
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+    (void)args;
+    *handle = nullptr;
+    return ESP_FAIL;
+}
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+    (void)timer; (void)timeoutUs;
+    return ESP_FAIL;
+}
+
+// --- FreeRTOS: geen scheduler, tasks starten niet ---
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth, void* parameter,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    (void)task; (void)name; (void)stackDepth; (void)parameter; (void)priority; (void)core;
+    if (handle != nullptr) *handle = nullptr;
+    return pdFAIL;
+}
+TickType_t xTaskGetTickCount() { return (TickType_t)(g_time_us / 1000); }
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment) { *previousWake += increment; }
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) { (void)clearOnExit; (void)ticksToWait; return 0; }
+BaseType_t xTaskNotifyGive(TaskHandle_t task) { (void)task; return pdPASS; }
+
+// --- Logger: geen queue/Google Sheets, alleen de status regel ---
+Logger::Logger()
+    : systemClock(nullptr), ntfyNotifier(nullptr), queue(nullptr), taskHandle(nullptr), tokenReady(false),
+      logSuccessFlag(false), logSuccessTime(0), spreadsheetId(nullptr) {
+    lastStatusText[0] = '\0';
+}
+
+void Logger::log(const LogRequest& req) {
+    g_log_count++;
+    snprintf(g_last_log, sizeof(g_last_log), "%s", req.status);
+    if (g_log_verbose) {
+        printf("[%10.1fs] %-40s %7.2f fase %s\n", g_time_us / 1e6, req.status, req.temp, req.fase_tijd);
+    }
+}
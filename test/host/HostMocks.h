@@ -0,0 +1,32 @@
+#ifndef HOSTMOCKS_H
+#define HOSTMOCKS_H
+
+#include <stdint.h>
+
+// Host harness: platform functies van de firmware (millis(), micros(), esp_timer_get_time(),
+// digitalWrite(), delay(), Logger::log()) op een gesimuleerde klok, zonder hardware.
+// De tijd loopt alleen als de test/simulatie hem vooruit zet: een uur regelen kost zo milliseconden.
+
+// Gesimuleerde klok in µs sinds "boot" (start op 0; millis() wrapt na 49,7 dagen net als op het board)
+void hostSetTimeUs(int64_t us);
+void hostAdvanceUs(int64_t us);
+void hostAdvanceMs(uint32_t ms);
+int64_t hostTimeUs();
+// Elke esp_timer_get_time() laat de klok daarna dit aantal µs verder lopen (standaard 0): zo valt een
+// millis() tick midden in een aanroep, zoals bij preemptie op het board
+void hostSetTimerReadCostUs(int64_t us);
+
+// Pin niveaus van digitalWrite() (HIGH/LOW), alle pinnen starten LOW
+int hostPinLevel(uint8_t pin);
+
+// Blokkerend wachten in de regellus is een fout: delay()/delayMicroseconds() tellen alleen (de klok
+// loopt wel door, zodat een wachtlus eindigt)
+unsigned long hostDelayCalls();
+void hostResetDelayCalls();
+
+// Logger::log(): teller, laatste status en optioneel afdrukken op stdout
+void hostSetLogVerbose(bool verbose);
+unsigned long hostLogCount();
+const char* hostLastLogStatus();
+
+#endif // HOSTMOCKS_H
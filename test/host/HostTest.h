@@ -0,0 +1,53 @@
+#ifndef HOSTTEST_H
+#define HOSTTEST_H
+
+#include <stdio.h>
+#include <math.h>
+
+// Minimale checks voor de host tests: elke mislukte check wordt gemeld, de test loopt door.
+// main() eindigt met return hostTestResult(); (0 = alles geslaagd, ctest gebruikt de exit code)
+inline int& hostTestFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline int& hostTestChecks() {
+    static int checks = 0;
+    return checks;
+}
+
+#define CHECK(cond) \
+    do { \
+        hostTestChecks()++; \
+        if (!(cond)) { \
+            hostTestFailures()++; \
+            printf("%s:%d: CHECK(%s) mislukt\n", __FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) \
+    do { \
+        hostTestChecks()++; \
+        long long check_a_ = (long long)(a), check_b_ = (long long)(b); \
+        if (check_a_ != check_b_) { \
+            hostTestFailures()++; \
+            printf("%s:%d: CHECK_EQ(%s, %s) mislukt: %lld != %lld\n", __FILE__, __LINE__, #a, #b, check_a_, check_b_); \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol) \
+    do { \
+        hostTestChecks()++; \
+        double check_a_ = (double)(a), check_b_ = (double)(b); \
+        if (!(fabs(check_a_ - check_b_) <= (tol))) { \
+            hostTestFailures()++; \
+            printf("%s:%d: CHECK_NEAR(%s, %s) mislukt: %g != %g\n", __FILE__, __LINE__, #a, #b, check_a_, check_b_); \
+        } \
+    } while (0)
+
+inline int hostTestResult() {
+    printf("%d checks, %d mislukt\n", hostTestChecks(), hostTestFailures());
+    return hostTestFailures() == 0 ? 0 : 1;
+}
+
+#endif // HOSTTEST_H
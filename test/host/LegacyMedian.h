@@ -0,0 +1,66 @@
+#ifndef LEGACYMEDIAN_H
+#define LEGACYMEDIAN_H
+
+#include "TempSensor/TempQ.h"
+
+// Referentie: het oorspronkelijke mediaan pad van TempSensor (vóór SlidingMedian), in kwart graden.
+// Per sample: circulaire array chronologisch kopiëren, nog een kopie en insertion sort.
+// Zelfde afronding als SlidingMedian bij een even aantal (gemiddelde naar beneden).
+template <int N>
+class LegacyMedian {
+public:
+    LegacyMedian() : index(0), count(0) {}
+
+    void push(TempQ value) {
+        if (!isValidQ(value)) return;
+        samples[index] = value;
+        index = (index + 1) % N;
+        if (count < N) count++;
+    }
+
+    TempQ median() const {
+        if (count == 0) return TEMP_Q_INVALID;
+        TempQ chrono[N];
+        for (int i = 0; i < count; i++) {
+            chrono[i] = samples[(index - count + i + N) % N];
+        }
+        TempQ sorted[N];
+        for (int i = 0; i < count; i++) {
+            sorted[i] = chrono[i];
+        }
+        for (int i = 1; i < count; i++) {
+            TempQ key = sorted[i];
+            int j = i - 1;
+            while (j >= 0 && sorted[j] > key) {
+                sorted[j + 1] = sorted[j];
+                j--;
+            }
+            sorted[j + 1] = key;
+        }
+        if (count % 2 == 1) return sorted[count / 2];
+        return (TempQ)(((int)sorted[count / 2 - 1] + (int)sorted[count / 2]) >> 1);
+    }
+
+private:
+    TempQ samples[N];
+    int index;
+    int count;
+};
+
+// Deterministische ruis voor tests en benchmarks (xorshift32)
+class TestRng {
+public:
+    explicit TestRng(uint32_t seed) : state(seed ? seed : 1) {}
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    int range(int lo, int hi) { return lo + (int)(next() % (uint32_t)(hi - lo + 1)); }
+
+private:
+    uint32_t state;
+};
+
+#endif // LEGACYMEDIAN_H
@@ -0,0 +1,103 @@
+// MAX6675 frame decodering en het mock transport: status bits, bereik en de tellers in TempSensor.
+#include "HostTest.h"
+#include "HostMocks.h"
+#include "TempSensor/Max6675Transport.h"
+#include "TempSensor/TempSensor.h"
+
+static void testDecode() {
+    TempQ q = TEMP_Q_INVALID;
+
+    // Geldig frame: bit 14..3 zijn kwart graden
+    CHECK(decodeMax6675Frame((uint16_t)(100 << 3), q) == Max6675FrameStatus::OK);
+    CHECK_EQ(q, 100);
+    CHECK_NEAR(tempFromQ(q), 25.0, 0.001);
+    CHECK(decodeMax6675Frame(0x0000, q) == Max6675FrameStatus::OK);
+    CHECK_EQ(q, 0);
+
+    // Maximum: 12 bits = 4095 kwart graden = 1023.75°C
+    CHECK(decodeMax6675Frame(0x7FF8, q) == Max6675FrameStatus::OK);
+    CHECK_EQ(q, 4095);
+    CHECK_NEAR(tempFromQ(q), 1023.75, 0.001);
+
+    // Bit 0 (three-state) wordt genegeerd
+    CHECK(decodeMax6675Frame((uint16_t)((200 << 3) | 0x01), q) == Max6675FrameStatus::OK);
+    CHECK_EQ(q, 200);
+
+    // Open thermokoppel (bit 2): quarters blijft onaangeroerd
+    q = 7;
+    CHECK(decodeMax6675Frame((uint16_t)((400 << 3) | 0x04), q) == Max6675FrameStatus::OPEN_CIRCUIT);
+    CHECK_EQ(q, 7);
+
+    // Geen chip / zwevende MISO, dummy sign bit 15 en device ID bit 1 zijn bus fouten
+    CHECK(decodeMax6675Frame(0xFFFF, q) == Max6675FrameStatus::BUS_ERROR);
+    CHECK(decodeMax6675Frame((uint16_t)(0x8000 | (100 << 3)), q) == Max6675FrameStatus::BUS_ERROR);
+    CHECK(decodeMax6675Frame((uint16_t)(0x0002 | (100 << 3)), q) == Max6675FrameStatus::BUS_ERROR);
+    // Bus fout gaat voor open circuit
+    CHECK(decodeMax6675Frame(0x8004, q) == Max6675FrameStatus::BUS_ERROR);
+    CHECK_EQ(q, 7);
+}
+
+static void testMockTransport() {
+    Max6675MockTransport mock;
+    uint16_t raw = 0xAAAA;
+    CHECK(mock.readFrame(raw));
+    CHECK_EQ(raw, 0);
+    CHECK_EQ(mock.getReads(), 1);
+
+    // setCelsius rondt af op 0.25°C en levert een frame dat terug decodeert
+    mock.setCelsius(123.4f);
+    CHECK(mock.readFrame(raw));
+    TempQ q = TEMP_Q_INVALID;
+    CHECK(decodeMax6675Frame(raw, q) == Max6675FrameStatus::OK);
+    CHECK_NEAR(tempFromQ(q), 123.5, 0.001);
+
+    mock.setBusOk(false);
+    CHECK(!mock.readFrame(raw));
+    CHECK_EQ(mock.getReads(), 3);
+}
+
+// Elk frame type komt via TempSensor in de juiste health teller terecht
+static void testSensorCounters() {
+    hostSetTimeUs(1000000);
+    Max6675MockTransport mock;
+    mock.setCelsius(60.0f);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&mock);
+    sensor.begin();
+
+    sensor.sample();
+    CHECK(sensor.getSnapshot().status == TempSensorStatus::OK);
+    CHECK_NEAR(sensor.getLastValid(), 60.0, 0.001);
+
+    mock.setFrame((uint16_t)((240 << 3) | 0x04));  // Open circuit
+    hostAdvanceMs(TEMP_SAMPLE_INTERVAL_MS);
+    sensor.sample();
+    CHECK_EQ(sensor.getHealth().openCircuit, 1);
+    CHECK_EQ(sensor.getHealth().busErrors, 0);
+
+    mock.setFrame(0xFFFF);  // Geen chip
+    hostAdvanceMs(TEMP_SAMPLE_INTERVAL_MS);
+    sensor.sample();
+    CHECK_EQ(sensor.getHealth().busErrors, 1);
+
+    mock.setFrame((uint16_t)(0x8000 | (240 << 3)));  // Sign bit
+    hostAdvanceMs(TEMP_SAMPLE_INTERVAL_MS);
+    sensor.sample();
+    CHECK_EQ(sensor.getHealth().busErrors, 2);
+
+    mock.setFrame(0x0000);
+    mock.setBusOk(false);  // Transport fout
+    hostAdvanceMs(TEMP_SAMPLE_INTERVAL_MS);
+    sensor.sample();
+    CHECK_EQ(sensor.getHealth().busErrors, 3);
+    CHECK(sensor.getSnapshot().status == TempSensorStatus::READ_ERROR);
+    CHECK_NEAR(sensor.getLastValid(), 60.0, 0.001);  // Geen foute waarde gepubliceerd
+    CHECK_EQ(sensor.getHealth().reads, mock.getReads());
+}
+
+int main() {
+    testDecode();
+    testMockTransport();
+    testSensorCounters();
+    return hostTestResult();
+}
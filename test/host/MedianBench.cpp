@@ -0,0 +1,55 @@
+// Benchmark mediaan per sample: oorspronkelijk pad (kopie + insertion sort) vs SlidingMedian,
+// vensters 7, 15, 31 en 63.
+//
+//   MedianBench [samples]   (standaard 2000000)
+#include "LegacyMedian.h"
+#include "TempSensor/SlidingMedian.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+template <typename Window>
+static double nsPerSample(const TempQ* input, int samples, long long& checksum) {
+    Window window;
+    long long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; i++) {
+        window.push(input[i]);
+        sum += window.median();
+    }
+    auto end = std::chrono::steady_clock::now();
+    checksum = sum;
+    return std::chrono::duration<double, std::nano>(end - start).count() / samples;
+}
+
+template <int N>
+static bool benchWindow(const TempQ* input, int samples) {
+    long long legacy_sum = 0;
+    long long sliding_sum = 0;
+    double legacy_ns = nsPerSample<LegacyMedian<N> >(input, samples, legacy_sum);
+    double sliding_ns = nsPerSample<SlidingMedian<N> >(input, samples, sliding_sum);
+    printf("N=%2d  kopie+sort %8.1f ns  SlidingMedian %6.1f ns  factor %5.1fx%s\n", N, legacy_ns, sliding_ns,
+           legacy_ns / sliding_ns, legacy_sum == sliding_sum ? "" : "  VERSCHIL IN UITKOMST");
+    return legacy_sum == sliding_sum;
+}
+
+int main(int argc, char** argv) {
+    int samples = (argc > 1) ? atoi(argv[1]) : 2000000;
+    if (samples <= 0) samples = 1;
+    TempQ* input = new TempQ[samples];
+    TestRng rng(12345);
+    int level = 200 * TEMP_Q_PER_DEGREE;
+    for (int i = 0; i < samples; i++) {
+        level += rng.range(-2, 2);
+        if (level < 0) level = 0;
+        input[i] = (TempQ)(level + ((rng.range(0, 99) < 3) ? rng.range(-200, 200) : 0));
+    }
+
+    printf("%d samples, ruisende temperatuur met uitschieters\n", samples);
+    bool same = benchWindow<7>(input, samples);
+    same = benchWindow<15>(input, samples) && same;
+    same = benchWindow<31>(input, samples) && same;
+    same = benchWindow<63>(input, samples) && same;
+    delete[] input;
+    return same ? 0 : 1;
+}
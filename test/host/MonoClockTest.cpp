@@ -0,0 +1,239 @@
+// Monotone tijdsbasis: de gesimuleerde klok springt naar vlak voor de millis() wrap (49,7 dagen) en
+// loopt er doorheen. Fasetijden, de veiligheidskoeling naloop, het read schema van TempSensor en de
+// volgorde van grafiekpunten moeten gewoon doorlopen.
+#include "HostTest.h"
+#include "HostMocks.h"
+#include "SystemClock/MonoClock.h"
+#include "TempSensor/TempSensor.h"
+#include "CycleController/CycleController.h"
+#include "ThermalSim/ThermalSim.h"
+#include "Logger/Logger.h"
+#include <Arduino.h>
+
+// millis() gaat door 0 op 2^32 ms
+static const int64_t WRAP_US = (int64_t)4294967296LL * 1000;
+
+#define NALOOP_MS (2 * 60 * 1000)      // VEILIGHEIDSKOELING_NALOOP_MS in CycleController.cpp
+#define GRAPH_LOG_INTERVAL_MS 5000     // TEMP_GRAPH_LOG_INTERVAL_MS van de UIController
+#define GRAPH_POINTS 120
+
+static void testHelpers() {
+    CHECK_EQ(monoElapsedMs(MONO_US_UNSET, 5000000), 0);
+    CHECK_EQ(monoElapsedMs(5000000, 5000000), 0);
+    CHECK_EQ(monoElapsedMs(6000000, 5000000), 0);  // Tijdstip in de toekomst
+    CHECK_EQ(monoElapsedMs(0, 1500000), 1500);     // 0 is een geldig tijdstip
+    CHECK_EQ(monoElapsedMs(0, (int64_t)UINT32_MAX * 1000 * 3), UINT32_MAX);  // Verzadigt
+
+    hostSetTimeUs(WRAP_US - 2000);
+    MonoUs before = monoNowUs();
+    unsigned long millis_before = millis();
+    hostAdvanceMs(5);
+    CHECK(millis() < millis_before);  // millis() is gewrapt...
+    CHECK(monoNowUs() > before);      // ...de monotone klok niet
+    CHECK_EQ(monoElapsedMs(before), 5);
+    CHECK_EQ((uint32_t)(monoMillis32() - (uint32_t)millis_before), 5);  // Verschillen blijven wrap-veilig
+}
+
+// Regeling door de wrap heen: fasetijden lopen door, overgangen blijven in volgorde
+static MonoUs g_lastTransition = MONO_US_UNSET;
+static int g_transitions = 0;
+static int g_outOfOrder = 0;
+
+static void onTransition(const char* status, float temp, MonoUs timestamp) {
+    (void)status;
+    (void)temp;
+    if (isSetMono(g_lastTransition) && timestamp < g_lastTransition) g_outOfOrder++;
+    g_lastTransition = timestamp;
+    g_transitions++;
+}
+
+static void testCycleAcrossWrap() {
+    hostSetTimeUs(WRAP_US - 60LL * 1000000);  // Eén minuut voor de wrap
+    ThermalSimConfig plant;
+    plant.tauHeatS = 60.0f;
+    plant.tauCoolS = 30.0f;
+    plant.deadTimeS = 2.0f;
+    ThermalSim sim(plant);
+    Max6675SimTransport transport(&sim);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&transport);
+    sensor.begin();
+    static Logger logger;
+    CycleController controller;
+    controller.begin(&sensor, &logger, 5, 23);
+    controller.setTargetTop(80.0f);
+    controller.setTargetBottom(40.0f);
+    controller.setTransitionCallback(onTransition);
+    controller.start();
+
+    const RelayActuator& relays = controller.getRelays();
+    CycleState prev_state = controller.getState();
+    unsigned long prev_elapsed = 0;
+    int backwards = 0;
+    bool wrapped_in_phase = false;
+    for (int ms = 0; ms < 30 * 60 * 1000; ms += 5) {
+        unsigned long millis_before = millis();
+        hostAdvanceMs(5);
+        sim.advanceTo((unsigned long)(hostTimeUs() / 1000), relays.isOutputHigh(RelayChannel::HEATER),
+                      relays.isOutputHigh(RelayChannel::COOLER));
+        sensor.sample();
+        controller.update();
+
+        // Binnen één fase loopt de fasetijd alleen vooruit, ook over de wrap
+        CycleState state = controller.getState();
+        unsigned long elapsed = controller.isHeating() ? controller.getHeatingElapsed() : controller.getCoolingElapsed();
+        if (state == prev_state && elapsed < prev_elapsed) backwards++;
+        if (millis() < millis_before && state == prev_state && elapsed > 1000) wrapped_in_phase = true;
+        prev_state = state;
+        prev_elapsed = elapsed;
+    }
+    CHECK(wrapped_in_phase);  // Een fase die voor de wrap begon liep er doorheen
+    CHECK_EQ(backwards, 0);
+    CHECK(g_transitions >= 4);
+    CHECK_EQ(g_outOfOrder, 0);
+    CHECK(controller.getCycleCount() >= 2);
+
+    // Fase duren (ook die over de wrap) zijn gewoon minuten, geen 49,7 dagen of 0
+    const CycleStats& stats = controller.getCycleStats();
+    CHECK(stats.getRecordCount() >= 1);
+    for (int i = 0; i < stats.getRecordCount(); i++) {
+        const CycleRecord& record = stats.getRecord(i);
+        CHECK(record.heatMs > 1000 && record.heatMs < 30 * 60 * 1000UL);
+        CHECK(record.coolMs > 1000 && record.coolMs < 30 * 60 * 1000UL);
+    }
+    CHECK(controller.getLastHeatingDuration() < 30 * 60 * 1000UL);
+}
+
+// Veiligheidskoeling naloop die over de wrap loopt: precies NALOOP_MS, niet eerder en niet nooit
+static void testSafetyAfterrunAcrossWrap() {
+    hostSetTimeUs(WRAP_US - 40LL * 1000000);
+    Max6675MockTransport mock;
+    mock.setCelsius(30.0f);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&mock);
+    sensor.begin();
+    static Logger logger;
+    CycleController controller;
+    controller.begin(&sensor, &logger, 5, 23);
+    controller.setTargetTop(80.0f);
+    controller.setTargetBottom(25.0f);
+    for (int i = 0; i < 10; i++) {
+        hostAdvanceMs(TEMP_SAMPLE_INTERVAL_MS);
+        sensor.sample();
+    }
+    controller.start();
+    controller.update();
+    controller.stop();  // Onder 35°C: naloop start bij de volgende update()
+
+    int64_t afterrun_start_us = -1;
+    int64_t off_us = -1;
+    for (int ms = 0; ms < 4 * 60 * 1000; ms++) {
+        hostAdvanceMs(1);
+        sensor.sample();
+        controller.update();
+        if (afterrun_start_us < 0 && controller.isSafetyCooling()) afterrun_start_us = hostTimeUs();
+        if (off_us < 0 && controller.getState() == CycleState::OFF) off_us = hostTimeUs();
+    }
+    CHECK(afterrun_start_us > 0 && afterrun_start_us < WRAP_US);
+    CHECK(off_us > WRAP_US);  // Naloop eindigt na de wrap
+    CHECK_NEAR((off_us - afterrun_start_us) / 1000.0, NALOOP_MS, 5.0);
+    CHECK(!controller.getRelays().isOutputHigh(RelayChannel::HEATER));
+}
+
+// TempSensor: het read schema (int32 verschil met nextReadDueMs) loopt zonder gat door de wrap
+static void testSensorAcrossWrap() {
+    hostSetTimeUs(WRAP_US - 10LL * 1000000);
+    Max6675MockTransport mock;
+    mock.setCelsius(50.0f);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&mock);
+    sensor.begin();
+    sensor.sample();
+    unsigned long reads_before = mock.getReads();
+    for (int ms = 0; ms < 20000; ms++) {
+        hostAdvanceMs(1);
+        sensor.sample();
+    }
+    unsigned long reads = mock.getReads() - reads_before;
+    CHECK_EQ(reads, 20000 / TEMP_SAMPLE_INTERVAL_MS);
+    CHECK_EQ(sensor.getHealth().notReady, 0);
+    CHECK(sensor.getSnapshot().status == TempSensorStatus::OK);
+    CHECK(isValidQ(sensor.getCriticalQ()));  // Kritieke meting niet als verouderd beschouwd
+}
+
+// Een read precies op millis() == 0 telt als gelezen: de volgende read wacht gewoon de conversietijd af
+static void testReadAtMillisZero() {
+    hostSetTimeUs(WRAP_US);
+    CHECK_EQ(millis(), 0);
+    Max6675MockTransport mock;
+    mock.setCelsius(50.0f);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&mock);
+    sensor.begin();
+    CHECK_NEAR(sensor.read(), 50.0, 0.01);
+    hostAdvanceMs(MAX6675_CONVERSION_TIME_MS / 2);
+    CHECK(isnan(sensor.read()));
+    CHECK_EQ(sensor.getHealth().notReady, 1);
+    CHECK_EQ(mock.getReads(), 1);
+    hostAdvanceMs(MAX6675_CONVERSION_TIME_MS);
+    CHECK_NEAR(sensor.read(), 50.0, 0.01);
+    CHECK_EQ(mock.getReads(), 2);
+}
+
+// Grafiek: zelfde ring en "nieuwer dan laatst getoond" selectie als UIController::updateGraph()
+// (die zelf LVGL nodig heeft). Met millis() tijdstempels zouden de punten na de wrap als oud gelden.
+static void testGraphOrderAcrossWrap() {
+    MonoUs times[GRAPH_POINTS];
+    uint32_t millis_times[GRAPH_POINTS];
+    for (int i = 0; i < GRAPH_POINTS; i++) times[i] = MONO_US_UNSET;
+    int write_index = 0;
+    int count = 0;
+    MonoUs last_log = MONO_US_UNSET;
+    MonoUs last_displayed = MONO_US_UNSET;
+    int shown = 0;
+    int duplicates = 0;
+    int millis_out_of_order = 0;
+
+    hostSetTimeUs(WRAP_US - 3LL * 60 * 1000000);  // 3 minuten voor de wrap, 10 minuten loggen
+    for (int step = 0; step < 10 * 60 * 10; step++) {
+        hostAdvanceMs(100);
+        MonoUs now = monoNowUs();
+        if (!isSetMono(last_log) || monoElapsedMs(last_log, now) >= GRAPH_LOG_INTERVAL_MS) {
+            int prev = (write_index + GRAPH_POINTS - 1) % GRAPH_POINTS;
+            if (count > 0 && millis() < millis_times[prev]) millis_out_of_order++;
+            times[write_index] = now;
+            millis_times[write_index] = (uint32_t)millis();
+            write_index = (write_index + 1) % GRAPH_POINTS;
+            if (count < GRAPH_POINTS) count++;
+            last_log = now;
+        }
+        if (step % 37 != 0) continue;  // Scherm update op een ander ritme dan het loggen
+
+        int start = (count < GRAPH_POINTS) ? 0 : write_index;
+        MonoUs newest = last_displayed;
+        MonoUs prev_shown = last_displayed;
+        for (int j = 0; j < count; j++) {
+            int i = (start + j) % GRAPH_POINTS;
+            if (!isSetMono(times[i]) || times[i] <= last_displayed) continue;
+            if (times[i] <= prev_shown) duplicates++;  // Niet chronologisch
+            prev_shown = times[i];
+            shown++;
+            if (times[i] > newest) newest = times[i];
+        }
+        last_displayed = newest;
+    }
+    int logged = 10 * 60 * 1000 / GRAPH_LOG_INTERVAL_MS;
+    CHECK_EQ(millis_out_of_order, 1);  // De wrap zat er echt tussen
+    CHECK_EQ(duplicates, 0);
+    CHECK(shown >= logged - 1 && shown <= logged);  // Laatste punt kan na de laatste scherm update komen
+}
+
+int main() {
+    testHelpers();
+    testCycleAcrossWrap();
+    testSafetyAfterrunAcrossWrap();
+    testSensorAcrossWrap();
+    testReadAtMillisZero();
+    testGraphOrderAcrossWrap();
+    return hostTestResult();
+}
@@ -0,0 +1,123 @@
+// PidController (anti-windup, begrenzing) en TimeProportionalOutput (venster, minimale pulsduur).
+#include "HostTest.h"
+#include "PidController/PidController.h"
+
+static void testIntegralFrozenWhileSaturated() {
+    PidController pid;
+    pid.setTunings(0.1f, 0.01f, 0.0f);
+
+    // 80°C onder setpoint: P-term alleen al ruim boven 1, integrator mag niet oplopen
+    for (int i = 0; i < 1000; i++) {
+        CHECK_NEAR(pid.update(100.0f, 20.0f, 1.0f, 0.0f), 1.0, 1e-6);
+    }
+    CHECK_NEAR(pid.getIntegral(), 0.0, 1e-6);
+
+    // Dicht bij setpoint integreert hij wel
+    pid.update(100.0f, 99.0f, 1.0f, 0.0f);
+    CHECK_NEAR(pid.getIntegral(), 0.01, 1e-6);
+
+    // Te warm met de uitgang al op 0: integrator blijft staan
+    pid.reset();
+    for (int i = 0; i < 1000; i++) {
+        CHECK_NEAR(pid.update(100.0f, 150.0f, 1.0f, 0.0f), 0.0, 1e-6);
+    }
+    CHECK_NEAR(pid.getIntegral(), 0.0, 1e-6);
+}
+
+static void testIntegralClamped() {
+    PidController pid;
+    pid.setTunings(0.01f, 1.0f, 0.0f);
+
+    // 0.3 per stap: 0.3, 0.6, 0.9, dan begrensd op 1 (uitgang 0.903 was nog niet verzadigd)
+    for (int i = 0; i < 4; i++) pid.update(100.0f, 99.7f, 1.0f, 0.0f);
+    CHECK_NEAR(pid.getIntegral(), 1.0, 1e-4);
+    CHECK_NEAR(pid.getOutput(), 1.0, 1e-4);
+
+    // Verzadigd en fout in dezelfde richting: bevroren
+    pid.update(100.0f, 99.7f, 1.0f, 0.0f);
+    CHECK_NEAR(pid.getIntegral(), 1.0, 1e-4);
+
+    // Omlaag: 0.7, 0.4, 0.1, dan begrensd op 0
+    for (int i = 0; i < 4; i++) pid.update(100.0f, 100.3f, 1.0f, 0.0f);
+    CHECK_NEAR(pid.getIntegral(), 0.0, 1e-4);
+    CHECK_NEAR(pid.getOutput(), 0.0, 1e-4);
+
+    // Uitgang op 0 en fout negatief: bevroren, niet negatief
+    pid.update(100.0f, 100.3f, 1.0f, 0.0f);
+    CHECK_NEAR(pid.getIntegral(), 0.0, 1e-4);
+
+    // Fout die de uitgang uit de verzadiging haalt integreert direct weer
+    pid.update(100.0f, 99.7f, 1.0f, 0.0f);
+    CHECK_NEAR(pid.getIntegral(), 0.3, 1e-4);
+}
+
+static void testDutyLatchedAtWindowStart() {
+    TimeProportionalOutput out;
+    out.setWindow(2000);
+    out.reset(1000);
+
+    // Venster 1000..2999: 50% duty, latere duty wijzigingen tellen pas in het volgende venster
+    CHECK(out.update(1000, 0.5f));
+    CHECK(out.update(1500, 0.0f));
+    CHECK(out.update(1999, 0.0f));
+    CHECK(!out.update(2000, 1.0f));
+    CHECK(!out.update(2999, 1.0f));
+    CHECK(!out.isWindowDue(2999));
+    CHECK(out.isWindowDue(3000));
+
+    // Venster 3000..4999: 25% duty
+    CHECK(out.update(3000, 0.25f));
+    CHECK(out.update(3499, 1.0f));
+    CHECK(!out.update(3500, 1.0f));
+    CHECK(!out.update(4999, 1.0f));
+
+    // reset() start bij de volgende update() direct een nieuw venster
+    out.reset(4000);
+    CHECK(out.update(4000, 1.0f));
+    CHECK(out.update(5999, 0.0f));
+    CHECK(!out.update(6000, 0.0f));
+}
+
+static void testShortPulsesRounded() {
+    const uint32_t window = 2000;
+    const float min_duty = (float)PID_MIN_SWITCH_MS / window;
+    TimeProportionalOutput out;
+    out.setWindow(window);
+    out.reset(0);
+
+    // Aan-puls korter dan PID_MIN_SWITCH_MS: hele venster uit
+    unsigned long t = 0;
+    out.update(t, min_duty * 0.8f);
+    bool any_on = false;
+    for (uint32_t ms = 0; ms < window; ms += 10) any_on |= out.update(t + ms, 0.0f);
+    CHECK(!any_on);
+
+    // Uit-puls korter dan PID_MIN_SWITCH_MS: hele venster aan
+    t += window;
+    out.update(t, 1.0f - min_duty * 0.8f);
+    bool all_on = true;
+    for (uint32_t ms = 0; ms < window; ms += 10) all_on &= out.update(t + ms, 0.0f);
+    all_on &= out.update(t + window - 1, 0.0f);
+    CHECK(all_on);
+
+    // Precies PID_MIN_SWITCH_MS blijft staan
+    t += window;
+    CHECK(out.update(t, min_duty));
+    CHECK(out.update(t + PID_MIN_SWITCH_MS - 1, 0.0f));
+    CHECK(!out.update(t + PID_MIN_SWITCH_MS, 0.0f));
+
+    // Duty buiten 0..1 wordt begrensd
+    t += window;
+    CHECK(!out.update(t, -0.5f));
+    t += window;
+    CHECK(out.update(t, 1.5f));
+    CHECK(out.update(t + window - 1, 0.0f));
+}
+
+int main() {
+    testIntegralFrozenWhileSaturated();
+    testIntegralClamped();
+    testDutyLatchedAtWindowStart();
+    testShortPulsesRounded();
+    return hostTestResult();
+}
@@ -0,0 +1,163 @@
+// RelayActuator met MockGpioBank: dead-time tussen verwarmen en koelen, nooit beide uitgangen hoog,
+// één register write per stap, schakelstatistiek en het afhandelen van forceOff() vanuit een andere task.
+#include "HostTest.h"
+#include "HostMocks.h"
+#include "RelayActuator/RelayActuator.h"
+
+#define PIN_COOLER 5
+#define PIN_HEATER 23
+
+// Onthoudt of een pin bij configureOutput() al laag stond in het uitgangsregister
+class RecordingGpioBank : public MockGpioBank {
+public:
+    RecordingGpioBank() : configuredHigh(0) {}
+    void configureOutput(uint8_t pin) override {
+        if (isHigh(pin)) configuredHigh++;
+        MockGpioBank::configureOutput(pin);
+    }
+    int configuredHigh;
+};
+
+static void testBegin() {
+    RecordingGpioBank bank;
+    bank.write((1UL << PIN_COOLER) | (1UL << PIN_HEATER), 0);  // Register na reset onbekend
+    RelayActuator relays;
+    relays.setGpioBank(&bank);
+    CHECK(!relays.begin(PIN_COOLER, 40));  // Pin buiten de bank
+    CHECK(relays.begin(PIN_COOLER, PIN_HEATER));
+    CHECK_EQ(bank.configuredHigh, 0);  // Eerst laag, dan pas als uitgang
+    CHECK_EQ(bank.getConfigured(), (1UL << PIN_COOLER) | (1UL << PIN_HEATER));
+    CHECK(!bank.isHigh(PIN_COOLER));
+    CHECK(!bank.isHigh(PIN_HEATER));
+    CHECK(relays.getMode() == RelayMode::OFF);
+}
+
+static void testDeadTime() {
+    hostSetTimeUs(1000000);
+    MockGpioBank bank;
+    RelayActuator relays;
+    relays.setGpioBank(&bank);
+    relays.begin(PIN_COOLER, PIN_HEATER);
+    uint32_t writes = bank.getWriteCount();
+
+    // Eerste inschakeling: geen wachttijd, één set write
+    relays.set(RelayMode::HEAT);
+    CHECK(bank.isHigh(PIN_HEATER));
+    CHECK(relays.getMode() == RelayMode::HEAT);
+    CHECK_EQ(bank.getWriteCount(), writes + 1);
+    hostAdvanceMs(1000);
+
+    // Omschakelen: verwarming direct uit (één clear write), koeling wacht op de dead-time
+    writes = bank.getWriteCount();
+    relays.set(RelayMode::COOL);
+    CHECK(!bank.isHigh(PIN_HEATER));
+    CHECK(!bank.isHigh(PIN_COOLER));
+    CHECK(relays.getMode() == RelayMode::OFF);
+    CHECK(relays.getTargetMode() == RelayMode::COOL);
+    CHECK_EQ(bank.getWriteCount(), writes + 1);
+    CHECK_EQ(relays.getDeadTimeWaits(), 1);
+
+    int both_high = 0;
+    int64_t cooler_on_us = -1;
+    int64_t switch_us = hostTimeUs();
+    for (int ms = 0; ms < 3 * RELAY_DEAD_TIME_MS; ms++) {
+        hostAdvanceMs(1);
+        relays.update();
+        if (bank.isHigh(PIN_HEATER) && bank.isHigh(PIN_COOLER)) both_high++;
+        if (cooler_on_us < 0 && bank.isHigh(PIN_COOLER)) cooler_on_us = hostTimeUs();
+    }
+    CHECK_EQ(both_high, 0);
+    CHECK_EQ((cooler_on_us - switch_us) / 1000, RELAY_DEAD_TIME_MS);  // Niet eerder, niet later
+    CHECK(relays.getMode() == RelayMode::COOL);
+    CHECK_EQ(bank.getWriteCount(), writes + 2);  // Wachten kost geen writes
+    CHECK_EQ(relays.getDeadTimeWaits(), 1);      // Eén wachtende omschakeling, niet per update()
+
+    // Terug naar verwarmen binnen de dead-time en weer annuleren: koeling gaat uit, verwarming nooit aan
+    relays.set(RelayMode::HEAT);
+    hostAdvanceMs(RELAY_DEAD_TIME_MS / 2);
+    relays.update();
+    CHECK(!bank.isHigh(PIN_HEATER));
+    relays.set(RelayMode::OFF);
+    hostAdvanceMs(3 * RELAY_DEAD_TIME_MS);
+    relays.update();
+    CHECK(!bank.isHigh(PIN_HEATER));
+    CHECK(!bank.isHigh(PIN_COOLER));
+    CHECK_EQ(relays.getDeadTimeWaits(), 2);
+
+    // Dezelfde modus opnieuw: geen write
+    writes = bank.getWriteCount();
+    relays.set(RelayMode::OFF);
+    relays.update();
+    CHECK_EQ(bank.getWriteCount(), writes);
+
+    // Instelbare dead-time
+    relays.setDeadTimeMs(100);
+    CHECK_EQ(relays.getDeadTimeMs(), 100);
+    hostAdvanceMs(100);
+    relays.set(RelayMode::HEAT);  // Koeling al > 100 ms uit: direct
+    CHECK(bank.isHigh(PIN_HEATER));
+    relays.set(RelayMode::COOL);
+    hostAdvanceMs(99);
+    relays.update();
+    CHECK(!bank.isHigh(PIN_COOLER));
+    hostAdvanceMs(1);
+    relays.update();
+    CHECK(bank.isHigh(PIN_COOLER));
+}
+
+static void testStats() {
+    hostSetTimeUs(1000000);
+    MockGpioBank bank;
+    RelayActuator relays;
+    relays.setGpioBank(&bank);
+    relays.begin(PIN_COOLER, PIN_HEATER);
+    for (int i = 0; i < 3; i++) {
+        relays.set(RelayMode::HEAT);
+        hostAdvanceMs(2000);
+        relays.set(RelayMode::OFF);
+        hostAdvanceMs(1000);
+    }
+    relays.set(RelayMode::HEAT);
+    hostAdvanceMs(500);  // Lopende aan-periode telt mee
+    RelayStats heater = relays.getStats(RelayChannel::HEATER);
+    CHECK_EQ(heater.switchCount, 4);
+    CHECK_EQ(heater.onTimeMs, 3 * 2000 + 500);
+    CHECK_EQ(relays.getStats(RelayChannel::COOLER).switchCount, 0);
+    CHECK_EQ(relays.getDeadTimeWaits(), 0);  // Via OFF met genoeg tijd ertussen
+}
+
+// forceOff() vanuit de supervisor: pinnen laag, de volgende update() zet de modus op OFF zonder
+// herinschakelen; pas een nieuwe set() schakelt weer in
+static void testForceOff() {
+    hostSetTimeUs(1000000);
+    MockGpioBank bank;
+    RelayActuator relays;
+    relays.setGpioBank(&bank);
+    relays.begin(PIN_COOLER, PIN_HEATER);
+    relays.set(RelayMode::HEAT);
+    hostAdvanceMs(1000);
+    uint32_t writes = bank.getWriteCount();
+    relays.forceOff();
+    CHECK_EQ(bank.getWriteCount(), writes + 1);
+    CHECK(!relays.isOutputHigh(RelayChannel::HEATER));
+    CHECK(relays.getMode() == RelayMode::HEAT);  // Administratie volgt later
+
+    hostAdvanceMs(1000);
+    relays.update();
+    CHECK(relays.getMode() == RelayMode::OFF);
+    CHECK(relays.getTargetMode() == RelayMode::OFF);
+    CHECK(!bank.isHigh(PIN_HEATER));
+    CHECK_EQ(relays.getStats(RelayChannel::HEATER).onTimeMs, 2000);  // Tot de update(), de veilige kant
+
+    relays.set(RelayMode::HEAT);
+    CHECK(bank.isHigh(PIN_HEATER));
+    CHECK_EQ(relays.getStats(RelayChannel::HEATER).switchCount, 2);
+}
+
+int main() {
+    testBegin();
+    testDeadTime();
+    testStats();
+    testForceOff();
+    return hostTestResult();
+}
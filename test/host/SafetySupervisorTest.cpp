@@ -0,0 +1,133 @@
+// SafetySupervisor: de aan-tijd grens van de verwarming geldt ook voor pulserend schakelen (PID, autotune),
+// en een trip kan niet meer verloren gaan tegen een gelijktijdige inschakeling vanuit loop().
+#include "HostTest.h"
+#include "HostMocks.h"
+#include "SafetySupervisor/SafetySupervisor.h"
+#include "RelayActuator/RelayActuator.h"
+#include "TempSensor/TempSensor.h"
+
+#define PIN_COOLER 5
+#define PIN_HEATER 23
+#define MINUTE_MS (60UL * 1000)
+
+// Pulserend verwarmen met de gegeven duty cycle (periode 10 s) tot een trip of maxMs.
+// Geeft de tijd tot de trip terug, 0 = geen trip.
+static uint32_t runDuty(int dutyPercent, uint32_t maxMs) {
+    hostSetTimeUs(1000000);
+    Max6675MockTransport mock;
+    mock.setCelsius(50.0f);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&mock);
+    sensor.begin();
+    MockGpioBank bank;
+    RelayActuator relays;
+    relays.setGpioBank(&bank);
+    relays.begin(PIN_COOLER, PIN_HEATER);
+    SafetySupervisor supervisor;
+    supervisor.addSensor(&sensor);
+    supervisor.begin(&relays);  // Geen task op de host: check() hieronder
+
+    const uint32_t period_ms = 10000;
+    for (uint32_t ms = 0; ms < maxMs; ms += SAFETY_SUPERVISOR_PERIOD_MS) {
+        hostAdvanceMs(SAFETY_SUPERVISOR_PERIOD_MS);
+        sensor.sample();
+        bool on = (ms % period_ms) < period_ms * dutyPercent / 100;
+        if (!supervisor.isTripped()) relays.set(on ? RelayMode::HEAT : RelayMode::OFF);
+        relays.update();
+        supervisor.check();
+        if (supervisor.isTripped()) {
+            CHECK(supervisor.getTrip() == SafetyTrip::HEATER_ON);
+            CHECK(!bank.isHigh(PIN_HEATER));
+            CHECK(relays.isHeaterLocked());
+            return ms + SAFETY_SUPERVISOR_PERIOD_MS;
+        }
+    }
+    CHECK(supervisor.getHeaterWindowMs() < SAFETY_MAX_HEATER_ON_MS);
+    return 0;
+}
+
+static void testHeaterOnTime() {
+    // Onafgebroken aan: trip na precies de grens
+    uint32_t continuous = runDuty(100, 2 * 60 * MINUTE_MS);
+    CHECK_NEAR(continuous, SAFETY_MAX_HEATER_ON_MS, SAFETY_SUPERVISOR_PERIOD_MS);
+
+    // PID aan de grens (91% duty): nooit een uur onafgebroken aan, toch een trip binnen het venster
+    uint32_t pulsing = runDuty(91, 3 * 60 * MINUTE_MS);
+    CHECK(pulsing > SAFETY_MAX_HEATER_ON_MS);
+    CHECK(pulsing < SAFETY_HEATER_WINDOW_MS);
+
+    // Normale regeling (50% duty) uren lang: geen trip
+    CHECK_EQ(runDuty(50, 3 * 60 * MINUTE_MS), 0);
+}
+
+// Bank die precies tussen de isTripped() controle in loop() en de set write van de verwarming een
+// supervisor controle laat lopen (zoals de task op de andere core dat kan doen)
+class RacingGpioBank : public MockGpioBank {
+public:
+    RacingGpioBank() : supervisor(nullptr), armed(false) {}
+    void write(uint32_t setMask, uint32_t clearMask) override {
+        if (armed && (setMask & (1UL << PIN_HEATER))) {
+            armed = false;
+            supervisor->check();
+        }
+        MockGpioBank::write(setMask, clearMask);
+    }
+    SafetySupervisor* supervisor;
+    bool armed;
+};
+
+static void testTripRace() {
+    hostSetTimeUs(1000000);
+    Max6675MockTransport mock;
+    mock.setCelsius(50.0f);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&mock);
+    sensor.begin();
+    sensor.sample();
+    RacingGpioBank bank;
+    RelayActuator relays;
+    relays.setGpioBank(&bank);
+    relays.begin(PIN_COOLER, PIN_HEATER);
+    SafetySupervisor supervisor;
+    supervisor.addSensor(&sensor);
+    supervisor.begin(&relays);
+    bank.supervisor = &supervisor;
+    supervisor.check();
+    CHECK(!supervisor.isTripped());
+
+    // loop() zag nog geen trip en schakelt in; de supervisor tript midden in die set()
+    SafetyLimits limits;
+    limits.maxTempC = 40.0f;
+    supervisor.setLimits(limits);
+    bank.armed = true;
+    relays.set(RelayMode::HEAT);
+    CHECK(supervisor.getTrip() == SafetyTrip::OVER_TEMP);
+    CHECK(!bank.isHigh(PIN_HEATER));  // Niet tot de volgende controle aan
+    CHECK(relays.getMode() == RelayMode::OFF);
+
+    // Zolang de trip staat weigert de actuator verwarmen, ook later via update()
+    hostAdvanceMs(100);
+    relays.set(RelayMode::HEAT);
+    relays.update();
+    CHECK(!bank.isHigh(PIN_HEATER));
+    relays.set(RelayMode::COOL);  // Koelen mag wel
+    CHECK(bank.isHigh(PIN_COOLER));
+
+    // clearTrip (START) geeft de verwarming weer vrij
+    supervisor.setLimits(SafetyLimits());
+    supervisor.clearTrip();
+    CHECK(!relays.isHeaterLocked());
+    relays.set(RelayMode::HEAT);
+    hostAdvanceMs(RELAY_DEAD_TIME_MS + 1);
+    relays.update();
+    CHECK(bank.isHigh(PIN_HEATER));
+    CHECK(!bank.isHigh(PIN_COOLER));
+    supervisor.check();
+    CHECK(!supervisor.isTripped());
+}
+
+int main() {
+    testHeaterOnTime();
+    testTripRace();
+    return hostTestResult();
+}
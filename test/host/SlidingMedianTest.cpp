@@ -0,0 +1,81 @@
+// SlidingMedian: zelfde mediaan als het oorspronkelijke pad (kopie + insertion sort) voor elk venster,
+// ook tijdens het vullen (even aantal), bij duplicaten, sprongen en genegeerde ongeldige waarden.
+#include "HostTest.h"
+#include "LegacyMedian.h"
+#include "TempSensor/SlidingMedian.h"
+
+template <int N>
+static void checkEquivalence(uint32_t seed, int spread, int samples) {
+    SlidingMedian<N> fast;
+    LegacyMedian<N> reference;
+    TestRng rng(seed);
+    int level = 100 * TEMP_Q_PER_DEGREE;
+    int mismatches = 0;
+    for (int i = 0; i < samples; i++) {
+        TempQ value;
+        int kind = rng.range(0, 99);
+        if (kind < 2) {
+            value = TEMP_Q_INVALID;                            // Genegeerd
+        } else if (kind < 4) {
+            value = (TempQ)(level + rng.range(-400, 400));     // Uitschieter
+        } else {
+            level += rng.range(-spread, spread);               // Random walk met ruis
+            value = (TempQ)level;
+        }
+        fast.push(value);
+        reference.push(value);
+        if (fast.median() != reference.median()) mismatches++;
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(fast.size(), N);
+}
+
+static void testEmptyAndFill() {
+    SlidingMedian<4> window;
+    CHECK_EQ(window.median(), TEMP_Q_INVALID);
+    window.push(TEMP_Q_INVALID);
+    CHECK_EQ(window.size(), 0);
+    window.push(8);
+    CHECK_EQ(window.median(), 8);
+    window.push(3);
+    CHECK_EQ(window.median(), 5);   // (3 + 8) / 2 naar beneden
+    window.push(-5);
+    CHECK_EQ(window.median(), 3);
+    window.push(10);
+    CHECK(window.full());
+    CHECK_EQ(window.median(), 5);   // (3 + 8) / 2
+    window.push(0);                 // 8 valt af: -5 0 3 10
+    CHECK_EQ(window.median(), 1);
+    CHECK_EQ(window.newest(0), 0);
+    CHECK_EQ(window.newest(3), 3);
+    CHECK_EQ(window.rank(0), -5);
+    CHECK_EQ(window.rank(3), 10);
+    window.reset();
+    CHECK_EQ(window.size(), 0);
+}
+
+static void testDuplicates() {
+    SlidingMedian<5> fast;
+    LegacyMedian<5> reference;
+    const TempQ values[] = { 4, 4, 4, 2, 4, 2, 2, 2, 4, 4, 6, 6, 6, 6, 6, 4 };
+    for (TempQ v : values) {
+        fast.push(v);
+        reference.push(v);
+        CHECK_EQ(fast.median(), reference.median());
+    }
+}
+
+int main() {
+    testEmptyAndFill();
+    testDuplicates();
+    checkEquivalence<1>(1, 2, 2000);
+    checkEquivalence<2>(2, 2, 2000);
+    checkEquivalence<3>(3, 2, 5000);
+    checkEquivalence<7>(7, 2, 20000);
+    checkEquivalence<8>(8, 1, 20000);
+    checkEquivalence<15>(15, 3, 20000);
+    checkEquivalence<31>(31, 2, 20000);
+    checkEquivalence<63>(63, 4, 20000);
+    checkEquivalence<64>(64, 0, 5000);   // Constant niveau: alleen duplicaten en uitschieters
+    return hostTestResult();
+}
@@ -0,0 +1,133 @@
+// TempSensorArray: 2-of-3 stemming en het melden van onenigheid en uitgevallen kanalen.
+// Elke melding komt één keer (bij de overgang), ook als er maar één of geen kanaal over is.
+#include "HostTest.h"
+#include "HostMocks.h"
+#include "TempSensorArray/TempSensorArray.h"
+
+static int g_reports = 0;
+static int g_lastChannel = -2;
+static float g_lastChannelTemp = 0.0f;
+
+static void onDisagreement(int channel, float channelTemp, float consensusTemp) {
+    (void)consensusTemp;
+    g_reports++;
+    g_lastChannel = channel;
+    g_lastChannelTemp = channelTemp;
+}
+
+// Laat de array één sample periode round-robin lezen en vraag daarna de stem uitslag op
+static TempQ runPeriod(TempSensorArray& array, TempControlSource source) {
+    for (int ms = 0; ms < TEMP_SAMPLE_INTERVAL_MS; ms++) {
+        hostAdvanceMs(1);
+        array.sample();
+    }
+    return array.getMedianQ(source, 0);
+}
+
+static void testVote() {
+    hostSetTimeUs(1000000);
+    g_reports = 0;
+    Max6675MockTransport mocks[3];
+    TempSensor s0(22, 35, 27), s1(18, 35, 27), s2(19, 35, 27);
+    TempSensor* sensors[3] = { &s0, &s1, &s2 };
+    TempSensorArray array;
+    for (int i = 0; i < 3; i++) {
+        mocks[i].setCelsius(50.0f);
+        sensors[i]->setTransport(&mocks[i]);
+        array.addChannel(sensors[i]);
+    }
+    // Kanaal 2 wijkt vanaf het begin af (een sprong zou eerst door de Hampel stage verworpen worden)
+    mocks[2].setCelsius(80.0f);
+    array.setDisagreementCallback(onDisagreement);
+    array.begin();
+
+    // Opstarten: kanalen zonder data zijn nog niet "uitgevallen"
+    array.getMedianQ(TempControlSource::VOTE, 0);
+    CHECK_EQ(g_reports, 0);
+    CHECK_EQ(array.getLostMask(), 0);
+
+    // Eén kanaal wijkt af: overstemd, één melding (niet elke aanroep)
+    for (int i = 0; i < 10; i++) runPeriod(array, TempControlSource::VOTE);
+    CHECK_EQ(array.getLostMask(), 0);
+    CHECK_NEAR(array.getMedian(TempControlSource::VOTE, 0), 50.0, 0.001);
+    CHECK_EQ(g_reports, 1);
+    CHECK_EQ(g_lastChannel, 2);
+    CHECK_EQ(array.getDisagreementCount(), 1);
+
+    // Kanaal 1 valt uit (open thermokoppel): nog twee geldig maar oneens -> uitval en geen meerderheid
+    mocks[1].setFrame(0x0004);
+    for (int i = 0; i < 10; i++) runPeriod(array, TempControlSource::VOTE);
+    CHECK_EQ(array.getLostMask(), 0x02);
+    CHECK_EQ(array.getLostCount(), 1);
+    CHECK_NEAR(array.getMedian(TempControlSource::VOTE, 0), 80.0, 0.001);  // Veilige kant: hoogste
+    int reports = g_reports;
+    CHECK_EQ(reports, 3);  // Uitval K2 + geen meerderheid
+
+    // Kanaal 2 valt ook uit: n == 1, het overgebleven kanaal regelt en de uitval wordt gemeld
+    mocks[2].setBusOk(false);
+    for (int i = 0; i < 10; i++) runPeriod(array, TempControlSource::VOTE);
+    CHECK_EQ(array.getLostMask(), 0x06);
+    CHECK_EQ(array.getLostCount(), 2);
+    CHECK_EQ(g_reports, reports + 1);
+    CHECK_EQ(g_lastChannel, 2);
+    CHECK(isnan(g_lastChannelTemp));
+    CHECK_NEAR(array.getMedian(TempControlSource::VOTE, 0), 50.0, 0.001);
+    for (int i = 0; i < 10; i++) runPeriod(array, TempControlSource::VOTE);
+    CHECK_EQ(g_reports, reports + 1);  // Geen herhaling zolang de toestand gelijk blijft
+
+    // Laatste kanaal weg: geen temperatuur meer, wel de melding
+    mocks[0].setFrame(0xFFFF);
+    for (int i = 0; i < 10; i++) runPeriod(array, TempControlSource::VOTE);
+    CHECK_EQ(array.getLostMask(), 0x07);
+    CHECK_EQ(g_reports, reports + 2);
+    CHECK_EQ(g_lastChannel, 0);
+    CHECK(!isValidQ(array.getMedianQ(TempControlSource::VOTE, 0)));
+
+    // Herstel: masker leeg, opnieuw uitvallen wordt opnieuw gemeld
+    for (int i = 0; i < 3; i++) {
+        mocks[i].setBusOk(true);
+        mocks[i].setCelsius(50.0f);
+    }
+    for (int i = 0; i < 10; i++) runPeriod(array, TempControlSource::VOTE);
+    CHECK_EQ(array.getLostMask(), 0);
+    CHECK_NEAR(array.getMedian(TempControlSource::VOTE, 0), 50.0, 0.001);
+    reports = g_reports;
+    mocks[0].setFrame(0x0004);
+    for (int i = 0; i < 10; i++) runPeriod(array, TempControlSource::VOTE);
+    CHECK_EQ(g_reports, reports + 1);
+    CHECK_EQ(g_lastChannel, 0);
+    CHECK_EQ(array.getLostCount(), 4);
+}
+
+// MAX mode stemt niet, maar een uitgevallen kanaal wordt wel gemeld
+static void testMaxLost() {
+    hostSetTimeUs(50000000);
+    g_reports = 0;
+    Max6675MockTransport mocks[2];
+    TempSensor s0(22, 35, 27), s1(18, 35, 27);
+    TempSensorArray array;
+    mocks[0].setCelsius(40.0f);
+    mocks[1].setCelsius(45.0f);
+    s0.setTransport(&mocks[0]);
+    s1.setTransport(&mocks[1]);
+    array.addChannel(&s0);
+    array.addChannel(&s1);
+    array.setDisagreementCallback(onDisagreement);
+    array.begin();
+    for (int i = 0; i < 4; i++) runPeriod(array, TempControlSource::MAX);
+    CHECK_NEAR(array.getMedian(TempControlSource::MAX, 0), 45.0, 0.001);
+    CHECK_EQ(g_reports, 0);
+
+    mocks[1].setBusOk(false);
+    for (int i = 0; i < 10; i++) runPeriod(array, TempControlSource::MAX);
+    CHECK_NEAR(array.getMedian(TempControlSource::MAX, 0), 40.0, 0.001);
+    CHECK_EQ(g_reports, 1);
+    CHECK_EQ(g_lastChannel, 1);
+    CHECK_EQ(array.getLostMask(), 0x02);
+}
+
+int main() {
+    testVote();
+    testMaxLost();
+    return hostTestResult();
+}
@@ -0,0 +1,201 @@
+// TempSensor acquisitie state machine: schema van de reads, retries, foutpaden en het tijdsbudget.
+//
+//   TempSensorTest [budget_us]   (standaard TEMP_SAMPLE_BUDGET_US)
+//
+// Budget: elke sensor.sample() + controller.update() in een gesimuleerde regeling wordt gemeten (CPU tijd
+// van de thread). Hooguit een losse uitschieter (page fault, gedeelde CPU van de build machine) mag boven
+// het budget komen - een trage read zou elke ~285 aanroepen te lang duren. Er mag nooit delay()
+// aangeroepen worden en de gesimuleerde klok mag tijdens een aanroep niet verder lopen (geen wachtlus).
+#include "HostTest.h"
+#include "HostMocks.h"
+#include "TempSensor/TempSensor.h"
+#include "CycleController/CycleController.h"
+#include "ThermalSim/ThermalSim.h"
+#include "Logger/Logger.h"
+#include <stdlib.h>
+#include <time.h>
+
+// CPU tijd van deze thread: telt alleen eigen rekenwerk, geen preemptie door andere processen
+static int64_t threadCpuNs() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void testReadSchedule() {
+    hostSetTimeUs(1000000);
+    Max6675MockTransport mock;
+    mock.setCelsius(50.0f);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&mock);
+    sensor.begin();
+    CHECK(sensor.getSnapshot().status == TempSensorStatus::NO_DATA);
+
+    // Eerste sample(): IDLE -> ACQUIRE -> VALIDATE -> PUBLISH -> IDLE in één aanroep
+    sensor.sample();
+    CHECK_EQ(mock.getReads(), 1);
+    CHECK(sensor.getSnapshot().status == TempSensorStatus::OK);
+    CHECK_NEAR(sensor.getMedian(), 50.0, 0.001);
+
+    // Binnen het sample interval: sample() keert direct terug zonder read
+    for (int i = 0; i < TEMP_SAMPLE_INTERVAL_MS - 1; i++) {
+        hostAdvanceMs(1);
+        sensor.sample();
+    }
+    CHECK_EQ(mock.getReads(), 1);
+    hostAdvanceMs(1);
+    sensor.sample();
+    CHECK_EQ(mock.getReads(), 2);
+
+    // Kritieke meting is een query op al gelezen samples: geen extra reads
+    for (int i = 0; i < 100; i++) {
+        CHECK(isValidQ(sensor.getCriticalQ()));
+    }
+    CHECK_EQ(mock.getReads(), 2);
+    CHECK_NEAR(sensor.getCritical(), 50.0, 0.001);
+
+    // Directe read binnen de conversietijd wordt geweigerd (zou de conversie afbreken)
+    hostAdvanceMs(10);
+    CHECK(isnan(sensor.read()));
+    CHECK_EQ(sensor.getHealth().notReady, 1);
+    CHECK_EQ(mock.getReads(), 2);
+}
+
+static void testRetriesAndErrors() {
+    hostSetTimeUs(5000000);
+    Max6675MockTransport mock;
+    mock.setCelsius(100.0f);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&mock);
+    sensor.begin();
+    sensor.sample();
+    CHECK_EQ(mock.getReads(), 1);
+
+    // Bus fout: snelle retry na de conversietijd, niet na het volle interval
+    mock.setBusOk(false);
+    hostAdvanceMs(TEMP_SAMPLE_INTERVAL_MS);
+    sensor.sample();
+    CHECK_EQ(mock.getReads(), 2);
+    CHECK(sensor.getSnapshot().status == TempSensorStatus::READ_ERROR);
+    CHECK_NEAR(sensor.getLastValid(), 100.0, 0.001);  // Laatste geldige waarde blijft staan
+    CHECK_EQ(sensor.getHealth().busErrors, 1);
+    CHECK_EQ(sensor.getHealth().retries, 1);
+    hostAdvanceMs(MAX6675_CONVERSION_TIME_MS - 1);
+    sensor.sample();
+    CHECK_EQ(mock.getReads(), 2);
+    hostAdvanceMs(1);
+    sensor.sample();
+    CHECK_EQ(mock.getReads(), 3);
+
+    // Na MAX6675_READ_RETRIES fouten terug naar het normale interval
+    for (int i = 1; i < MAX6675_READ_RETRIES; i++) {
+        hostAdvanceMs(MAX6675_CONVERSION_TIME_MS);
+        sensor.sample();
+    }
+    unsigned long reads = mock.getReads();
+    CHECK_EQ(sensor.getConsecutiveFailures(), MAX6675_READ_RETRIES);
+    hostAdvanceMs(MAX6675_CONVERSION_TIME_MS);
+    sensor.sample();
+    CHECK_EQ(mock.getReads(), reads);
+    hostAdvanceMs(TEMP_SAMPLE_INTERVAL_MS - MAX6675_CONVERSION_TIME_MS);
+    sensor.sample();
+    CHECK_EQ(mock.getReads(), reads + 1);
+
+    // Open thermokoppel (bit 2) en een geldig frame daarna
+    mock.setBusOk(true);
+    mock.setFrame(0x0004);
+    hostAdvanceMs(TEMP_SAMPLE_INTERVAL_MS);
+    sensor.sample();
+    CHECK_EQ(sensor.getHealth().openCircuit, 1);
+    CHECK(sensor.getSnapshot().status == TempSensorStatus::READ_ERROR);
+    mock.setCelsius(101.0f);
+    hostAdvanceMs(TEMP_SAMPLE_INTERVAL_MS);  // Retries waren al op: normaal interval
+    sensor.sample();
+    CHECK(sensor.getSnapshot().status == TempSensorStatus::OK);
+    CHECK_EQ(sensor.getConsecutiveFailures(), 0);
+}
+
+// Adaptief interval van precies de conversietijd: de read mag nooit als notReady geweigerd worden
+static void testConversionInterval() {
+    hostSetTimeUs(2000000);
+    Max6675MockTransport mock;
+    mock.setCelsius(80.0f);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&mock);
+    sensor.begin();
+    sensor.setAdaptiveTargets(80.0f, 40.0f);
+    sensor.setAdaptiveSampling(true);
+    // Eerste read: mediaan ligt op T_top, dus het snelste interval. Tussen het begin van sample() en
+    // de read valt een millis() tick; de volgende read (zonder tick) moet toch precies op tijd kunnen
+    hostSetTimerReadCostUs(1000);
+    sensor.sample();
+    hostSetTimerReadCostUs(0);
+    CHECK_EQ(mock.getReads(), 1);
+
+    for (int ms = 0; ms < 20 * MAX6675_CONVERSION_TIME_MS; ms++) {
+        hostAdvanceMs(1);
+        sensor.sample();
+    }
+    CHECK_EQ(sensor.getHealth().notReady, 0);
+    CHECK(mock.getReads() >= 19);
+    CHECK(sensor.getSnapshot().status == TempSensorStatus::OK);
+}
+
+// Regeling met snel model: elke sample() + update() in echte tijd gemeten tegen het budget
+static void testBudget(unsigned long budgetUs) {
+    hostSetTimeUs(1000000);
+    hostResetDelayCalls();
+    ThermalSimConfig plant;
+    plant.tauHeatS = 60.0f;
+    plant.tauCoolS = 30.0f;
+    plant.deadTimeS = 2.0f;
+    ThermalSim sim(plant);
+    Max6675SimTransport transport(&sim);
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&transport);
+    sensor.begin();
+    sensor.setEstimatorEnabled(true);
+    static Logger logger;
+    CycleController controller;
+    controller.begin(&sensor, &logger, 5, 23);
+    controller.setTargetTop(80.0f);
+    controller.setTargetBottom(40.0f);
+    controller.start();
+
+    const RelayActuator& relays = controller.getRelays();
+    unsigned long max_us = 0;
+    unsigned long calls = 0;
+    unsigned long over_budget = 0;
+    unsigned long clock_moved = 0;
+    unsigned long logs_before = hostLogCount();
+    for (int ms = 0; ms < 30 * 60 * 1000; ms++) {  // 30 minuten, 1 ms stappen
+        hostAdvanceMs(1);
+        sim.advanceTo((unsigned long)(hostTimeUs() / 1000), relays.isOutputHigh(RelayChannel::HEATER),
+                      relays.isOutputHigh(RelayChannel::COOLER));
+        int64_t sim_before = hostTimeUs();
+        int64_t start_ns = threadCpuNs();
+        sensor.sample();
+        controller.update();
+        int64_t end_ns = threadCpuNs();
+        if (hostTimeUs() != sim_before) clock_moved++;  // Wachten op de (gesimuleerde) klok
+        unsigned long us = (unsigned long)((end_ns - start_ns) / 1000);
+        if (us > max_us) max_us = us;
+        if (us > budgetUs) over_budget++;
+        calls++;
+    }
+    printf("budget: %lu aanroepen, langste sample()+update() %lu us (budget %lu us, %lu erboven), %lu transities\n",
+           calls, max_us, budgetUs, over_budget, hostLogCount() - logs_before);
+    CHECK(hostLogCount() - logs_before >= 4);  // Meerdere opwarm/afkoel overgangen doorlopen
+    CHECK_EQ(hostDelayCalls(), 0);
+    CHECK_EQ(clock_moved, 0);
+    CHECK(over_budget * 100000 <= calls);  // Hooguit 0,001%: losse uitschieters van de host, geen patroon
+}
+
+int main(int argc, char** argv) {
+    unsigned long budget_us = (argc > 1) ? strtoul(argv[1], nullptr, 10) : TEMP_SAMPLE_BUDGET_US;
+    testReadSchedule();
+    testRetriesAndErrors();
+    testConversionInterval();
+    testBudget(budget_us);
+    return hostTestResult();
+}
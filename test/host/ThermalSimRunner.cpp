@@ -0,0 +1,224 @@
+// Versnelde simulatie: CycleController regelt het ThermalSim model via TempSensor (Max6675SimTransport)
+// en de RelayActuator (host: geheugen bank), op de gesimuleerde klok van HostMocks.
+// Rapport: cycli/uur, overshoot, transitie latency, beveiligingen en de snelheid t.o.v. echte tijd.
+//
+//   ThermalSimRunner [--hours 24] [--mode bang|predict|pid|autotune] [--top 80] [--bottom 25]
+//                    [--max-cycles 0] [--kp ..] [--ki ..] [--kd ..] [--ramp C/min] [--hold s]
+//                    [--gain C] [--tau-heat s] [--tau-cool s] [--dead s] [--noise C] [--ambient C]
+//                    [--supervisor] [--sup-max C] [--step-ms 5] [--verbose] [--assert] [--max-overshoot C]
+//
+// --assert: exit code 1 als er geen cyclus is afgerond of een beveiliging (ook de supervisor) is afgegaan
+// --max-overshoot: exit code 1 als de gemiddelde overshoot hoger is (bijv. voorspellend uitschakelen)
+// autotune + --assert: exit code 1 als het geschatte model (K, tau, L) meer dan 10% van de plant afwijkt
+#include "HostMocks.h"
+#include "ThermalSim/ThermalSim.h"
+#include "TempSensor/TempSensor.h"
+#include "CycleController/CycleController.h"
+#include "SafetySupervisor/SafetySupervisor.h"
+#include "Logger/Logger.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_PIN_KOELEN 5
+#define SIM_PIN_VERWARMING 23
+
+static ThermalSim* g_sim = nullptr;
+
+static void onTransition(const char* status, float temp, MonoUs timestamp) {
+    (void)temp;
+    (void)timestamp;
+    g_sim->onTransition(status);
+}
+
+static PlantModel g_model;
+
+static void onAutoTune(const PlantModel& model, const PidTuning& tuning) {
+    g_model = model;
+    printf("autotune: K %.1f tau %.1f s L %.1f s Ku %.4f Pu %.1f s -> kp %.4f ki %.6f kd %.3f\n",
+           model.gainC, model.tauS, model.deadTimeS, model.ultimateGain, model.ultimatePeriodS,
+           tuning.kp, tuning.ki, tuning.kd);
+}
+
+// Relatieve afwijking van een geschatte parameter, met melding
+static bool withinTolerance(const char* name, float estimated, float actual, float tolerance) {
+    float deviation = fabsf(estimated - actual) / actual;
+    if (!(deviation <= tolerance)) {
+        printf("FOUT: autotune %s %.2f wijkt %.0f%% af van de plant (%.2f)\n", name, estimated,
+               deviation * 100.0f, actual);
+        return false;
+    }
+    return true;
+}
+
+static void usage() {
+    printf("gebruik: ThermalSimRunner [--hours h] [--mode bang|predict|pid|autotune] [--top C] [--bottom C]\n"
+           "         [--max-cycles n] [--kp v] [--ki v] [--kd v] [--ramp C/min] [--hold s]\n"
+           "         [--gain C] [--tau-heat s] [--tau-cool s] [--dead s] [--noise C] [--ambient C]\n"
+           "         [--supervisor] [--sup-max C] [--step-ms ms] [--verbose] [--assert] [--max-overshoot C]\n");
+}
+
+int main(int argc, char** argv) {
+    double hours = 24.0;
+    const char* mode = "bang";
+    float top = 80.0f;
+    float bottom = 25.0f;
+    int max_cycles = 0;
+    uint32_t step_ms = 5;
+    bool use_supervisor = false;
+    bool check_result = false;
+    float max_overshoot = -1.0f;  // < 0 = niet controleren
+    ThermalSimConfig plant;
+    PidTuning pid;
+    SafetyLimits limits;
+    limits.maxTempC = 375.0f;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool takes_value = true;
+        if (strcmp(arg, "--supervisor") == 0) { use_supervisor = true; takes_value = false; }
+        else if (strcmp(arg, "--verbose") == 0) { hostSetLogVerbose(true); takes_value = false; }
+        else if (strcmp(arg, "--assert") == 0) { check_result = true; takes_value = false; }
+        else if (strcmp(arg, "--help") == 0) { usage(); return 0; }
+        else if (value == nullptr) { usage(); return 2; }
+        else if (strcmp(arg, "--hours") == 0) hours = atof(value);
+        else if (strcmp(arg, "--mode") == 0) mode = value;
+        else if (strcmp(arg, "--top") == 0) top = atof(value);
+        else if (strcmp(arg, "--bottom") == 0) bottom = atof(value);
+        else if (strcmp(arg, "--max-cycles") == 0) max_cycles = atoi(value);
+        else if (strcmp(arg, "--kp") == 0) pid.kp = atof(value);
+        else if (strcmp(arg, "--ki") == 0) pid.ki = atof(value);
+        else if (strcmp(arg, "--kd") == 0) pid.kd = atof(value);
+        else if (strcmp(arg, "--ramp") == 0) pid.rampCPerMin = atof(value);
+        else if (strcmp(arg, "--hold") == 0) pid.holdSeconds = atoi(value);
+        else if (strcmp(arg, "--gain") == 0) plant.heaterGainC = atof(value);
+        else if (strcmp(arg, "--tau-heat") == 0) plant.tauHeatS = atof(value);
+        else if (strcmp(arg, "--tau-cool") == 0) plant.tauCoolS = atof(value);
+        else if (strcmp(arg, "--dead") == 0) plant.deadTimeS = atof(value);
+        else if (strcmp(arg, "--noise") == 0) plant.noiseC = atof(value);
+        else if (strcmp(arg, "--ambient") == 0) plant.ambientC = plant.initialC = atof(value);
+        else if (strcmp(arg, "--sup-max") == 0) { limits.maxTempC = atof(value); use_supervisor = true; }
+        else if (strcmp(arg, "--max-overshoot") == 0) max_overshoot = atof(value);
+        else if (strcmp(arg, "--step-ms") == 0) step_ms = (uint32_t)atoi(value);
+        else { usage(); return 2; }
+        if (takes_value) i++;
+    }
+    if (step_ms == 0) step_ms = 1;
+
+    hostSetTimeUs(1000000);  // 1 s na "boot", zoals na de warm-up in setup()
+
+    ThermalSim sim(plant);
+    g_sim = &sim;
+    sim.setTargets(top, bottom);
+    Max6675SimTransport transport(&sim);
+
+    TempSensor sensor(22, 35, 27);
+    sensor.setTransport(&transport);
+    sensor.begin();
+    sensor.setEstimatorEnabled(true);
+
+    static Logger logger;
+    CycleController controller;
+    controller.begin(&sensor, &logger, SIM_PIN_KOELEN, SIM_PIN_VERWARMING);
+    controller.setTargetTop(top);
+    controller.setTargetBottom(bottom);
+    controller.setMaxCycles(max_cycles);
+    controller.setTransitionCallback(onTransition);
+
+    static SafetySupervisor supervisor;
+    if (use_supervisor) {
+        supervisor.addSensor(&sensor);
+        supervisor.begin(&controller.getRelays(), limits);  // Geen task op de host: check() hieronder
+        controller.setSafetySupervisor(&supervisor);
+    }
+
+    bool autotune = strcmp(mode, "autotune") == 0;
+    if (autotune) {
+        controller.setAutoTuneCallback(onAutoTune);
+        if (!controller.startAutoTune(top)) {
+            printf("autotune niet gestart\n");
+            return 1;
+        }
+    } else {
+        if (strcmp(mode, "predict") == 0) {
+            controller.setPredictiveCutoff(true);
+        } else if (strcmp(mode, "pid") == 0) {
+            pid.enabled = true;
+            controller.setPidTuning(pid);
+        } else if (strcmp(mode, "bang") != 0) {
+            usage();
+            return 2;
+        }
+        controller.start();
+    }
+
+    const RelayActuator& relays = controller.getRelays();
+    const int64_t end_us = hostTimeUs() + (int64_t)(hours * 3600.0 * 1e6);
+    int64_t next_check_us = 0;
+    uint32_t supervisor_trips = 0;
+    unsigned long updates = 0;
+    auto wall_start = std::chrono::steady_clock::now();
+
+    while (hostTimeUs() < end_us) {
+        hostAdvanceMs(step_ms);
+        sim.advanceTo((unsigned long)(hostTimeUs() / 1000), relays.isOutputHigh(RelayChannel::HEATER),
+                      relays.isOutputHigh(RelayChannel::COOLER));
+        sensor.sample();
+        if (use_supervisor && hostTimeUs() >= next_check_us) {
+            next_check_us = hostTimeUs() + (int64_t)SAFETY_SUPERVISOR_PERIOD_MS * 1000;
+            uint32_t trips_before = supervisor.getTripCount();
+            supervisor.check();
+            if (supervisor.getTripCount() != trips_before) {
+                supervisor_trips++;
+                printf("supervisor trip: %s op %.1f s, %.2f C, reactie %lu us\n",
+                       SafetySupervisor::tripName(supervisor.getTrip()), hostTimeUs() / 1e6,
+                       supervisor.getTripTemp(), (unsigned long)supervisor.getStats().lastReactionUs);
+            }
+        }
+        controller.update();
+        updates++;
+    }
+
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    if (wall_s <= 0.0) wall_s = 1e-9;
+
+    ThermalSimReport report;
+    sim.getReport(report);
+    printf("modus %s, T_top %.1f, T_bottom %.1f, stap %lu ms\n", mode, top, bottom, (unsigned long)step_ms);
+    printf("gesimuleerd %.2f uur: %lu cycli (%.2f/uur)\n", report.simHours, (unsigned long)report.cycles,
+           report.cyclesPerHour);
+    printf("overshoot max %.2f gem %.2f C, undershoot max %.2f gem %.2f C\n", report.maxOvershootC,
+           report.avgOvershootC, report.maxUndershootC, report.avgUndershootC);
+    printf("latency top %ld ms, bodem %ld ms\n", (long)report.avgTopLatencyMs, (long)report.avgBottomLatencyMs);
+    printf("beveiligingen %lu, supervisor trips %lu, eindtoestand %d\n", (unsigned long)report.safetyTrips,
+           (unsigned long)supervisor_trips, (int)controller.getState());
+    RelayStats heater = relays.getStats(RelayChannel::HEATER);
+    RelayStats cooler = relays.getStats(RelayChannel::COOLER);
+    printf("relais: verwarming %lu x / %.1f min, koeling %lu x / %.1f min\n", (unsigned long)heater.switchCount,
+           heater.onTimeMs / 60000.0, (unsigned long)cooler.switchCount, cooler.onTimeMs / 60000.0);
+    printf("snelheid: %.3f s echte tijd, %.0fx echte tijd, %.0f cycli/s, %.0f update()/s\n", wall_s,
+           report.simHours * 3600.0 / wall_s, report.cycles / wall_s, updates / wall_s);
+
+    if (check_result && autotune) {
+        if (!g_model.valid) {
+            printf("FOUT: autotune zonder geldig model\n");
+            return 1;
+        }
+        bool ok = withinTolerance("K", g_model.gainC, plant.heaterGainC, 0.10f);
+        ok &= withinTolerance("tau", g_model.tauS, plant.tauHeatS, 0.10f);
+        ok &= withinTolerance("L", g_model.deadTimeS, plant.deadTimeS, 0.10f);
+        return ok ? 0 : 1;
+    }
+    if (check_result && (report.cycles == 0 || report.safetyTrips > 0 || supervisor_trips > 0)) {
+        printf("FOUT: geen afgeronde cyclus of een beveiliging afgegaan\n");
+        return 1;
+    }
+    if (max_overshoot >= 0.0f && !(report.avgOvershootC <= max_overshoot)) {
+        printf("FOUT: gemiddelde overshoot %.2f C boven %.2f C\n", report.avgOvershootC, max_overshoot);
+        return 1;
+    }
+    return 0;
+}
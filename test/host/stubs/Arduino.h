@@ -0,0 +1,30 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Host build: alleen wat de regel modules gebruiken. millis()/micros() volgen de gesimuleerde
+// klok uit HostMocks.cpp, digitalWrite() schrijft in een pin tabel (geen hardware).
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void* ps_malloc(size_t size);
+bool psramFound();
+
+#endif // HOST_ARDUINO_H
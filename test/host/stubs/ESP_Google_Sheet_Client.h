@@ -0,0 +1,8 @@
+#ifndef HOST_ESP_GOOGLE_SHEET_CLIENT_H
+#define HOST_ESP_GOOGLE_SHEET_CLIENT_H
+
+// Host build: alleen de types die Logger.h nodig heeft (de host Logger logt naar stdout)
+struct TokenInfo {};
+class ESP_Google_Sheet_Client {};
+
+#endif // HOST_ESP_GOOGLE_SHEET_CLIENT_H
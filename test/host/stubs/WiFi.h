@@ -0,0 +1,6 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+// Host build: Logger.h includeert WiFi.h, de host Logger heeft geen netwerk nodig
+
+#endif // HOST_WIFI_H
@@ -0,0 +1,7 @@
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+// Alleen de types: Logger.h declareert een queue, de host Logger (HostMocks.cpp) gebruikt hem niet
+#include "FreeRTOS.h"
+
+#endif // HOST_FREERTOS_QUEUE_H